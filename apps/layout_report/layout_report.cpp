@@ -0,0 +1,135 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Lists the reflected types with the most padding, from the `.layout` files the reflector plugin
+// writes when given `-fplugin-arg-reflector-layout-dir=<dir>`.
+//
+//   cpp_reflect_layout_report <dir> [--top <n>]
+
+import std;
+import reflect;
+
+struct type_layout {
+  std::string                     name{};
+  std::size_t                     size  = 0;
+  std::size_t                     align = 1;
+  std::deque<std::string>         field_names{};
+  std::vector<refl::field_layout> fields{};
+
+  std::size_t padding() const {
+    return refl::layout_analysis::padding_bytes(fields, size);
+  }
+
+  std::vector<std::size_t> suggested_order() const {
+    std::vector<std::size_t> order(fields.size());
+    refl::layout_analysis::suggest_order(fields, order);
+    return order;
+  }
+
+  std::size_t suggested_size() const {
+    const auto header = refl::layout_analysis::header_bytes(fields, size);
+    return refl::layout_analysis::reordered_size(fields, suggested_order(), header, align);
+  }
+};
+
+std::vector<std::string_view> split(std::string_view line) {
+  std::vector<std::string_view> columns{};
+  for (auto column: std::views::split(line, '\t')) {
+    columns.emplace_back(column.begin(), column.end());
+  }
+  return columns;
+}
+
+std::size_t to_size(std::string_view str) {
+  std::size_t value = 0;
+  if (std::from_chars(str.data(), str.data() + str.size(), value).ec != std::errc{}) {
+    throw std::invalid_argument(std::format("Expected a number, got '{}'", str));
+  }
+  return value;
+}
+
+/// Every translation unit reports the types it defines, keep the first record of each
+void read_layouts(const std::filesystem::path& file, std::map<std::string, type_layout>& types) {
+  std::ifstream stream{file};
+  std::string   line{};
+  type_layout*  current = nullptr;
+  while (std::getline(stream, line)) {
+    const auto columns = split(line);
+    if (columns.size() == 4 and columns[0] == "type") {
+      auto [it, inserted] = types.try_emplace(std::string{columns[1]});
+      current             = inserted ? &it->second : nullptr;
+      if (current != nullptr) {
+        current->name  = columns[1];
+        current->size  = to_size(columns[2]);
+        current->align = to_size(columns[3]);
+      }
+    } else if (columns.size() == 5 and columns[0] == "field" and current != nullptr) {
+      const auto& name = current->field_names.emplace_back(columns[1]);
+      current->fields.push_back({
+        .index  = current->fields.size(),
+        .name   = name,
+        .offset = to_size(columns[2]),
+        .size   = to_size(columns[3]),
+        .align  = std::max<std::size_t>(to_size(columns[4]), 1),
+      });
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::println(std::cerr, "usage: {} <layout dir> [--top <n>]", argv[0]);
+    return 1;
+  }
+  const std::filesystem::path dir{argv[1]};
+  std::size_t                 top = 20;
+  for (int i = 2; i + 1 < argc; ++i) {
+    if (std::string_view{argv[i]} == "--top") {
+      top = to_size(argv[++i]);
+    }
+  }
+
+  std::map<std::string, type_layout> types{};
+  if (std::filesystem::is_directory(dir)) {
+    for (const auto& entry: std::filesystem::directory_iterator{dir}) {
+      if (entry.path().extension() == ".layout") {
+        read_layouts(entry.path(), types);
+      }
+    }
+  }
+
+  std::vector<const type_layout*> ranked{};
+  for (auto& [name, type]: types) {
+    std::ranges::stable_sort(type.fields, {}, &refl::field_layout::offset);
+    if (type.padding() > 0) {
+      ranked.push_back(&type);
+    }
+  }
+  std::ranges::stable_sort(ranked, std::ranges::greater{}, [](const type_layout* type) {
+    return std::pair{type->size - type->suggested_size(), type->padding()};
+  });
+
+  std::println("{} reflected type(s), {} with padding", types.size(), ranked.size());
+  for (const auto* type: ranked | std::views::take(top)) {
+    std::println(
+      "\n{}: {} bytes, align {}, {} padding byte(s)",
+      type->name,
+      type->size,
+      type->align,
+      type->padding()
+    );
+    refl::layout_analysis::for_each_hole(type->fields, type->size, [](refl::layout_hole hole) {
+      std::println("  hole at {}, {} byte(s)", hole.offset, hole.size);
+    });
+
+    const std::size_t suggested = type->suggested_size();
+    if (suggested < type->size) {
+      std::print("  reorder to save {} byte(s):", type->size - suggested);
+      for (const auto position: type->suggested_order()) {
+        std::print(" {}", type->fields[position].name);
+      }
+      std::println();
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// A telemetry batch written and read as JSON, MessagePack and CBOR. Reading copies strings into
+// `std::string` members, or borrows them from the input into `std::string_view` ones. The
+// nlohmann cases go through a `nlohmann::json` document, built from the batch and converted back.
+
+#include "bench.h"
+
+#include <nlohmann/json.hpp>
+
+import reflect;
+import reflect.serialize;
+
+struct sample {
+  std::string         sensor{};
+  std::string         unit{};
+  long                timestamp = 0;
+  double              value     = 0.0;
+  bool                valid     = true;
+  std::vector<double> history{};
+};
+
+struct sample_view {
+  std::string_view    sensor{};
+  std::string_view    unit{};
+  long                timestamp = 0;
+  double              value     = 0.0;
+  bool                valid     = true;
+  std::vector<double> history{};
+};
+
+struct batch {
+  std::string         source{};
+  unsigned            sequence = 0;
+  std::vector<sample> samples{};
+};
+
+struct batch_view {
+  std::string_view         source{};
+  unsigned                 sequence = 0;
+  std::vector<sample_view> samples{};
+};
+
+static const batch& telemetry() {
+  static const batch value = [] {
+    batch result{.source = "plant-7/line-2", .sequence = 1024};
+    for (int i = 0; i < 64; ++i) {
+      result.samples.push_back({
+        .sensor    = std::format("sensor-{:03}", i),
+        .unit      = i % 2 == 0 ? "celsius" : "bar",
+        .timestamp = 1'700'000'000'000L + i * 250,
+        .value     = i * 0.75,
+        .valid     = i % 9 != 0,
+        .history   = {i * 0.5, i * 0.25, i * 0.125},
+      });
+    }
+    return result;
+  }();
+  return value;
+}
+
+static nlohmann::json to_document(const batch& value) {
+  nlohmann::json samples = nlohmann::json::array();
+  for (const sample& item: value.samples) {
+    samples.push_back({
+      {"sensor", item.sensor},
+      {"unit", item.unit},
+      {"timestamp", item.timestamp},
+      {"value", item.value},
+      {"valid", item.valid},
+      {"history", item.history},
+    });
+  }
+  return {{"source", value.source}, {"sequence", value.sequence}, {"samples", std::move(samples)}};
+}
+
+static batch from_document(const nlohmann::json& document) {
+  batch value{
+    .source   = document.at("source").get<std::string>(),
+    .sequence = document.at("sequence").get<unsigned>(),
+  };
+  for (const nlohmann::json& item: document.at("samples")) {
+    value.samples.push_back({
+      .sensor    = item.at("sensor").get<std::string>(),
+      .unit      = item.at("unit").get<std::string>(),
+      .timestamp = item.at("timestamp").get<long>(),
+      .value     = item.at("value").get<double>(),
+      .valid     = item.at("valid").get<bool>(),
+      .history   = item.at("history").get<std::vector<double>>(),
+    });
+  }
+  return value;
+}
+
+BENCH_N("binary formats: write msgpack, nlohmann document", 1000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(nlohmann::json::to_msgpack(to_document(telemetry())));
+  }
+}
+
+BENCH_N("binary formats: read msgpack, nlohmann document", 1000) {
+  static const std::string bytes = refl::to_string<formats::msgpack_fmt>(telemetry());
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(from_document(nlohmann::json::from_msgpack(bytes)));
+  }
+}
+
+BENCH_N("binary formats: write json", 1000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(telemetry()));
+  }
+}
+
+BENCH_N("binary formats: write msgpack", 1000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::serializer<formats::msgpack_fmt>::to_string_view(telemetry()));
+  }
+}
+
+BENCH_N("binary formats: write cbor", 1000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::serializer<formats::cbor_fmt>::to_string_view(telemetry()));
+  }
+}
+
+BENCH_N("binary formats: read json", 1000) {
+  static const std::string json = refl::to_string<formats::json_fmt>(telemetry());
+  for (std::size_t i = 0; i < iterations; ++i) {
+    batch out{};
+    refl::read_json(json, out);
+    bench::do_not_optimize(out);
+  }
+}
+
+BENCH_N("binary formats: read msgpack", 1000) {
+  static const std::string bytes = refl::to_string<formats::msgpack_fmt>(telemetry());
+  for (std::size_t i = 0; i < iterations; ++i) {
+    batch out{};
+    refl::read_msgpack(bytes, out);
+    bench::do_not_optimize(out);
+  }
+}
+
+BENCH_N("binary formats: read msgpack, borrowed strings", 1000) {
+  static const std::string bytes = refl::to_string<formats::msgpack_fmt>(telemetry());
+  for (std::size_t i = 0; i < iterations; ++i) {
+    batch_view out{};
+    refl::read_msgpack(bytes, out);
+    bench::do_not_optimize(out);
+  }
+}
+
+BENCH_N("binary formats: read cbor", 1000) {
+  static const std::string bytes = refl::to_string<formats::cbor_fmt>(telemetry());
+  for (std::size_t i = 0; i < iterations; ++i) {
+    batch out{};
+    refl::read_cbor(bytes, out);
+    bench::do_not_optimize(out);
+  }
+}
+
+BENCH_N("binary formats: read cbor, borrowed strings", 1000) {
+  static const std::string bytes = refl::to_string<formats::cbor_fmt>(telemetry());
+  for (std::size_t i = 0; i < iterations; ++i) {
+    batch_view out{};
+    refl::read_cbor(bytes, out);
+    bench::do_not_optimize(out);
+  }
+}
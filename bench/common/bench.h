@@ -0,0 +1,248 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPP_REFLECT_BENCH_H
+#define CPP_REFLECT_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench {
+  template <typename T>
+  inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+  }
+
+  class case_t;
+
+  inline std::vector<case_t*>& cases() {
+    static std::vector<case_t*> list{};
+    return list;
+  }
+
+  class case_t {
+  public:
+    std::string                      name;
+    std::source_location             location;
+    std::size_t                      batch;
+    std::size_t                      samples;
+    std::function<void(std::size_t)> body;
+
+    case_t(
+      const std::string&               name_,
+      const std::source_location       location_,
+      std::size_t                      batch_,
+      std::size_t                      samples_,
+      std::function<void(std::size_t)> body_
+    )
+        : name(name_),
+          location(location_),
+          batch(batch_),
+          samples(samples_),
+          body(std::move(body_)) {
+      cases().push_back(this);
+    }
+  };
+
+  struct result_t {
+    double median_ns;
+    double p99_ns;
+  };
+
+  /// Minimum time spent warming a case up before it is measured
+  inline constexpr std::chrono::milliseconds warm_up_time{20};
+
+  /// Runs `c` until it has been warm for `warm_up_time` (at least once), then `c.samples` times
+  /// with `c.batch` iterations each, and reports the per-iteration time distribution across
+  /// samples.
+  inline result_t run(const case_t& c) {
+    const std::size_t samples = c.samples;
+    using clock = std::chrono::steady_clock;
+
+    const auto warm_up_start = clock::now();
+    do {
+      c.body(c.batch);
+    } while (clock::now() - warm_up_start < warm_up_time);
+
+    std::vector<double> ns_per_op{};
+    ns_per_op.reserve(samples);
+    for (std::size_t s = 0; s < samples; ++s) {
+      const auto start = clock::now();
+      c.body(c.batch);
+      const auto end = clock::now();
+      ns_per_op.push_back(
+        std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(c.batch)
+      );
+    }
+
+    std::ranges::sort(ns_per_op);
+    const auto at = [&](double q) {
+      return ns_per_op[std::min(ns_per_op.size() - 1, static_cast<std::size_t>(q * ns_per_op.size()))];
+    };
+    return {.median_ns = at(0.5), .p99_ns = at(0.99)};
+  }
+
+  struct report_entry {
+    std::string name;
+    std::size_t batch;
+    std::size_t samples;
+    result_t    result;
+  };
+
+  inline std::string json_string(std::string_view str) {
+    std::string out{"\""};
+    for (const char c: str) {
+      if (c == '"' or c == '\\') {
+        out += '\\';
+      }
+      out += c;
+    }
+    return out + "\"";
+  }
+
+  /// `{"benchmarks": [{"name": ..., "median_ns": ..., "p99_ns": ..., ...}, ...]}`
+  inline void write_json(std::ostream& out, const std::vector<report_entry>& entries) {
+    out << "{\"benchmarks\": [";
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      const auto& entry = entries[i];
+      out << (i == 0 ? "\n" : ",\n")
+          << std::format(
+               R"(  {{"name": {}, "batch": {}, "samples": {}, "median_ns": {}, "p99_ns": {}}})",
+               json_string(entry.name),
+               entry.batch,
+               entry.samples,
+               entry.result.median_ns,
+               entry.result.p99_ns
+             );
+    }
+    out << "\n]}\n";
+  }
+
+  /// Reads back the medians of a report written by `write_json`
+  inline std::map<std::string, double> read_medians(std::istream& in) {
+    const std::string text{std::istreambuf_iterator<char>{in}, {}};
+    std::map<std::string, double> medians{};
+
+    constexpr std::string_view name_key   = R"("name": ")";
+    constexpr std::string_view median_key = R"("median_ns": )";
+    for (std::size_t pos = text.find(name_key); pos != std::string::npos;
+         pos             = text.find(name_key, pos)) {
+      std::string name{};
+      for (pos += name_key.size(); pos < text.size() and text[pos] != '"'; ++pos) {
+        if (text[pos] == '\\') {
+          ++pos;
+        }
+        name += text[pos];
+      }
+      const std::size_t median = text.find(median_key, pos);
+      if (median == std::string::npos) {
+        break;
+      }
+      medians[name] = std::stod(text.substr(median + median_key.size(), 32));
+      pos           = median;
+    }
+    return medians;
+  }
+} // namespace bench
+
+#define BENCH_ID bench_case_
+#define BENCH_BLOCK_ID bench_case_block_
+#define BENCH_ID_NUM __LINE__
+#define BENCH_CONCAT_IMPL(A, B) A##B
+#define BENCH_CONCAT(A, B) BENCH_CONCAT_IMPL(A, B)
+
+#define __BENCH_DECL(NAME, BATCH, SAMPLES, ID)                                                     \
+  void BENCH_CONCAT(BENCH_BLOCK_ID, ID)(std::size_t iterations);                                   \
+  bench::case_t BENCH_CONCAT(BENCH_ID, ID){                                                         \
+    NAME,                                                                                          \
+    std::source_location::current(),                                                               \
+    BATCH,                                                                                         \
+    SAMPLES,                                                                                       \
+    [](std::size_t n) { BENCH_CONCAT(BENCH_BLOCK_ID, ID)(n); }                                     \
+  };                                                                                               \
+  void BENCH_CONCAT(BENCH_BLOCK_ID, ID)(std::size_t iterations)
+
+//! Declares a benchmark case, the body must run its workload `iterations` times
+#define BENCH_N(NAME, BATCH) __BENCH_DECL(NAME, BATCH, 101, BENCH_ID_NUM)
+#define BENCH(NAME) BENCH_N(NAME, 1000)
+//! Times every single call, for latency percentiles rather than throughput
+#define BENCH_LATENCY(NAME, SAMPLES) __BENCH_DECL(NAME, 1, SAMPLES, BENCH_ID_NUM)
+
+/// usage: BENCH_<name> [filter] [--json <report.json>] [--compare <baseline.json>]
+///
+/// `--json` writes the results in machine readable form, `--compare` reads such a report from a
+/// previous run and prints how each median moved.
+int main(int argc, char* argv[]) {
+  std::string filter{};
+  std::string json_path{};
+  std::string compare_path{};
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--json" and i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (arg == "--compare" and i + 1 < argc) {
+      compare_path = argv[++i];
+    } else {
+      filter = arg;
+    }
+  }
+
+  std::map<std::string, double> baseline{};
+  if (not compare_path.empty()) {
+    // A new benchmark has no baseline yet, that is not an error
+    std::ifstream in{compare_path};
+    if (in) {
+      baseline = bench::read_medians(in);
+    } else {
+      std::cerr << std::format("No baseline at '{}'", compare_path) << std::endl;
+    }
+  }
+
+  std::cout << std::format("{:<56} {:>14} {:>14}", "benchmark", "median ns/op", "p99 ns/op");
+  if (not baseline.empty()) {
+    std::cout << std::format(" {:>14} {:>9}", "baseline ns/op", "change");
+  }
+  std::cout << std::endl;
+
+  std::vector<bench::report_entry> entries{};
+  for (const auto* c: bench::cases()) {
+    if (not filter.empty() and not c->name.contains(filter)) {
+      continue;
+    }
+    const auto result = bench::run(*c);
+    entries.push_back({c->name, c->batch, c->samples, result});
+
+    std::cout << std::format(
+      "{:<56} {:>14.2f} {:>14.2f}", c->name, result.median_ns, result.p99_ns
+    );
+    if (const auto it = baseline.find(c->name); it != baseline.end() and it->second > 0) {
+      const double change = (result.median_ns - it->second) / it->second * 100.0;
+      std::cout << std::format(" {:>14.2f} {:>+8.1f}%", it->second, change);
+    }
+    std::cout << std::endl;
+  }
+
+  if (not json_path.empty()) {
+    std::ofstream out{json_path};
+    bench::write_json(out, entries);
+  }
+  return 0;
+}
+
+#endif //CPP_REFLECT_BENCH_H
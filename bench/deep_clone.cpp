@@ -0,0 +1,180 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Copies of an object graph of nested vectors, maps, strings and smart pointers, made with the
+// copy constructors of standard and `std::pmr` containers, and with `refl::deep_clone` into a
+// monotonic arena. A case times making a copy and tearing it down, the first run of each case
+// also prints the two halves separately.
+
+#include "bench.h"
+
+#include <chrono>
+#include <deque>
+#include <memory_resource>
+
+import reflect;
+
+struct std_containers {
+  using string = std::string;
+  template <typename T>
+  using vector = std::vector<T>;
+  template <typename K, typename V>
+  using map = std::map<K, V>;
+};
+
+struct pmr_containers {
+  using string = std::pmr::string;
+  template <typename T>
+  using vector = std::pmr::vector<T>;
+  template <typename K, typename V>
+  using map = std::pmr::map<K, V>;
+};
+
+template <typename C>
+struct mesh {
+  typename C::string                       name{};
+  typename C::template vector<float>       vertices{};
+  typename C::template vector<std::size_t> indices{};
+};
+
+template <typename C>
+struct entity {
+  typename C::string                                               name{};
+  typename C::template map<typename C::string, typename C::string> tags{};
+  std::shared_ptr<mesh<C>>                                         model{};
+  std::unique_ptr<entity>                                          proxy{};
+  typename C::template vector<typename C::string>                  children{};
+};
+
+template <typename C>
+struct scene {
+  using mesh_type   = mesh<C>;
+  using entity_type = entity<C>;
+
+  typename C::string                                                     title{};
+  typename C::template vector<entity<C>>                                 entities{};
+  typename C::template map<typename C::string, std::shared_ptr<mesh<C>>> meshes{};
+};
+
+using std_scene = scene<std_containers>;
+using pmr_scene = scene<pmr_containers>;
+
+template <typename Scene>
+static Scene make_scene() {
+  using string = decltype(Scene::title);
+  // Long enough to not fit in the small string buffer
+  const auto label = [](std::string_view kind, std::size_t i) {
+    return string{std::format("{}-with-a-long-enough-name-{}", kind, i)};
+  };
+
+  Scene scene{};
+  scene.title = label("scene", 0);
+  for (std::size_t m = 0; m < 16; ++m) {
+    auto model  = std::make_shared<typename Scene::mesh_type>();
+    model->name = label("mesh", m);
+    model->vertices.assign(256, 1.0F);
+    model->indices.assign(384, m);
+    scene.meshes.emplace(label("mesh", m), std::move(model));
+  }
+  for (std::size_t e = 0; e < 2000; ++e) {
+    auto& entity = scene.entities.emplace_back();
+    entity.name  = label("entity", e);
+    entity.tags.emplace(label("layer", e % 8), label("value", e));
+    entity.tags.emplace(label("owner", e % 3), label("value", e));
+    entity.model = scene.meshes.begin()->second;
+    if (e % 4 == 0) {
+      entity.proxy       = std::make_unique<typename Scene::entity_type>();
+      entity.proxy->name = label("proxy", e);
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+      entity.children.push_back(label("child", e * 4 + c));
+    }
+  }
+  return scene;
+}
+
+/// Registers a case timing `make()` followed by the destruction of what it returned
+template <typename Make>
+static void add_case(std::string name, Make make) {
+  static std::deque<bench::case_t> cases{};
+  cases.emplace_back(
+    name,
+    std::source_location::current(),
+    1,
+    51,
+    [name, make, reported = false](std::size_t iterations) mutable {
+      if (not reported) {
+        reported         = true;
+        using clock      = std::chrono::steady_clock;
+        const auto start = clock::now();
+        auto       copy  = std::make_optional(make());
+        const auto made  = clock::now();
+        copy.reset();
+        const auto done = clock::now();
+        std::cout << std::format(
+          "{}: clone {}, destroy {}\n",
+          name,
+          std::chrono::duration_cast<std::chrono::microseconds>(made - start),
+          std::chrono::duration_cast<std::chrono::microseconds>(done - made)
+        );
+      }
+      for (std::size_t i = 0; i < iterations; ++i) {
+        bench::do_not_optimize(make());
+      }
+    }
+  );
+}
+
+/// Copy constructors only know about the containers, `unique_ptr` members have to be copied by
+/// hand
+template <typename Scene>
+static Scene copy_scene(const Scene& scene) {
+  Scene copy{};
+  copy.title  = scene.title;
+  copy.meshes = scene.meshes;
+  for (const auto& entity: scene.entities) {
+    auto& out    = copy.entities.emplace_back();
+    out.name     = entity.name;
+    out.tags     = entity.tags;
+    out.model    = entity.model;
+    out.children = entity.children;
+    if (entity.proxy != nullptr) {
+      out.proxy       = std::make_unique<typename Scene::entity_type>();
+      out.proxy->name = entity.proxy->name;
+    }
+  }
+  return copy;
+}
+
+/// A clone and the arena it lives in, torn down together
+template <typename Scene>
+struct arena_clone {
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+  Scene                                                value;
+};
+
+template <typename Scene>
+static arena_clone<Scene> clone_in_arena(const Scene& source) {
+  auto  arena = std::make_unique<std::pmr::monotonic_buffer_resource>(std::size_t{1} << 20);
+  Scene clone = refl::deep_clone(source, *arena);
+  return {std::move(arena), std::move(clone)};
+}
+
+static const bool registered = [] {
+  static const std_scene std_source = make_scene<std_scene>();
+  static const pmr_scene pmr_source = make_scene<pmr_scene>();
+
+  add_case("deep_clone: copy, std containers", [] {
+    return copy_scene(std_source);
+  });
+  add_case("deep_clone: copy, pmr containers on the default resource", [] {
+    return copy_scene(pmr_source);
+  });
+  add_case("deep_clone: std containers", [] {
+    return clone_in_arena(std_source);
+  });
+  add_case("deep_clone: pmr containers into a monotonic arena", [] {
+    return clone_in_arena(pmr_source);
+  });
+  return true;
+}();
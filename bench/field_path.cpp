@@ -0,0 +1,116 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct conn_limits {
+  int max_connections = 100;
+  int timeout_ms      = 5000;
+};
+
+struct listener {
+  std::string host   = "0.0.0.0";
+  int         port   = 8080;
+  conn_limits limits = {};
+};
+
+struct app_config {
+  std::string name     = "service";
+  listener    http     = {};
+  listener*   admin    = nullptr;
+  double      sampling = 0.1;
+};
+
+static app_config& config() {
+  static listener   admin{"127.0.0.1", 9090, {}};
+  static app_config cfg{.admin = &admin};
+  return cfg;
+}
+
+static refl::field_path field_path_of(std::initializer_list<std::string_view> names) {
+  const refl::type_info*               type = &refl::type_info::from<app_config>();
+  std::vector<const refl::field_info*> fields{};
+  for (const auto name: names) {
+    fields.push_back(type->field_by_name(std::string{name}).value());
+    type = &fields.back()->type();
+  }
+  if (fields.size() == 3) {
+    return {fields[0], fields[1], fields[2]};
+  }
+  return {fields[0], fields[1]};
+}
+
+// Resolving an already built path
+
+BENCH_N("field_path: get_ptr, 3 plain members (field_path)", 1000000) {
+  const auto path = field_path_of({"http", "limits", "timeout_ms"});
+  auto&      cfg  = config();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(path.get_ptr(&cfg));
+  }
+}
+
+BENCH_N("field_path: get_ptr, 3 plain members (compiled_path)", 1000000) {
+  const auto& path = refl::compile_path<app_config>("http.limits.timeout_ms");
+  auto&       cfg  = config();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(path.get_ptr(&cfg));
+  }
+}
+
+BENCH_N("field_path: get_ptr, through a pointer (compiled_path)", 1000000) {
+  const auto& path = refl::compile_path<app_config>("admin.limits.timeout_ms");
+  auto&       cfg  = config();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(path.get_ptr(&cfg));
+  }
+}
+
+// Resolving from the path string every time, what a config binder does
+
+BENCH_N("field_path: \"http.limits.timeout_ms\" (field_by_name per segment)", 100000) {
+  auto& cfg = config();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto path = field_path_of({"http", "limits", "timeout_ms"});
+    bench::do_not_optimize(path.get_ptr(&cfg));
+  }
+}
+
+BENCH_N("field_path: \"http.limits.timeout_ms\" (compile_path, cached)", 100000) {
+  auto& cfg = config();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto& path = refl::compile_path<app_config>("http.limits.timeout_ms");
+    bench::do_not_optimize(path.get_ptr(&cfg));
+  }
+}
+
+BENCH_N("field_path: \"http.limits.timeout_ms\" (compile_path, static)", 100000) {
+  auto& cfg = config();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto& path = refl::compile_path<app_config, "http.limits.timeout_ms">();
+    bench::do_not_optimize(path.get_ptr(&cfg));
+  }
+}
+
+// Paths as hash map keys
+
+BENCH_N("field_path: hash + compare (field_path)", 1000000) {
+  const auto a = field_path_of({"http", "limits", "timeout_ms"});
+  const auto b = field_path_of({"http", "limits", "timeout_ms"});
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(std::hash<refl::field_path>{}(a));
+    bench::do_not_optimize(a == b);
+  }
+}
+
+BENCH_N("field_path: hash + compare (compiled_path)", 1000000) {
+  const auto& a = refl::compile_path<app_config>("http.limits.timeout_ms");
+  const auto  b =
+    refl::compiled_path::parse(refl::type_info::from<app_config>(), "http.limits.timeout_ms");
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(std::hash<refl::compiled_path>{}(a));
+    bench::do_not_optimize(a == b);
+  }
+}
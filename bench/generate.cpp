@@ -0,0 +1,62 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct order_line {
+  std::uint64_t sku = 0;
+  [[meta(refl::gen::range{1, 100})]]
+  int quantity = 0;
+  [[meta(refl::gen::range{0.01, 1000.0})]]
+  double price = 0.0;
+};
+
+struct order {
+  std::uint64_t id = 0;
+  [[meta(refl::gen::length{8, 32})]]
+  std::string customer{};
+  [[meta(refl::gen::count{1, 16})]]
+  std::vector<order_line> lines{};
+  std::map<std::string, std::string> attributes{};
+};
+
+static constexpr std::size_t order_count = 100'000;
+
+BENCH_N("generate: order", 10000) {
+  refl::gen::splitmix64 rng{1};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::generate<order>(rng));
+  }
+}
+
+BENCH_LATENCY("generate: 100k orders, 1 thread", 10) {
+  bench::do_not_optimize(refl::generate_n<order>(order_count, 1, {.threads = 1}));
+}
+
+BENCH_LATENCY("generate: 100k orders, all threads", 10) {
+  bench::do_not_optimize(refl::generate_n<order>(order_count, 1));
+}
+
+static const std::vector<order>& orders() {
+  static const auto values = refl::generate_n<order>(order_count, 1);
+  return values;
+}
+
+BENCH_N("generate: json serialize generated order", 10000) {
+  const auto& values = orders();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto& value = values[i % values.size()];
+    bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(value));
+  }
+}
+
+BENCH_N("generate: deep_eq generated orders", 10000) {
+  const auto& values = orders();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto& value = values[i % values.size()];
+    bench::do_not_optimize(refl::deep_eq(value, value));
+  }
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct account {
+  [[meta(refl::index::hash)]]
+  std::uint64_t id = 0;
+
+  [[meta(refl::index::hash)]]
+  std::string name = {};
+
+  [[meta(refl::index::ordered)]]
+  std::int64_t updated = 0;
+
+  double balance = 0.0;
+};
+
+static constexpr std::size_t row_count = 1'000'000;
+
+static account make_account(std::size_t i) {
+  return {
+    .id      = i * 2654435761U,
+    .name    = std::format("account-{}", i),
+    .updated = static_cast<std::int64_t>((i * 7919) % row_count),
+    .balance = static_cast<double>(i),
+  };
+}
+
+/// The same rows kept in hand-synchronized maps, what `indexed_table` replaces
+struct manual_table {
+  std::vector<account>                           rows{};
+  std::unordered_map<std::uint64_t, std::size_t> by_id{};
+  std::unordered_map<std::string, std::size_t>   by_name{};
+  std::multimap<std::int64_t, std::size_t>       by_updated{};
+
+  void insert(account value) {
+    const std::size_t row = rows.size();
+    by_id.emplace(value.id, row);
+    by_name.emplace(value.name, row);
+    by_updated.emplace(value.updated, row);
+    rows.push_back(std::move(value));
+  }
+};
+
+static refl::indexed_table<account>& table() {
+  static refl::indexed_table<account> t = [] {
+    refl::indexed_table<account> out{};
+    out.reserve(row_count);
+    for (std::size_t i = 0; i < row_count; ++i) {
+      out.insert(make_account(i));
+    }
+    return out;
+  }();
+  return t;
+}
+
+static manual_table& manual() {
+  static manual_table t = [] {
+    manual_table out{};
+    out.rows.reserve(row_count);
+    for (std::size_t i = 0; i < row_count; ++i) {
+      out.insert(make_account(i));
+    }
+    return out;
+  }();
+  return t;
+}
+
+BENCH_LATENCY("indexed_table: insert 1M rows (manual maps)", 5) {
+  manual_table t{};
+  t.rows.reserve(row_count);
+  for (std::size_t i = 0; i < row_count; ++i) {
+    t.insert(make_account(i));
+  }
+  bench::do_not_optimize(t.rows.size());
+}
+
+BENCH_LATENCY("indexed_table: insert 1M rows (indexed_table)", 5) {
+  refl::indexed_table<account> t{};
+  t.reserve(row_count);
+  for (std::size_t i = 0; i < row_count; ++i) {
+    t.insert(make_account(i));
+  }
+  bench::do_not_optimize(t.size());
+}
+
+BENCH_N("indexed_table: lookup by id, 1M rows (manual maps)", 100000) {
+  const auto& t = manual();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto it = t.by_id.find(((i * 7) % row_count) * 2654435761U);
+    bench::do_not_optimize(t.rows[it->second].balance);
+  }
+}
+
+BENCH_N("indexed_table: lookup by id, 1M rows (indexed_table)", 100000) {
+  const auto& t = table();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto row = t.find<"id">(((i * 7) % row_count) * 2654435761U);
+    bench::do_not_optimize(t[*row].balance);
+  }
+}
+
+BENCH_N("indexed_table: lookup by timestamp, 1M rows (manual maps)", 100000) {
+  const auto& t = manual();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto it = t.by_updated.find(static_cast<std::int64_t>((i * 31) % row_count));
+    bench::do_not_optimize(t.rows[it->second].balance);
+  }
+}
+
+BENCH_N("indexed_table: lookup by timestamp, 1M rows (indexed_table)", 100000) {
+  const auto& t = table();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto row = t.find<"updated">(static_cast<std::int64_t>((i * 31) % row_count));
+    bench::do_not_optimize(t[*row].balance);
+  }
+}
+
+BENCH_N("indexed_table: update timestamp, 1M rows (manual maps)", 10000) {
+  auto& t = manual();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const std::size_t row   = (i * 104729) % row_count;
+    auto&             value = t.rows[row];
+    auto [first, last]      = t.by_updated.equal_range(value.updated);
+    for (auto it = first; it != last; ++it) {
+      if (it->second == row) {
+        t.by_updated.erase(it);
+        break;
+      }
+    }
+    value.updated = (value.updated + 1) % static_cast<std::int64_t>(row_count);
+    t.by_updated.emplace(value.updated, row);
+  }
+}
+
+BENCH_N("indexed_table: update timestamp, 1M rows (indexed_table)", 10000) {
+  auto& t = table();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const std::size_t row = (i * 104729) % row_count;
+    t.set<"updated">(row, (t[row].updated + 1) % static_cast<std::int64_t>(row_count));
+  }
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Build once as is and once with -DCPP_REFLECT_INSTRUMENTATION=ON to see what the probes cost.
+// Disabled, every case has to match its hand written baseline.
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct reading {
+  int              id    = 42;
+  std::string      name  = "sensor-7";
+  double           value = 3.25;
+  std::vector<int> tags  = {1, 2, 3};
+};
+
+static std::string with_state(std::string name) {
+  return name + (refl::instrumentation::enabled ? " [instrumented]" : " [disabled]");
+}
+
+BENCH_N(with_state("instrumentation: empty probe"), 100000) {
+  using refl::instrumentation::operation;
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::instrumentation::probe<operation::visit, reading>([] { bench::clobber_memory(); });
+  }
+}
+
+BENCH_N("instrumentation: empty loop (baseline)", 100000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::clobber_memory();
+  }
+}
+
+BENCH_N(with_state("instrumentation: deep_eq"), 10000) {
+  const reading lhs{};
+  const reading rhs{};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::deep_eq(lhs, rhs));
+  }
+}
+
+BENCH_N("instrumentation: operator== (baseline)", 10000) {
+  const reading lhs{};
+  const reading rhs{};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(
+      lhs.id == rhs.id and lhs.name == rhs.name and lhs.value == rhs.value and lhs.tags == rhs.tags
+    );
+  }
+}
+
+BENCH_N(with_state("instrumentation: serialize json"), 10000) {
+  const reading msg{};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(msg));
+  }
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Plain versus interned JSON streams of 1000 log lines, once with strings drawn from small pools
+// (hosts, levels, services) and once with every string unique. Stream sizes are printed when the
+// inputs are first built.
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct log_line {
+  std::uint64_t id = 0;
+  std::string   host{};
+  std::string   level{};
+  std::string   service{};
+  std::string   region{};
+  std::string   message{};
+};
+
+struct log_line_view {
+  std::uint64_t    id = 0;
+  std::string_view host{};
+  std::string_view level{};
+  std::string_view service{};
+  std::string_view region{};
+  std::string_view message{};
+};
+
+static std::vector<log_line> make_lines(bool repetitive) {
+  static constexpr std::array<std::string_view, 4> levels{"debug", "info", "warning", "error"};
+  static constexpr std::array<std::string_view, 3> regions{"eu-west-1", "us-east-2", "ap-south-1"};
+
+  std::vector<log_line> lines(1000);
+  for (std::size_t i = 0; i < lines.size(); ++i) {
+    auto& line = lines[i];
+    line.id    = i;
+    if (repetitive) {
+      line.host    = std::format("host-{:02}.cluster.example.net", i % 8);
+      line.level   = levels[i % levels.size()];
+      line.service = std::format("service-{}", i % 6);
+      line.region  = regions[i % regions.size()];
+      line.message = std::format("request handled by worker {}", i % 16);
+    } else {
+      line.host    = std::format("host-{:04}.cluster.example.net", i);
+      line.level   = std::format("level-{}", i);
+      line.service = std::format("service-{}", i);
+      line.region  = std::format("region-{}", i);
+      line.message = std::format("request {} handled by worker {}", i, i * 7919);
+    }
+  }
+  return lines;
+}
+
+/// One record per line, interned into `dictionary` if given
+static std::string encode(const std::vector<log_line>& lines, refl::string_dictionary* dictionary) {
+  refl::string_sink                    sink{};
+  formats::json_fmt<refl::string_sink> format{sink, {.dictionary = dictionary}};
+  for (const auto& line: lines) {
+    format.serialize(line);
+    sink.put('\n');
+  }
+  return std::string{sink.view()};
+}
+
+template <typename Record, typename Read>
+static void decode(std::string_view stream, Read&& read) {
+  for (const auto line: std::views::split(stream, '\n')) {
+    if (not line.empty()) {
+      Record record{};
+      read(std::string_view{line.begin(), line.end()}, record);
+      bench::do_not_optimize(record);
+    }
+  }
+}
+
+struct dataset {
+  std::vector<log_line> lines;
+  std::string           plain;
+  std::string           interned;
+};
+
+static const dataset& data(bool repetitive) {
+  static const auto build = [](bool repetitive_) {
+    dataset                 set{.lines = make_lines(repetitive_)};
+    refl::string_dictionary dictionary{};
+    set.plain    = encode(set.lines, nullptr);
+    set.interned = encode(set.lines, &dictionary);
+    std::cout << std::format(
+      "{} data: plain {} bytes, interned {} bytes ({:.1f}%), {} strings interned\n",
+      repetitive_ ? "repetitive" : "unique",
+      set.plain.size(),
+      set.interned.size(),
+      100.0 * static_cast<double>(set.interned.size()) / static_cast<double>(set.plain.size()),
+      dictionary.size()
+    );
+    return set;
+  };
+  static const dataset repetitive_set = build(true);
+  static const dataset unique_set     = build(false);
+  return repetitive ? repetitive_set : unique_set;
+}
+
+BENCH_N("interning: encode plain (repetitive)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(encode(data(true).lines, nullptr));
+  }
+}
+
+BENCH_N("interning: encode interned (repetitive)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::string_dictionary dictionary{};
+    bench::do_not_optimize(encode(data(true).lines, &dictionary));
+  }
+}
+
+BENCH_N("interning: encode plain (unique)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(encode(data(false).lines, nullptr));
+  }
+}
+
+BENCH_N("interning: encode interned (unique)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::string_dictionary dictionary{};
+    bench::do_not_optimize(encode(data(false).lines, &dictionary));
+  }
+}
+
+BENCH_N("interning: decode plain (repetitive)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    decode<log_line>(data(true).plain, [](std::string_view json, log_line& record) {
+      refl::read_json(json, record);
+    });
+  }
+}
+
+BENCH_N("interning: decode interned (repetitive)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::string_dictionary dictionary{};
+    decode<log_line>(data(true).interned, [&](std::string_view json, log_line& record) {
+      refl::read_json(json, record, dictionary);
+    });
+  }
+}
+
+// Strings are views into the dictionary's buffer, nothing is allocated per record
+BENCH_N("interning: decode interned into views (repetitive)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::string_dictionary dictionary{};
+    decode<log_line_view>(data(true).interned, [&](std::string_view json, log_line_view& record) {
+      refl::read_json(json, record, dictionary);
+    });
+  }
+}
+
+BENCH_N("interning: decode plain (unique)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    decode<log_line>(data(false).plain, [](std::string_view json, log_line& record) {
+      refl::read_json(json, record);
+    });
+  }
+}
+
+BENCH_N("interning: decode interned (unique)", 10) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::string_dictionary dictionary{};
+    decode<log_line>(data(false).interned, [&](std::string_view json, log_line& record) {
+      refl::read_json(json, record, dictionary);
+    });
+  }
+}
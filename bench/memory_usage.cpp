@@ -0,0 +1,46 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct session {
+  std::uint64_t            id = 0;
+  std::string              user{};
+  std::vector<std::string> roles{};
+  std::vector<double>      samples{};
+};
+
+struct session_cache {
+  std::unordered_map<std::uint64_t, session>      sessions{};
+  std::map<std::string, std::shared_ptr<session>> by_user{};
+};
+
+static constexpr std::size_t session_count = 100'000;
+
+static session_cache& cache() {
+  static session_cache c = [] {
+    session_cache out{};
+    for (std::size_t i = 0; i < session_count; ++i) {
+      auto s = std::make_shared<session>(session{
+        .id      = i,
+        .user    = std::format("user-with-a-long-name-{}", i),
+        .roles   = {"reader", std::format("group-with-a-long-name-{}", i % 100)},
+        .samples = std::vector<double>(i % 32),
+      });
+      out.sessions.emplace(i, *s);
+      out.by_user.emplace(s->user, std::move(s));
+    }
+    return out;
+  }();
+  return c;
+}
+
+BENCH_LATENCY("memory_usage: 100k sessions, full walk", 20) {
+  bench::do_not_optimize(refl::memory_usage(cache()).heap_bytes);
+}
+
+BENCH_LATENCY("memory_usage: 100k sessions, 1k sample per container", 20) {
+  bench::do_not_optimize(refl::memory_usage(cache(), {.sample_limit = 1000}).heap_bytes);
+}
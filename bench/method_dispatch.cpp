@@ -0,0 +1,103 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct dispatch_base {
+  virtual ~dispatch_base() = default;
+  virtual int add(int v) = 0;
+};
+
+struct dispatch_target: dispatch_base {
+  int acc = 0;
+
+  int add(int v) override {
+    acc += v;
+    return acc;
+  }
+  int sub(int v) {
+    acc -= v;
+    return acc;
+  }
+};
+
+static int switch_dispatch(dispatch_target& obj, std::size_t method, int v) {
+  switch (method) {
+    case 0:
+      return obj.add(v);
+    case 1:
+      return obj.sub(v);
+    default:
+      return 0;
+  }
+}
+
+static const refl::method_info& add_method() {
+  static const auto* m = refl::type_info::from<dispatch_target>()
+                           .method_by_hash(refl::detail::fnv1a("add"))
+                           .value();
+  return *m;
+}
+
+BENCH_N("dispatch: direct call", 100000) {
+  dispatch_target obj{};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(obj.add(1));
+  }
+}
+
+BENCH_N("dispatch: virtual call", 100000) {
+  dispatch_target obj{};
+  dispatch_base*  base = &obj;
+  bench::do_not_optimize(base);
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(base->add(1));
+  }
+}
+
+BENCH_N("dispatch: hand-written switch", 100000) {
+  dispatch_target obj{};
+  std::size_t     method = 0;
+  bench::do_not_optimize(method);
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(switch_dispatch(obj, method, 1));
+  }
+}
+
+BENCH_N("dispatch: refl invoker thunk", 100000) {
+  dispatch_target obj{};
+  const auto&     m      = add_method();
+  int             arg    = 1;
+  void*           args[] = {&arg};
+  alignas(int) std::byte result[sizeof(int)];
+  for (std::size_t i = 0; i < iterations; ++i) {
+    m.invoker(&obj, args, result);
+    bench::do_not_optimize(*std::launder(reinterpret_cast<int*>(result)));
+  }
+}
+
+BENCH_N("dispatch: refl invoke (any_ref, checked)", 100000) {
+  dispatch_target obj{};
+  const auto&     m   = add_method();
+  int             arg = 1;
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::any result = m.invoke(obj, {arg});
+    bench::do_not_optimize(result.data());
+  }
+}
+
+BENCH_N("dispatch: refl lookup by hash + invoker", 100000) {
+  dispatch_target obj{};
+  const auto&     ti     = refl::type_info::from<dispatch_target>();
+  constexpr auto  hash   = refl::detail::fnv1a("add");
+  int             arg    = 1;
+  void*           args[] = {&arg};
+  alignas(int) std::byte result[sizeof(int)];
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto* m = ti.method_by_hash(hash).value();
+    m->invoker(&obj, args, result);
+    bench::do_not_optimize(*std::launder(reinterpret_cast<int*>(result)));
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Scaling of NDJSON reads and writes from 1 to every hardware thread, over a generated file of
+// CPP_REFLECT_NDJSON_MB megabytes (1024 by default) in the temporary directory.
+
+#include "bench.h"
+
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <thread>
+
+import reflect;
+import reflect.serialize;
+
+struct event {
+  std::uint64_t id = 0;
+  [[meta(refl::gen::length{8, 24})]]
+  std::string user{};
+  [[meta(refl::gen::length{16, 64})]]
+  std::string action{};
+  [[meta(refl::gen::range{0.0, 1000.0})]]
+  double amount = 0.0;
+  [[meta(refl::gen::count{0, 8})]]
+  std::vector<int> flags{};
+  [[meta(refl::gen::count{0, 4})]]
+  std::map<std::string, std::string> labels{};
+};
+
+static std::size_t target_bytes() {
+  const char* env = std::getenv("CPP_REFLECT_NDJSON_MB");
+  return (env != nullptr ? std::stoull(env) : 1024) << 20;
+}
+
+/// The records of one generated batch, repeated until the file is large enough
+static const std::filesystem::path& input_file() {
+  static const std::filesystem::path path = [] {
+    auto file = std::filesystem::temp_directory_path() / "cpp_reflect_bench.ndjson";
+    const std::string batch = refl::ndjson::write(refl::generate_n<event>(100'000, 1));
+    std::ofstream     out{file, std::ios::binary | std::ios::trunc};
+    for (std::size_t written = 0; written < target_bytes(); written += batch.size()) {
+      out.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+    }
+    std::cout << std::format(
+      "input: {} ({} MB)\n", file.string(), std::filesystem::file_size(file) >> 20
+    );
+    return file;
+  }();
+  return path;
+}
+
+static const std::vector<event>& records() {
+  static const auto values = refl::ndjson::read_file<event>(input_file());
+  return values;
+}
+
+static std::vector<std::size_t> thread_counts() {
+  std::vector<std::size_t> counts{};
+  const std::size_t        hardware = std::max(1U, std::thread::hardware_concurrency());
+  for (std::size_t threads = 1; threads < hardware; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(hardware);
+  return counts;
+}
+
+static const bool registered = [] {
+  static std::deque<bench::case_t> cases{};
+  for (const std::size_t threads: thread_counts()) {
+    const refl::ndjson::options options{.threads = threads};
+    cases.emplace_back(
+      std::format("ndjson: read file, {} thread(s)", threads),
+      std::source_location::current(),
+      1,
+      3,
+      [options](std::size_t) {
+        bench::do_not_optimize(refl::ndjson::read_file<event>(input_file(), options).size());
+      }
+    );
+    cases.emplace_back(
+      std::format("ndjson: write string, {} thread(s)", threads),
+      std::source_location::current(),
+      1,
+      3,
+      [options](std::size_t) {
+        bench::do_not_optimize(refl::ndjson::write(records(), options).size());
+      }
+    );
+  }
+  return true;
+}();
@@ -0,0 +1,136 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Scaling of the parallel deep_eq and deep_hash from 1 to every hardware thread over a
+// multi-million element state, and how soon deep_eq returns when the first difference is found
+// at the start or at the end.
+
+#include "bench.h"
+
+#include <deque>
+#include <thread>
+
+import reflect;
+
+struct particle {
+  std::uint64_t id   = 0;
+  double        x    = 0.0;
+  double        y    = 0.0;
+  double        z    = 0.0;
+  int           kind = 0;
+};
+
+struct world_state {
+  std::vector<particle>           particles{};
+  std::vector<std::uint32_t>      grid{};
+  std::map<std::string, int>      counters{};
+  std::vector<std::vector<float>> samples{};
+};
+
+static world_state make_state() {
+  world_state state{};
+  state.particles.resize(1'000'000);
+  for (std::size_t i = 0; i < state.particles.size(); ++i) {
+    const auto position = static_cast<double>(i);
+
+    state.particles[i] = {
+      .id   = i,
+      .x    = position * 0.5,
+      .y    = position * 0.25,
+      .z    = position * 0.125,
+      .kind = static_cast<int>(i % 7),
+    };
+  }
+  state.grid.resize(4'000'000);
+  std::ranges::iota(state.grid, 0U);
+  state.counters = {{"ticks", 1}, {"spawned", 2}, {"despawned", 3}};
+  state.samples.assign(1024, std::vector<float>(256, 1.0F));
+  return state;
+}
+
+static const world_state& base() {
+  static const world_state state = make_state();
+  return state;
+}
+
+static const world_state& copy() {
+  static const world_state state = make_state();
+  return state;
+}
+
+/// Differs from `base()` in its first particle only
+static const world_state& first_different() {
+  static const world_state state = [] {
+    world_state s            = make_state();
+    s.particles.front().kind = -1;
+    return s;
+  }();
+  return state;
+}
+
+/// Differs from `base()` in its last grid cell only
+static const world_state& last_different() {
+  static const world_state state = [] {
+    world_state s = make_state();
+    s.grid.back() = 0;
+    return s;
+  }();
+  return state;
+}
+
+static std::vector<std::size_t> thread_counts() {
+  std::vector<std::size_t> counts{};
+  const std::size_t        hardware = std::max(1U, std::thread::hardware_concurrency());
+  for (std::size_t threads = 1; threads < hardware; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(hardware);
+  return counts;
+}
+
+BENCH_N("deep_eq: equal, sequential", 1) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::deep_eq(base(), copy()));
+  }
+}
+
+BENCH_N("deep_hash: sequential", 1) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::deep_hash(base()));
+  }
+}
+
+BENCH_N("deep_eq: first element differs, sequential", 1) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::deep_eq(base(), first_different()));
+  }
+}
+
+BENCH_N("deep_eq: last element differs, sequential", 1) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::deep_eq(base(), last_different()));
+  }
+}
+
+static const bool registered = [] {
+  static std::deque<bench::case_t> cases{};
+  const auto add = [](std::string name, auto body) {
+    cases.emplace_back(std::move(name), std::source_location::current(), 1, 21, body);
+  };
+  for (const std::size_t threads: thread_counts()) {
+    const refl::parallel_policy policy{.threads = threads};
+    add(std::format("deep_eq: equal, {} thread(s)", threads), [policy](auto) {
+      bench::do_not_optimize(refl::deep_eq(base(), copy(), policy));
+    });
+    add(std::format("deep_hash: {} thread(s)", threads), [policy](auto) {
+      bench::do_not_optimize(refl::deep_hash(base(), policy));
+    });
+    add(std::format("deep_eq: first element differs, {} thread(s)", threads), [policy](auto) {
+      bench::do_not_optimize(refl::deep_eq(base(), first_different(), policy));
+    });
+    add(std::format("deep_eq: last element differs, {} thread(s)", threads), [policy](auto) {
+      bench::do_not_optimize(refl::deep_eq(base(), last_different(), policy));
+    });
+  }
+  return true;
+}();
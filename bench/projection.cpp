@@ -0,0 +1,91 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct wide_header {
+  int         version = 3;
+  std::string source  = "ingest-eu-west-1";
+};
+
+struct wide_record {
+  int                        id = 0;
+  wide_header                header{};
+  std::string                name{};
+  std::string                email{};
+  std::string                address{};
+  std::string                notes{};
+  std::vector<int>           history{};
+  std::vector<std::string>   tags{};
+  std::map<std::string, int> counters{};
+  double                     score   = 0.0;
+  double                     balance = 0.0;
+  long                       created = 0;
+  long                       updated = 0;
+  int                        zone    = 0;
+};
+
+static const std::vector<std::string>& documents() {
+  static const std::vector<std::string> docs = [] {
+    std::vector<std::string> out{};
+    for (int i = 0; i < 1000; ++i) {
+      wide_record record{
+        .id       = i,
+        .name     = std::format("customer number {}", i),
+        .email    = std::format("customer.{}@example.com", i),
+        .address  = std::format("{} Long Street Name, Some City, Some Country", i),
+        .notes    = std::string(256, 'n'),
+        .history  = std::vector<int>(64, i),
+        .tags     = {"alpha", "beta", "gamma", "delta"},
+        .counters = {{"logins", i}, {"orders", 2 * i}, {"returns", i % 7}},
+        .score    = i * 0.5,
+        .balance  = i * 12.25,
+        .created  = 1'700'000'000L + i,
+        .updated  = 1'700'100'000L + i,
+        .zone     = i % 16,
+      };
+      out.push_back(refl::to_string<formats::json_fmt>(record));
+    }
+    return out;
+  }();
+  return docs;
+}
+
+template <typename Read>
+static void decode_case(std::size_t iterations, Read&& read) {
+  const auto& docs = documents();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    wide_record record{};
+    read(docs[i % docs.size()], record);
+    bench::do_not_optimize(record);
+  }
+}
+
+BENCH_N("projection: full decode (wide record)", 1000) {
+  decode_case(iterations, [](std::string_view json, wide_record& record) {
+    refl::read_json(json, record);
+  });
+}
+
+// Keys are sorted, "address" comes first and "zone" last
+BENCH_N("projection: 1 field, first key (wide record)", 1000) {
+  decode_case(iterations, [](std::string_view json, wide_record& record) {
+    refl::project_json<wide_record, "address">(json, record);
+  });
+}
+
+BENCH_N("projection: 2 fields, last key and nested (wide record)", 1000) {
+  decode_case(iterations, [](std::string_view json, wide_record& record) {
+    refl::project_json<wide_record, "header.version", "zone">(json, record);
+  });
+}
+
+BENCH_N("projection: runtime paths, 3 fields (wide record)", 1000) {
+  static const refl::projection<wide_record> selected{"id", "score", "header.source"};
+  decode_case(iterations, [](std::string_view json, wide_record& record) {
+    selected.read_json(json, record);
+  });
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct record {
+  int         id    = 0;
+  double      price = 0.0;
+  int         qty   = 0;
+  bool        open  = true;
+  std::string sym   = {};
+};
+
+static constexpr std::size_t record_count = 1 << 20;
+
+static const std::vector<record>& records() {
+  static const std::vector<record> rows = [] {
+    std::vector<record> out{};
+    out.reserve(record_count);
+    for (std::size_t i = 0; i < record_count; ++i) {
+      out.push_back({
+        static_cast<int>(i),
+        static_cast<double>(i % 1000) / 4.0,
+        static_cast<int>(i % 13),
+        i % 5 != 0,
+        "SYM",
+      });
+    }
+    return out;
+  }();
+  return rows;
+}
+
+static const refl::soa_vector<record>& columns() {
+  static const refl::soa_vector<record> rows{records()};
+  return rows;
+}
+
+// price > 100 and qty >= 4, then sum qty over the matches
+
+BENCH_N("query: filter + sum (hand-written loop)", 1) {
+  const auto& rows = records();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    std::int64_t total = 0;
+    for (const auto& row: rows) {
+      if (row.price > 100.0 and row.qty >= 4) {
+        total += row.qty;
+      }
+    }
+    bench::do_not_optimize(total);
+  }
+}
+
+BENCH_N("query: filter + sum (refl::query)", 1) {
+  const auto& rows = records();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    refl::query<record> q{rows};
+    q.where<"price">(refl::ops::gt, 100.0).where<"qty">(refl::ops::ge, 4);
+    bench::do_not_optimize(q.sum<"qty">());
+  }
+}
+
+BENCH_N("query: filter + sum (refl::query, soa_vector)", 1) {
+  const auto& rows = columns();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    refl::query<record> q{rows};
+    q.where<"price">(refl::ops::gt, 100.0).where<"qty">(refl::ops::ge, 4);
+    bench::do_not_optimize(q.sum<"qty">());
+  }
+}
+
+BENCH_N("query: filter + sum (refl::query, parallel)", 1) {
+  const auto& rows = records();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    refl::query<record> q{rows};
+    q.parallel().where<"price">(refl::ops::gt, 100.0).where<"qty">(refl::ops::ge, 4);
+    bench::do_not_optimize(q.sum<"qty">());
+  }
+}
+
+// Projection of two fields
+
+BENCH_N("query: filter + project (hand-written loop)", 1) {
+  const auto& rows = records();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    std::vector<std::tuple<int, int>> out{};
+    for (const auto& row: rows) {
+      if (row.price > 100.0 and row.open) {
+        out.emplace_back(row.id, row.qty);
+      }
+    }
+    bench::do_not_optimize(out.data());
+  }
+}
+
+BENCH_N("query: filter + project (refl::query)", 1) {
+  const auto& rows = records();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    auto out = refl::query<record>(rows)
+                 .where<"price">(refl::ops::gt, 100.0)
+                 .where<"open">(refl::ops::eq, true)
+                 .select<"id", "qty">();
+    bench::do_not_optimize(out.data());
+  }
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct config_entry {
+  int                        id    = 42;
+  std::string                name  = "sensor-7";
+  double                     value = 3.25;
+  std::vector<int>           tags  = {1, 2, 3};
+  std::map<std::string, int> limits{{"max", 100}, {"min", -100}};
+};
+
+static constexpr std::size_t latency_samples = 20001;
+
+BENCH_LATENCY("serialize json: static", latency_samples) {
+  static const config_entry entry{};
+  bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(entry));
+}
+
+BENCH_LATENCY("serialize json: refl::any (type_info thunks)", latency_samples) {
+  static const refl::any entry = refl::any::make(config_entry{});
+  bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(entry));
+}
+
+BENCH_LATENCY("serialize json: refl::archive", latency_samples) {
+  static const refl::archive archive = [] {
+    refl::archive a{};
+    a["entry/id"]     = 42;
+    a["entry/name"]   = std::string{"sensor-7"};
+    a["entry/value"]  = 3.25;
+    a["entry/tags"]   = std::vector<int>{1, 2, 3};
+    a["entry/limits"] = std::map<std::string, int>{{"max", 100}, {"min", -100}};
+    return a;
+  }();
+  bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(archive));
+}
+
+BENCH_LATENCY("serialize default: static", latency_samples) {
+  static const config_entry entry{};
+  bench::do_not_optimize(refl::serializer<formats::default_fmt>::to_string_view(entry));
+}
+
+BENCH_LATENCY("serialize default: refl::any (type_info thunks)", latency_samples) {
+  static const refl::any entry = refl::any::make(config_entry{});
+  bench::do_not_optimize(refl::serializer<formats::default_fmt>::to_string_view(entry));
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct reading {
+  int         id    = 0;
+  double      value = 0.0;
+  std::string label = {};
+};
+
+struct large_state {
+  reading r00{0, 0.5, "reading-00"};
+  reading r01{1, 1.5, "reading-01"};
+  reading r02{2, 2.5, "reading-02"};
+  reading r03{3, 3.5, "reading-03"};
+  reading r04{4, 4.5, "reading-04"};
+  reading r05{5, 5.5, "reading-05"};
+  reading r06{6, 6.5, "reading-06"};
+  reading r07{7, 7.5, "reading-07"};
+  reading r08{8, 8.5, "reading-08"};
+  reading r09{9, 9.5, "reading-09"};
+  reading r10{10, 10.5, "reading-10"};
+  reading r11{11, 11.5, "reading-11"};
+  reading r12{12, 12.5, "reading-12"};
+  reading r13{13, 13.5, "reading-13"};
+  reading r14{14, 14.5, "reading-14"};
+  reading r15{15, 15.5, "reading-15"};
+  reading r16{16, 16.5, "reading-16"};
+  reading r17{17, 17.5, "reading-17"};
+  reading r18{18, 18.5, "reading-18"};
+  reading r19{19, 19.5, "reading-19"};
+  reading r20{20, 20.5, "reading-20"};
+  reading r21{21, 21.5, "reading-21"};
+  reading r22{22, 22.5, "reading-22"};
+  reading r23{23, 23.5, "reading-23"};
+  reading r24{24, 24.5, "reading-24"};
+  reading r25{25, 25.5, "reading-25"};
+  reading r26{26, 26.5, "reading-26"};
+  reading r27{27, 27.5, "reading-27"};
+  reading r28{28, 28.5, "reading-28"};
+  reading r29{29, 29.5, "reading-29"};
+  reading r30{30, 30.5, "reading-30"};
+  reading r31{31, 31.5, "reading-31"};
+  reading r32{32, 32.5, "reading-32"};
+  reading r33{33, 33.5, "reading-33"};
+  reading r34{34, 34.5, "reading-34"};
+  reading r35{35, 35.5, "reading-35"};
+  reading r36{36, 36.5, "reading-36"};
+  reading r37{37, 37.5, "reading-37"};
+  reading r38{38, 38.5, "reading-38"};
+  reading r39{39, 39.5, "reading-39"};
+  reading r40{40, 40.5, "reading-40"};
+  reading r41{41, 41.5, "reading-41"};
+  reading r42{42, 42.5, "reading-42"};
+  reading r43{43, 43.5, "reading-43"};
+  reading r44{44, 44.5, "reading-44"};
+  reading r45{45, 45.5, "reading-45"};
+  reading r46{46, 46.5, "reading-46"};
+  reading r47{47, 47.5, "reading-47"};
+  reading r48{48, 48.5, "reading-48"};
+  reading r49{49, 49.5, "reading-49"};
+  reading r50{50, 50.5, "reading-50"};
+  reading r51{51, 51.5, "reading-51"};
+  reading r52{52, 52.5, "reading-52"};
+  reading r53{53, 53.5, "reading-53"};
+  reading r54{54, 54.5, "reading-54"};
+  reading r55{55, 55.5, "reading-55"};
+  reading r56{56, 56.5, "reading-56"};
+  reading r57{57, 57.5, "reading-57"};
+  reading r58{58, 58.5, "reading-58"};
+  reading r59{59, 59.5, "reading-59"};
+  reading r60{60, 60.5, "reading-60"};
+  reading r61{61, 61.5, "reading-61"};
+  reading r62{62, 62.5, "reading-62"};
+  reading r63{63, 63.5, "reading-63"};
+  reading r64{64, 64.5, "reading-64"};
+  reading r65{65, 65.5, "reading-65"};
+  reading r66{66, 66.5, "reading-66"};
+  reading r67{67, 67.5, "reading-67"};
+  reading r68{68, 68.5, "reading-68"};
+  reading r69{69, 69.5, "reading-69"};
+  reading r70{70, 70.5, "reading-70"};
+  reading r71{71, 71.5, "reading-71"};
+  reading r72{72, 72.5, "reading-72"};
+  reading r73{73, 73.5, "reading-73"};
+  reading r74{74, 74.5, "reading-74"};
+  reading r75{75, 75.5, "reading-75"};
+  reading r76{76, 76.5, "reading-76"};
+  reading r77{77, 77.5, "reading-77"};
+  reading r78{78, 78.5, "reading-78"};
+  reading r79{79, 79.5, "reading-79"};
+  reading r80{80, 80.5, "reading-80"};
+  reading r81{81, 81.5, "reading-81"};
+  reading r82{82, 82.5, "reading-82"};
+  reading r83{83, 83.5, "reading-83"};
+  reading r84{84, 84.5, "reading-84"};
+  reading r85{85, 85.5, "reading-85"};
+  reading r86{86, 86.5, "reading-86"};
+  reading r87{87, 87.5, "reading-87"};
+  reading r88{88, 88.5, "reading-88"};
+  reading r89{89, 89.5, "reading-89"};
+  reading r90{90, 90.5, "reading-90"};
+  reading r91{91, 91.5, "reading-91"};
+  reading r92{92, 92.5, "reading-92"};
+  reading r93{93, 93.5, "reading-93"};
+  reading r94{94, 94.5, "reading-94"};
+  reading r95{95, 95.5, "reading-95"};
+  reading r96{96, 96.5, "reading-96"};
+  reading r97{97, 97.5, "reading-97"};
+  reading r98{98, 98.5, "reading-98"};
+  reading r99{99, 99.5, "reading-99"};
+};
+
+static constexpr std::size_t latency_samples = 5001;
+static constexpr std::size_t state_fields    = refl::field_count<large_state>;
+
+using tracked_state = refl::tracked<large_state>;
+
+/// Changes the first `count` fields, one edit per field
+static void touch_fields(tracked_state& state, std::size_t count) {
+  static constexpr auto touch = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<void (*)(tracked_state&), sizeof...(I)>{
+      [](tracked_state& s) { s.edit<I>().value += 1.0; }...
+    };
+  }(std::make_index_sequence<state_fields>{});
+
+  for (std::size_t i = 0; i < count; ++i) {
+    touch[i](state);
+  }
+}
+
+template <std::size_t Percent>
+static void incremental_tick(bool only_dirty) {
+  static tracked_state state{};
+  static refl::incremental_serializer<formats::json_fmt, large_state> inc{};
+
+  touch_fields(state, state_fields * Percent / 100);
+  if (only_dirty) {
+    bench::do_not_optimize(inc.serialize_dirty(state));
+  } else {
+    bench::do_not_optimize(inc.serialize(state));
+  }
+}
+
+BENCH_LATENCY("tick json: full re-serialize", latency_samples) {
+  static tracked_state state{};
+  touch_fields(state, 1);
+  bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(state.value()));
+}
+
+BENCH_LATENCY("tick json: incremental, 1% changed", latency_samples) {
+  incremental_tick<1>(false);
+}
+
+BENCH_LATENCY("tick json: incremental, 10% changed", latency_samples) {
+  incremental_tick<10>(false);
+}
+
+BENCH_LATENCY("tick json: incremental, 100% changed", latency_samples) {
+  incremental_tick<100>(false);
+}
+
+BENCH_LATENCY("tick json: dirty fields only, 1% changed", latency_samples) {
+  incremental_tick<1>(true);
+}
+
+BENCH_LATENCY("tick json: dirty fields only, 10% changed", latency_samples) {
+  incremental_tick<10>(true);
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Documents that share a large catalog and rate table, serialized to JSON with and without a
+// `refl::serialization_cache`. Hits and misses are printed once per case.
+
+#include "bench.h"
+
+#include <deque>
+
+import reflect;
+import reflect.serialize;
+
+struct catalog_item {
+  std::string              sku{};
+  std::string              title{};
+  double                   price = 0.0;
+  std::vector<std::string> tags{};
+};
+
+struct order_line {
+  std::string sku{};
+  int         quantity = 0;
+};
+
+struct order_document {
+  long                    id = 0;
+  std::string             customer{};
+  std::vector<order_line> lines{};
+  [[meta(serialize::immutable{})]]
+  std::vector<catalog_item> catalog{};
+  [[meta(serialize::immutable{})]]
+  std::map<std::string, double> rates{};
+};
+
+static const std::vector<catalog_item>& shared_catalog() {
+  static const std::vector<catalog_item> catalog = [] {
+    std::vector<catalog_item> items{};
+    for (int i = 0; i < 2000; ++i) {
+      items.push_back({
+        .sku   = std::format("SKU-{:06}", i),
+        .title = std::format("Catalog item number {}", i),
+        .price = i * 0.25,
+        .tags  = {"catalog", std::format("group-{}", i % 17)},
+      });
+    }
+    return items;
+  }();
+  return catalog;
+}
+
+static std::vector<order_document> make_documents() {
+  std::map<std::string, double> rates{};
+  for (int i = 0; i < 200; ++i) {
+    rates.emplace(std::format("CUR{:03}", i), 1.0 + i * 0.01);
+  }
+
+  std::vector<order_document> documents{};
+  for (long id = 0; id < 64; ++id) {
+    order_document& document = documents.emplace_back();
+    document.id              = id;
+    document.customer        = std::format("customer-{}", id);
+    document.lines           = {{"SKU-000001", 1}, {"SKU-000002", static_cast<int>(id)}};
+    document.catalog         = shared_catalog();
+    document.rates           = rates;
+  }
+  return documents;
+}
+
+static void add_case(std::string name, refl::serialization_cache* cache) {
+  static std::deque<bench::case_t> cases{};
+  cases.emplace_back(
+    name,
+    std::source_location::current(),
+    64,
+    51,
+    [name, cache, reported = false](std::size_t iterations) mutable {
+      static const std::vector<order_document> documents = make_documents();
+      const formats::json_fmt_args             args{.cache = cache};
+      for (std::size_t i = 0; i < iterations; ++i) {
+        bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(
+          documents[i % documents.size()], args
+        ));
+      }
+      if (cache != nullptr and not reported) {
+        reported = true;
+        std::cout << std::format(
+          "{}: {} hit(s), {} miss(es), {} cached byte(s)\n",
+          name,
+          cache->hits(),
+          cache->misses(),
+          cache->bytes()
+        );
+      }
+    }
+  );
+}
+
+static const bool registered = [] {
+  static refl::serialization_cache cache{};
+  add_case("memo json: shared subtrees, no cache", nullptr);
+  add_case("memo json: shared subtrees, cached", &cache);
+  return true;
+}();
@@ -0,0 +1,49 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct small_message {
+  int              id    = 42;
+  std::string      name  = "sensor-7";
+  double           value = 3.25;
+  std::vector<int> tags  = {1, 2, 3};
+};
+
+static constexpr std::size_t latency_samples = 20001;
+
+template <template <typename> typename Format>
+static std::string stringstream_path(const small_message& msg) {
+  std::stringstream str{};
+  auto              format = Format<std::stringstream>{str, {}};
+  format.serialize(msg);
+  return str.str();
+}
+
+BENCH_LATENCY("serialize json: stringstream", latency_samples) {
+  small_message msg{};
+  bench::do_not_optimize(stringstream_path<formats::json_fmt>(msg));
+}
+
+BENCH_LATENCY("serialize json: to_string (reused sink)", latency_samples) {
+  small_message msg{};
+  bench::do_not_optimize(refl::to_string<formats::json_fmt>(msg));
+}
+
+BENCH_LATENCY("serialize json: to_string_view (reused sink)", latency_samples) {
+  small_message msg{};
+  bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(msg));
+}
+
+BENCH_LATENCY("serialize default: stringstream", latency_samples) {
+  small_message msg{};
+  bench::do_not_optimize(stringstream_path<formats::default_fmt>(msg));
+}
+
+BENCH_LATENCY("serialize default: to_string_view (reused sink)", latency_samples) {
+  small_message msg{};
+  bench::do_not_optimize(refl::serializer<formats::default_fmt>::to_string_view(msg));
+}
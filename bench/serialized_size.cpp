@@ -0,0 +1,120 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Small messages serialized through a stringstream, `to_string` and `to_string_exact`. Heap
+// allocations per message are counted by replacing the global allocator, and printed once per
+// case.
+
+#include "bench.h"
+
+#include <cstdlib>
+#include <deque>
+#include <new>
+
+import reflect;
+import reflect.serialize;
+
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+/// Every member has a bounded width, the JSON size bound is known at compile time
+struct fixed_message {
+  int                  id        = 42;
+  unsigned long        timestamp = 1'700'000'000'000UL;
+  double               value     = 3.25;
+  bool                 valid     = true;
+  std::array<short, 3> axes      = {1, -2, 3};
+};
+
+/// Strings and vectors, the size is measured before serializing
+struct variable_message {
+  int              id    = 42;
+  std::string      name  = "sensor-7";
+  double           value = 3.25;
+  std::vector<int> tags  = {1, 2, 3};
+};
+
+template <template <typename> typename Format, typename T>
+static std::string stringstream_path(const T& msg) {
+  std::stringstream str{};
+  auto              format = Format<std::stringstream>{str, {}};
+  format.serialize(msg);
+  return str.str();
+}
+
+/// Registers a case timing `encode`, printing how many allocations one call makes the first time
+/// the case runs
+template <typename Encode>
+static void add_case(std::string name, Encode encode) {
+  static std::deque<bench::case_t> cases{};
+  cases.emplace_back(
+    name,
+    std::source_location::current(),
+    10000,
+    101,
+    [name, encode, reported = false](std::size_t iterations) mutable {
+      if (not reported) {
+        reported                 = true;
+        const std::size_t before = allocations.load(std::memory_order_relaxed);
+        bench::do_not_optimize(encode());
+        std::cout << std::format(
+          "{}: {} allocation(s)\n", name, allocations.load(std::memory_order_relaxed) - before
+        );
+      }
+      for (std::size_t i = 0; i < iterations; ++i) {
+        bench::do_not_optimize(encode());
+      }
+    }
+  );
+}
+
+static const bool registered = [] {
+  static const fixed_message    fixed{};
+  static const variable_message variable{};
+
+  add_case("sized json: stringstream (fixed)", [] {
+    return stringstream_path<formats::json_fmt>(fixed);
+  });
+  add_case("sized json: to_string (fixed)", [] {
+    return refl::to_string<formats::json_fmt>(fixed);
+  });
+  add_case("sized json: to_string_exact, compile-time bound (fixed)", [] {
+    return refl::to_string_exact<formats::json_fmt>(fixed);
+  });
+  add_case("sized json: serialized_size (fixed)", [] {
+    return refl::serialized_size<formats::json_fmt>(fixed);
+  });
+
+  add_case("sized json: stringstream (variable)", [] {
+    return stringstream_path<formats::json_fmt>(variable);
+  });
+  add_case("sized json: to_string (variable)", [] {
+    return refl::to_string<formats::json_fmt>(variable);
+  });
+  add_case("sized json: to_string_exact, measured (variable)", [] {
+    return refl::to_string_exact<formats::json_fmt>(variable);
+  });
+
+  add_case("sized default: to_string (variable)", [] {
+    return refl::to_string<formats::default_fmt>(variable);
+  });
+  add_case("sized default: to_string_exact, measured (variable)", [] {
+    return refl::to_string_exact<formats::default_fmt>(variable);
+  });
+  return true;
+}();
@@ -0,0 +1,108 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct particle {
+  float x     = 0.0F;
+  float y     = 0.0F;
+  float z     = 0.0F;
+  float vx    = 0.0F;
+  float vy    = 0.0F;
+  float vz    = 0.0F;
+  float mass  = 1.0F;
+  int   id    = 0;
+  bool  alive = true;
+};
+
+static constexpr std::size_t particle_count = 1 << 20;
+
+static const std::vector<particle>& aos() {
+  static const std::vector<particle> rows = [] {
+    std::vector<particle> out{};
+    out.reserve(particle_count);
+    for (std::size_t i = 0; i < particle_count; ++i) {
+      const auto f = static_cast<float>(i);
+      out.push_back(
+        {f, f * 0.5F, f * 0.25F, 1.0F, -1.0F, 0.5F, 1.0F + f * 0.001F, static_cast<int>(i), i % 3 != 0}
+      );
+    }
+    return out;
+  }();
+  return rows;
+}
+
+static const refl::soa_vector<particle>& soa() {
+  static const refl::soa_vector<particle> rows{aos()};
+  return rows;
+}
+
+// Single field reduction: AoS drags every row's 36 bytes through the cache for 4 useful ones
+
+BENCH_N("soa: sum mass (AoS)", 1) {
+  const auto& rows = aos();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    float total = 0.0F;
+    for (const auto& p: rows) {
+      total += p.mass;
+    }
+    bench::do_not_optimize(total);
+  }
+}
+
+BENCH_N("soa: sum mass (SoA column)", 1) {
+  const auto& rows = soa();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    float total = 0.0F;
+    for (float mass: rows.column<6>()) {
+      total += mass;
+    }
+    bench::do_not_optimize(total);
+  }
+}
+
+// Full row iteration: every field is touched, the layouts should be close
+
+BENCH_N("soa: kinetic energy, all rows (AoS)", 1) {
+  const auto& rows = aos();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    float total = 0.0F;
+    for (const auto& p: rows) {
+      if (p.alive) {
+        total += 0.5F * p.mass * (p.vx * p.vx + p.vy * p.vy + p.vz * p.vz) + p.x + p.y + p.z;
+      }
+    }
+    bench::do_not_optimize(total);
+  }
+}
+
+BENCH_N("soa: kinetic energy, all rows (SoA proxies)", 1) {
+  const auto& rows = soa();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    float total = 0.0F;
+    for (auto p: rows) {
+      if (p.get<8>()) {
+        const float vx = p.get<3>(), vy = p.get<4>(), vz = p.get<5>();
+        total += 0.5F * p.get<6>() * (vx * vx + vy * vy + vz * vz) + p.get<0>() + p.get<1>() +
+                 p.get<2>();
+      }
+    }
+    bench::do_not_optimize(total);
+  }
+}
+
+BENCH_N("soa: kinetic energy, all rows (SoA load)", 1) {
+  const auto& rows = soa();
+  for (std::size_t it = 0; it < iterations; ++it) {
+    float total = 0.0F;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      const particle p = rows.load(i);
+      if (p.alive) {
+        total += 0.5F * p.mass * (p.vx * p.vx + p.vy * p.vy + p.vz * p.vz) + p.x + p.y + p.z;
+      }
+    }
+    bench::do_not_optimize(total);
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench.h"
+
+import reflect;
+
+struct trade {
+  std::int64_t  timestamp = 0;
+  std::uint32_t venue     = 0;
+  double        price     = 0.0;
+  std::int32_t  quantity  = 0;
+  std::string   symbol    = {};
+};
+
+static constexpr std::size_t trade_count = 1'000'000;
+
+static const std::vector<trade>& trades() {
+  static const std::vector<trade> rows = [] {
+    std::mt19937_64    rng{1234};
+    std::vector<trade> out{};
+    out.reserve(trade_count);
+    for (std::size_t i = 0; i < trade_count; ++i) {
+      out.push_back({
+        .timestamp = static_cast<std::int64_t>(rng() % 1'000'000'000),
+        .venue     = static_cast<std::uint32_t>(rng() % 16),
+        .price     = static_cast<double>(rng() % 100'000) / 100.0 - 500.0,
+        .quantity  = static_cast<std::int32_t>(rng() % 10'000) - 5'000,
+        .symbol    = std::format("SYM{:04}", rng() % 5'000),
+      });
+    }
+    return out;
+  }();
+  return rows;
+}
+
+// Copying the input is part of every case, it is the same for all of them
+
+BENCH_LATENCY("sort_by: venue, price (std::sort + lambda)", 11) {
+  auto rows = trades();
+  std::sort(rows.begin(), rows.end(), [](const trade& lhs, const trade& rhs) {
+    return std::tie(lhs.venue, lhs.price) < std::tie(rhs.venue, rhs.price);
+  });
+  bench::do_not_optimize(rows.data());
+}
+
+BENCH_LATENCY("sort_by: venue, price (std::stable_sort + lambda)", 11) {
+  auto rows = trades();
+  std::stable_sort(rows.begin(), rows.end(), [](const trade& lhs, const trade& rhs) {
+    return std::tie(lhs.venue, lhs.price) < std::tie(rhs.venue, rhs.price);
+  });
+  bench::do_not_optimize(rows.data());
+}
+
+BENCH_LATENCY("sort_by: venue, price (refl::sort_by)", 11) {
+  auto rows = trades();
+  refl::sort_by<trade, "venue", "price">(rows);
+  bench::do_not_optimize(rows.data());
+}
+
+BENCH_LATENCY("sort_by: venue, price (refl::parallel_sort_by)", 11) {
+  auto rows = trades();
+  refl::parallel_sort_by<trade, "venue", "price">(rows);
+  bench::do_not_optimize(rows.data());
+}
+
+BENCH_LATENCY("sort_by: symbol, timestamp (std::sort + lambda)", 11) {
+  auto rows = trades();
+  std::sort(rows.begin(), rows.end(), [](const trade& lhs, const trade& rhs) {
+    return std::tie(lhs.symbol, lhs.timestamp) < std::tie(rhs.symbol, rhs.timestamp);
+  });
+  bench::do_not_optimize(rows.data());
+}
+
+BENCH_LATENCY("sort_by: symbol, timestamp (refl::sort_by)", 11) {
+  auto rows = trades();
+  refl::sort_by<trade, "symbol", "timestamp">(rows);
+  bench::do_not_optimize(rows.data());
+}
+
+BENCH_LATENCY("sort_by: copy only (baseline)", 11) {
+  auto rows = trades();
+  bench::do_not_optimize(rows.data());
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// A constant configuration, serialized to JSON at runtime into the thread's buffer and read from
+// `refl::static_json`, where it was written while compiling.
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct listener {
+  char           address[32] = "0.0.0.0";
+  unsigned short port        = 443;
+  bool           tls         = true;
+};
+
+struct server_defaults {
+  const char*             name           = "edge";
+  int                     workers        = 16;
+  long                    max_body_bytes = 8L << 20;
+  std::array<listener, 3> listeners      = {{{}, {"::", 443, true}, {"127.0.0.1", 8080, false}}};
+  std::array<int, 4>      retry_delays   = {50, 100, 200, 400};
+};
+
+static constexpr server_defaults defaults{};
+
+BENCH_N("static_json: runtime to_string_view", 100000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::serializer<formats::json_fmt>::to_string_view(defaults));
+  }
+}
+
+BENCH_N("static_json: compile-time constant", 100000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::static_json<defaults>);
+  }
+}
@@ -0,0 +1,232 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Cross-subsystem suite over small, wide, deep and container heavy types. Part of the
+// `cpp_reflect_bench` target, compare two runs with `--json` and `--compare`.
+
+#include "bench.h"
+
+import reflect;
+import reflect.serialize;
+
+struct small_type {
+  int         id    = 7;
+  double      value = 2.5;
+  std::string name  = "small";
+};
+
+struct wide_type {
+  int         f00 = 0;
+  int         f01 = 1;
+  int         f02 = 2;
+  int         f03 = 3;
+  double      f04 = 4.0;
+  double      f05 = 5.0;
+  double      f06 = 6.0;
+  double      f07 = 7.0;
+  long        f08 = 8;
+  long        f09 = 9;
+  long        f10 = 10;
+  long        f11 = 11;
+  bool        f12 = true;
+  bool        f13 = false;
+  std::string f14 = "fourteen";
+  std::string f15 = "fifteen";
+};
+
+struct deep_leaf {
+  int         value = 1;
+  std::string label = "leaf";
+};
+struct deep_inner {
+  deep_leaf leaf{};
+  double    weight = 0.5;
+};
+struct deep_middle {
+  deep_inner inner{};
+  int        depth = 2;
+};
+struct deep_type {
+  deep_middle middle{};
+  std::string root = "root";
+};
+
+struct container_type {
+  std::vector<int>                numbers{};
+  std::vector<std::string>        names{};
+  std::map<std::string, int>      counts{};
+  std::unordered_map<int, double> weights{};
+  std::vector<small_type>         rows{};
+
+  container_type() {
+    for (int i = 0; i < 64; ++i) {
+      numbers.push_back(i);
+      names.push_back(std::format("name-{}", i));
+      counts.emplace(std::format("key-{}", i), i);
+      weights.emplace(i, i * 0.5);
+      rows.push_back({i, i * 1.5, std::format("row-{}", i)});
+    }
+  }
+};
+
+//! type_info
+
+BENCH_N("suite: type_info::from (small)", 100000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(&refl::type_info::from<small_type>());
+  }
+}
+
+BENCH_N("suite: type_info::from (wide)", 100000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(&refl::type_info::from<wide_type>());
+  }
+}
+
+BENCH_N("suite: field_by_name (small)", 100000) {
+  const auto&       info = refl::type_info::from<small_type>();
+  const std::string name{"name"};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(info.field_by_name(name));
+  }
+}
+
+BENCH_N("suite: field_by_name (wide, last field)", 100000) {
+  const auto&       info = refl::type_info::from<wide_type>();
+  const std::string name{"f15"};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(info.field_by_name(name));
+  }
+}
+
+//! any
+
+BENCH_N("suite: any copy (small)", 10000) {
+  const refl::any source{small_type{}};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::any copy{source};
+    bench::do_not_optimize(copy.data());
+  }
+}
+
+BENCH_N("suite: any copy (container heavy)", 100) {
+  const refl::any source{container_type{}};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::any copy{source};
+    bench::do_not_optimize(copy.data());
+  }
+}
+
+BENCH_N("suite: any move-construct from value (small)", 10000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    small_type value{};
+    refl::any  moved{std::move(value)};
+    bench::do_not_optimize(moved.data());
+  }
+}
+
+BENCH_N("suite: any move (small)", 10000) {
+  for (std::size_t i = 0; i < iterations; ++i) {
+    refl::any source{small_type{}};
+    refl::any moved{std::move(source)};
+    bench::do_not_optimize(moved.data());
+  }
+}
+
+//! archive
+
+static const refl::archive& sample_archive() {
+  static const refl::archive archive = [] {
+    refl::archive out{};
+    for (int i = 0; i < 256; ++i) {
+      out[std::format("section-{}/entry-{}", i % 16, i)] = refl::any{i};
+    }
+    return out;
+  }();
+  return archive;
+}
+
+BENCH_N("suite: archive lookup (256 entries)", 100000) {
+  const auto&       archive = sample_archive();
+  const std::string path{"section-7/entry-135"};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(&archive.at(path));
+  }
+}
+
+BENCH_N("suite: archive contains miss (256 entries)", 100000) {
+  const auto&       archive = sample_archive();
+  const std::string path{"section-7/missing"};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(archive.contains(path));
+  }
+}
+
+//! deep_eq
+
+template <typename T>
+static void deep_eq_case(std::size_t iterations) {
+  const T lhs{};
+  const T rhs{};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::deep_eq(lhs, rhs));
+  }
+}
+
+BENCH_N("suite: deep_eq (small)", 100000) {
+  deep_eq_case<small_type>(iterations);
+}
+
+BENCH_N("suite: deep_eq (wide)", 100000) {
+  deep_eq_case<wide_type>(iterations);
+}
+
+BENCH_N("suite: deep_eq (deep)", 100000) {
+  deep_eq_case<deep_type>(iterations);
+}
+
+BENCH_N("suite: deep_eq (container heavy)", 1000) {
+  deep_eq_case<container_type>(iterations);
+}
+
+//! Serialization
+
+template <template <typename> typename Format, typename T>
+static void serialize_case(std::size_t iterations) {
+  const T value{};
+  for (std::size_t i = 0; i < iterations; ++i) {
+    bench::do_not_optimize(refl::serializer<Format>::to_string_view(value));
+  }
+}
+
+BENCH_N("suite: default serialize (small)", 10000) {
+  serialize_case<formats::default_fmt, small_type>(iterations);
+}
+
+BENCH_N("suite: default serialize (wide)", 10000) {
+  serialize_case<formats::default_fmt, wide_type>(iterations);
+}
+
+BENCH_N("suite: default serialize (deep)", 10000) {
+  serialize_case<formats::default_fmt, deep_type>(iterations);
+}
+
+BENCH_N("suite: default serialize (container heavy)", 100) {
+  serialize_case<formats::default_fmt, container_type>(iterations);
+}
+
+BENCH_N("suite: json serialize (small)", 10000) {
+  serialize_case<formats::json_fmt, small_type>(iterations);
+}
+
+BENCH_N("suite: json serialize (wide)", 10000) {
+  serialize_case<formats::json_fmt, wide_type>(iterations);
+}
+
+BENCH_N("suite: json serialize (deep)", 10000) {
+  serialize_case<formats::json_fmt, deep_type>(iterations);
+}
+
+BENCH_N("suite: json serialize (container heavy)", 100) {
+  serialize_case<formats::json_fmt, container_type>(iterations);
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Readers of a shared configuration while a single writer keeps publishing new versions of it,
+// through `refl::versioned` and through a `std::shared_mutex`. The time of a case is the time the
+// readers take to each do `iterations` reads.
+
+#include "bench.h"
+
+#include <deque>
+#include <shared_mutex>
+#include <thread>
+
+import reflect;
+
+struct route {
+  std::string prefix  = "/api";
+  int         backend = 0;
+};
+
+struct gateway_config {
+  std::string        name        = "gateway";
+  int                max_clients = 1024;
+  double             timeout     = 2.5;
+  std::vector<route> routes      = {{"/api", 1}, {"/static", 2}, {"/admin", 3}};
+};
+
+static std::vector<std::size_t> reader_counts() {
+  std::vector<std::size_t> counts{};
+  // One thread is left to the writer
+  const std::size_t hardware = std::max(2U, std::thread::hardware_concurrency()) - 1;
+  for (std::size_t readers = 1; readers < hardware; readers *= 2) {
+    counts.push_back(readers);
+  }
+  counts.push_back(hardware);
+  return counts;
+}
+
+/// Runs `read` `iterations` times on each of `readers` threads while `write` runs in a loop on
+/// another one
+template <typename Read, typename Write>
+static void run_readers(std::size_t readers, std::size_t iterations, Read read, Write write) {
+  std::atomic<bool> done{false};
+  std::thread       writer{[&] {
+    while (not done.load(std::memory_order_relaxed)) {
+      write();
+      std::this_thread::yield();
+    }
+  }};
+
+  std::vector<std::thread> threads{};
+  for (std::size_t t = 0; t < readers; ++t) {
+    threads.emplace_back([&] {
+      for (std::size_t i = 0; i < iterations; ++i) {
+        bench::do_not_optimize(read());
+      }
+    });
+  }
+  for (auto& thread: threads) {
+    thread.join();
+  }
+  done = true;
+  writer.join();
+}
+
+static const bool registered = [] {
+  static std::deque<bench::case_t> cases{};
+  const auto add = [](std::string name, auto body) {
+    cases.emplace_back(std::move(name), std::source_location::current(), 10000, 21, body);
+  };
+
+  for (const std::size_t readers: reader_counts()) {
+    add(std::format("versioned: {} reader(s), 1 writer", readers), [readers](std::size_t n) {
+      refl::versioned<gateway_config> config{};
+      int                             next = 0;
+      run_readers(
+        readers,
+        n,
+        [&] {
+          const auto snapshot = config.read();
+          return snapshot->max_clients + snapshot->routes.back().backend;
+        },
+        [&] {
+          config.update([&](gateway_config& draft) {
+            draft.max_clients           = ++next;
+            draft.routes.back().backend = next;
+          });
+        }
+      );
+    });
+
+    add(std::format("shared_mutex: {} reader(s), 1 writer", readers), [readers](std::size_t n) {
+      gateway_config    config{};
+      std::shared_mutex mutex{};
+      int               next = 0;
+      run_readers(
+        readers,
+        n,
+        [&] {
+          std::shared_lock lock{mutex};
+          return config.max_clients + config.routes.back().backend;
+        },
+        [&] {
+          std::unique_lock lock{mutex};
+          config.max_clients           = ++next;
+          config.routes.back().backend = next;
+        }
+      );
+    });
+  }
+  return true;
+}();
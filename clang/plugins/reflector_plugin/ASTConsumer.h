@@ -20,6 +20,7 @@
 #include "clang/AST/CXXInheritance.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/PrettyPrinter.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/Stmt.h"
 #include "clang/AST/Type.h"
@@ -32,8 +33,13 @@
 #include "clang/Sema/ParsedAttr.h"
 #include "clang/Sema/Sema.h"
 #include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Attributes.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
@@ -44,9 +50,13 @@ using namespace clang;
 //-----------------------------------------------------------------------------
 class ReflectorASTConsumer: public clang::ASTConsumer {
 public:
-  explicit ReflectorASTConsumer(CompilerInstance* CI, ASTContext* Ctx)
+  explicit ReflectorASTConsumer(
+    CompilerInstance* CI, ASTContext* Ctx, std::string InFile = {}, std::string LayoutDir = {}
+  )
       : Compiler(CI),
-        Context(Ctx) {
+        Context(Ctx),
+        in_file(std::move(InFile)),
+        layout_dir(std::move(LayoutDir)) {
 
     if (Context->getCurrentNamedModule() && checkModuleUsable(Context->getCurrentNamedModule())) {
       // llvm::outs() << "[INFO] Adding static type information to module." << "\n";
@@ -286,16 +296,134 @@ public:
     record->addDecl(MetadataVar);
   }
 
+  Expr* make_method_pointer_expr(CXXRecordDecl* record, CXXMethodDecl* method) {
+    // Constructors, destructors and compiler-declared members can't (or shouldn't) have their
+    // address taken, nor can methods whose return type hasn't been deduced yet. Standard library
+    // specializations are skipped too: referencing every member would force instantiating
+    // members that are ill-formed for the given arguments.
+    if (record->isInStdNamespace() ||
+        isa<CXXConstructorDecl>(method) || isa<CXXDestructorDecl>(method) ||
+        method->isImplicit() || method->isDeleted() ||
+        method->getReturnType()->isUndeducedType()) {
+      return new (Context) CXXNullPtrLiteralExpr(Context->NullPtrTy, record->getBeginLoc());
+    }
+
+    Compiler->getSema().MarkFunctionReferenced(record->getBeginLoc(), method);
+
+    auto* method_ref = DeclRefExpr::Create(
+      *Context,
+      NestedNameSpecifierLoc(),
+      SourceLocation(),
+      method,
+      false,
+      record->getBeginLoc(),
+      method->getType(),
+      VK_LValue
+    );
+
+    QualType pointer_type{};
+    if (method->isStatic()) {
+      pointer_type = Context->getPointerType(method->getType());
+    } else {
+#if LLVM_VERSION_MAJOR >= 21
+      pointer_type = Context->getMemberPointerType(method->getType(), nullptr, record);
+#else
+      pointer_type = Context->getMemberPointerType(method->getType(), record->getTypeForDecl());
+#endif
+    }
+
+    return UnaryOperator::Create(
+      *Context,
+      method_ref,
+      UO_AddrOf,
+      pointer_type,
+      VK_PRValue,
+      OK_Ordinary,
+      record->getBeginLoc(),
+      false,
+      FPOptionsOverride()
+    );
+  }
+
+  void add_method_pointers_decl(
+    CXXRecordDecl*                   type_info_record,
+    CXXRecordDecl*                   record,
+    const std::deque<CXXMethodDecl*>& methods,
+    const std::string&               identifier
+  ) {
+    std::deque<std::list<Expr*>> pointer_exprs{};
+    for (const auto& method: methods) {
+      pointer_exprs.push_back({make_method_pointer_expr(record, method)});
+    }
+
+    // Same shape as the metadata tuple: 'refl_tuple<R (C::*)(A...), ...>'
+    add_metadata_decl(type_info_record, pointer_exprs, identifier);
+  }
+
+  Expr* make_field_pointer_expr(CXXRecordDecl* record, FieldDecl* field) {
+    // Neither bit fields nor references can be pointed to by a pointer to member
+    if (record->isInStdNamespace() || field->isBitField() || field->getType()->isReferenceType()) {
+      return new (Context) CXXNullPtrLiteralExpr(Context->NullPtrTy, record->getBeginLoc());
+    }
+
+    auto* field_ref = DeclRefExpr::Create(
+      *Context,
+      NestedNameSpecifierLoc(),
+      SourceLocation(),
+      field,
+      false,
+      record->getBeginLoc(),
+      field->getType(),
+      VK_LValue
+    );
+
+#if LLVM_VERSION_MAJOR >= 21
+    QualType pointer_type = Context->getMemberPointerType(field->getType(), nullptr, record);
+#else
+    QualType pointer_type =
+      Context->getMemberPointerType(field->getType(), record->getTypeForDecl());
+#endif
+
+    return UnaryOperator::Create(
+      *Context,
+      field_ref,
+      UO_AddrOf,
+      pointer_type,
+      VK_PRValue,
+      OK_Ordinary,
+      record->getBeginLoc(),
+      false,
+      FPOptionsOverride()
+    );
+  }
+
+  void add_field_pointers_decl(
+    CXXRecordDecl*               type_info_record,
+    CXXRecordDecl*               record,
+    const std::deque<FieldDecl*>& fields,
+    const std::string&           identifier
+  ) {
+    std::deque<std::list<Expr*>> pointer_exprs{};
+    for (const auto& field: fields) {
+      pointer_exprs.push_back({make_field_pointer_expr(record, field)});
+    }
+
+    // Same shape as the metadata tuple: 'refl_tuple<F C::*, ...>'
+    add_metadata_decl(type_info_record, pointer_exprs, identifier);
+  }
+
   void add_type_info(CXXRecordDecl* record) {
     std::deque<std::string> field_names{};
     std::deque<uint64_t>    field_sizes{};
     std::deque<uint64_t>    field_offsets{};
     std::deque<uint64_t>    field_accesses{};
     std::deque<QualType>    field_types{};
+    std::deque<FieldDecl*>  field_decls{};
 
     std::deque<std::string> method_names{};
     std::deque<uint64_t>    method_accesses{};
     std::deque<QualType>    method_types{};
+    std::deque<CXXMethodDecl*> method_decls{};
 
     uint64_t                    last_metadata_offset = 0;
     std::deque<uint64_t>         field_metadata_offsets{};
@@ -362,6 +490,7 @@ public:
       field_offsets.push_back(offset);
       field_types.push_back(type);
       field_accesses.push_back(access);
+      field_decls.push_back(field);
       field_metadata_offsets.push_back(last_metadata_offset);
       field_metadata_counts.push_back(metadata_exprs.size());
       last_metadata_offset += metadata_exprs.size();
@@ -394,6 +523,7 @@ public:
       method_names.push_back(name);
       method_types.push_back(type);
       method_accesses.push_back(access);
+      method_decls.push_back(method);
     }
 
     IdentifierInfo& type_info_id     = Context->Idents.get("__type_info__");
@@ -417,12 +547,14 @@ public:
     add_metadata_decl(type_info_record, field_metadata_exprs, "field_metadata");
     add_integer_list(type_info_record, field_metadata_offsets, "field_metadata_offsets");
     add_integer_list(type_info_record, field_metadata_counts, "field_metadata_counts");
+    add_field_pointers_decl(type_info_record, record, field_decls, "field_pointers");
     //    }
 
     //    if (!method_names.empty()) {
     add_names_decl(type_info_record, method_names, "method_names");
     add_types_decl(type_info_record, method_types, "method_types");
     add_integer_list(type_info_record, method_accesses, "method_access_specifiers");
+    add_method_pointers_decl(type_info_record, record, method_decls, "method_pointers");
     //    }
 
     type_info_record->setAccess(AccessSpecifier::AS_public);
@@ -432,6 +564,49 @@ public:
   }
 
 
+  /// Appends the real layout of `record` to the report read by `cpp_reflect_layout_report`.
+  /// Unlike the type info this includes ignored fields. Bit fields are approximated by their
+  /// declared type.
+  void record_layout(CXXRecordDecl* record) {
+    if (layout_dir.empty() || record->isInvalidDecl() || record->isDependentType()) {
+      return;
+    }
+    const ASTRecordLayout& layout = Context->getASTRecordLayout(record);
+    llvm::raw_string_ostream out{layout_records};
+
+    out << "type\t" << Context->getRecordType(record).getAsString(Context->getPrintingPolicy())
+        << "\t" << layout.getSize().getQuantity() << "\t" << layout.getAlignment().getQuantity()
+        << "\n";
+    for (const auto& field: record->fields()) {
+      const auto type_info = Context->getTypeInfoInChars(field->getType());
+      out << "field\t" << field->getNameAsString() << "\t"
+          << (layout.getFieldOffset(field->getFieldIndex()) >> 3) << "\t"
+          << type_info.Width.getQuantity() << "\t" << type_info.Align.getQuantity() << "\n";
+    }
+  }
+
+  void HandleTranslationUnit(ASTContext& Ctx) override {
+    if (layout_dir.empty() || layout_records.empty()) {
+      return;
+    }
+    if (auto error = llvm::sys::fs::create_directories(layout_dir)) {
+      llvm::errs() << "[reflector] Cannot create '" << layout_dir << "': " << error.message()
+                   << "\n";
+      return;
+    }
+
+    // One file per translation unit, rewritten on every compilation of it
+    llvm::SmallString<256> path{layout_dir};
+    llvm::sys::path::append(path, llvm::utohexstr(llvm::hash_value(in_file)) + ".layout");
+    std::error_code      error{};
+    llvm::raw_fd_ostream file{path, error};
+    if (error) {
+      llvm::errs() << "[reflector] Cannot write '" << path << "': " << error.message() << "\n";
+      return;
+    }
+    file << layout_records;
+  }
+
   void HandleTagDeclDefinition(TagDecl* D) override {
     if (!module_usable && ((D->getOwningModule() == nullptr) ||
                            D->getOwningModule()->getPrimaryModuleInterfaceName() != "reflect")) {
@@ -446,6 +621,7 @@ public:
         return;
       }
       auto* record = dyn_cast<CXXRecordDecl>(D->getDefinition());
+      record_layout(record);
       add_type_info(record);
       // if (record->getName() == "test_one_field_struct") {
         // record->dumpColor();
@@ -511,6 +687,9 @@ private:
 private:
   CompilerInstance* Compiler;
   ASTContext*       Context;
+  std::string       in_file;
+  std::string       layout_dir;
+  std::string       layout_records{};
   bool              module_usable = false;
   Module*           refl_module   = nullptr;
 };
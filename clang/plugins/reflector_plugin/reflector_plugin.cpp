@@ -15,18 +15,29 @@ public:
     //     "\n";
     // }
     return std::unique_ptr<clang::ASTConsumer>(
-      std::make_unique<ReflectorASTConsumer>(&CI, &CI.getASTContext())
+      std::make_unique<ReflectorASTConsumer>(&CI, &CI.getASTContext(), InFile.str(), layout_dir)
     );
   }
 
 
+  /// `-fplugin-arg-reflector-layout-dir=<dir>` dumps the layout of every reflected type into
+  /// `<dir>`, see `reflect_layout_report()` in the top level CMakeLists.txt
   bool ParseArgs(const CompilerInstance& CI, const std::vector<std::string>& args) override {
+    static constexpr std::string_view layout_dir_arg = "layout-dir=";
+    for (const auto& arg: args) {
+      if (arg.starts_with(layout_dir_arg)) {
+        layout_dir = arg.substr(layout_dir_arg.size());
+      }
+    }
     return true;
   }
 
   ActionType getActionType() override {
     return ActionType::AddBeforeMainAction;
   }
+
+private:
+  std::string layout_dir{};
 };
 
 //-----------------------------------------------------------------------------
@@ -28,6 +28,16 @@ export namespace refl {
   };
 
   using type_id_t = std::size_t;
+
+  template <typename T>
+  struct is_std_array: std::false_type {};
+
+  template <typename T, std::size_t N>
+  struct is_std_array<std::array<T, N>>: std::true_type {};
+
+  /// Specialized by `soa_vector`, so layers below it can recognize one without importing it
+  template <typename T>
+  struct is_soa_vector: std::false_type {};
 } // namespace refl
 
 export {
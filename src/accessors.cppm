@@ -95,12 +95,28 @@ export namespace refl {
     template <typename MetadataType>
     static constexpr MetadataType get_metadata = find_metadata<MetadataType, 0>();
 
-    static const std::remove_reference_t<type>& from_instance(const T& instance) {
+    /// `&T::name`, or `std::nullptr_t` for bit fields and references
+    static constexpr auto pointer = std::get<I>(static_type_info<T>::field_pointers);
+    /// Whether the field can be read in constant expressions, through `pointer`
+    static constexpr bool is_addressable =
+      not std::is_null_pointer_v<std::remove_const_t<decltype(pointer)>>;
+
+    static constexpr const std::remove_reference_t<type>& from_instance(const T& instance) {
+      if constexpr (is_addressable) {
+        if consteval {
+          return instance.*pointer;
+        }
+      }
       const auto* rep = reinterpret_cast<const representation<type, offset>*>(&instance);
       return rep->value;
     }
 
-    static std::remove_reference_t<type>& from_instance(T& instance) {
+    static constexpr std::remove_reference_t<type>& from_instance(T& instance) {
+      if constexpr (is_addressable) {
+        if consteval {
+          return instance.*pointer;
+        }
+      }
       auto* rep = reinterpret_cast<representation<type, offset>*>(&instance);
       return rep->value;
     }
@@ -110,17 +126,104 @@ export namespace refl {
   constexpr std::size_t field_count =
     packtl::get_size<typename static_type_info<T>::field_types>::value;
 
+  /// String literal usable as a template argument, e.g. `where<"price">(...)`
+  template <std::size_t N>
+  struct field_name {
+    char value[N]{};
+
+    consteval field_name(const char (&str)[N]) {
+      std::copy_n(str, N, value);
+    }
+
+    constexpr std::string_view view() const {
+      return {value, N - 1};
+    }
+  };
+
+  namespace detail {
+    template <refl::Reflected T>
+    consteval std::size_t field_index_of(std::string_view name) {
+      return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        std::size_t index = sizeof...(I);
+        (void)((std::string_view{field<T, I>::name} == name ? (index = I, true) : false) or ...);
+        return index;
+      }(std::make_index_sequence<field_count<T>>{});
+    }
+  } // namespace detail
+
+  /// Index of the field called `Name` in `T`, or `field_count<T>` if there is none
+  template <refl::Reflected T, field_name Name>
+  constexpr std::size_t field_index = detail::field_index_of<T>(Name.view());
+
   template <refl::Reflected T, std::size_t I>
   constexpr decltype(std::get<I>(static_type_info<T>::field_metadata)) field_meta =
     std::get<I>(static_type_info<T>::field_metadata);
 
+  /// Decomposes the pointer types emitted into `method_pointers`. Entries the plugin could not
+  /// take the address of (constructors, destructors, implicit members) are `std::nullptr_t`.
+  template <typename P>
+  struct method_signature {
+    static constexpr bool is_addressable = false;
+    static constexpr bool is_static      = false;
+    static constexpr std::size_t arity   = 0;
+  };
+
+  template <typename R, typename... Args, bool NE>
+  struct method_signature<R (*)(Args...) noexcept(NE)> {
+    static constexpr bool is_addressable = true;
+    static constexpr bool is_static      = true;
+    static constexpr std::size_t arity   = sizeof...(Args);
+    using return_type = R;
+    using arg_types   = std::tuple<Args...>;
+  };
+
+  namespace detail {
+    template <typename R, typename Object, typename... Args>
+    struct member_method_signature {
+      static constexpr bool is_addressable = true;
+      static constexpr bool is_static      = false;
+      static constexpr std::size_t arity   = sizeof...(Args);
+      using return_type = R;
+      using object_ref  = Object;
+      using arg_types   = std::tuple<Args...>;
+    };
+  } // namespace detail
+
+  template <typename R, typename C, typename... Args, bool NE>
+  struct method_signature<R (C::*)(Args...) noexcept(NE)>
+      : detail::member_method_signature<R, C&, Args...> {};
+  template <typename R, typename C, typename... Args, bool NE>
+  struct method_signature<R (C::*)(Args...) const noexcept(NE)>
+      : detail::member_method_signature<R, const C&, Args...> {};
+  template <typename R, typename C, typename... Args, bool NE>
+  struct method_signature<R (C::*)(Args...) & noexcept(NE)>
+      : detail::member_method_signature<R, C&, Args...> {};
+  template <typename R, typename C, typename... Args, bool NE>
+  struct method_signature<R (C::*)(Args...) const & noexcept(NE)>
+      : detail::member_method_signature<R, const C&, Args...> {};
+  template <typename R, typename C, typename... Args, bool NE>
+  struct method_signature<R (C::*)(Args...) && noexcept(NE)>
+      : detail::member_method_signature<R, C&&, Args...> {};
+  template <typename R, typename C, typename... Args, bool NE>
+  struct method_signature<R (C::*)(Args...) const && noexcept(NE)>
+      : detail::member_method_signature<R, const C&&, Args...> {};
+
   template <refl::Reflected T, std::size_t I>
   struct method {
     static constexpr std::size_t index = I;
     static constexpr const char* name  = static_type_info<T>::method_names[I];
+    static constexpr std::uint64_t name_hash = detail::fnv1a(name);
     using type = typename packtl::get<I, typename static_type_info<T>::method_types>::type;
     static constexpr access_spec access =
       access_spec{packtl::get<I, typename static_type_info<T>::method_access_specifiers>::value};
+
+    static constexpr auto pointer = std::get<I>(static_type_info<T>::method_pointers);
+    using pointer_type = std::remove_const_t<decltype(pointer)>;
+    using signature    = method_signature<pointer_type>;
+
+    static constexpr bool is_addressable = signature::is_addressable;
+    static constexpr bool is_static      = signature::is_static;
+    static constexpr std::size_t arity   = signature::arity;
   };
 
   template <refl::Reflected T>
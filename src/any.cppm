@@ -11,6 +11,8 @@ export import :type_info;
 
 namespace refl {
   export class any {
+    friend struct method_info;
+
   private:
     template<typename T>
       requires (not std::same_as<std::remove_reference_t<T>, any>)
@@ -64,10 +66,7 @@ namespace refl {
     }
 
     static any make(const refl::type_info &t_info, void* ptr) {
-      any a { };
-      a.data_      = t_info.make_copy_of(ptr);
-      a.type_info_ = &t_info;
-      return a;
+      return adopt(t_info, t_info.make_copy_of(ptr));
     }
 
     ~any() {
@@ -76,23 +75,27 @@ namespace refl {
     }
 
     any(const any &other) {
+      data_      = nullptr;
       type_info_ = other.type_info_;
-      if (type_info_ != nullptr) {
+      if (type_info_ != nullptr and other.data_ != nullptr) {
         data_ = type_info_->make_copy_of(other.data_);
       }
-      destructor_ = other.destructor_;
+      destructor_ = copy_destructor(other);
     }
 
     any &operator=(const any &other) {
+      if (this == &other) {
+        return *this;
+      }
       if (data_ != nullptr) {
         destructor_(data_);
         data_ = nullptr;
       }
       type_info_ = other.type_info_;
-      if (type_info_ != nullptr) {
-        type_info_->assign_copy_of(other.data_, data_);
+      if (type_info_ != nullptr and other.data_ != nullptr) {
+        data_ = type_info_->make_copy_of(other.data_);
       }
-      destructor_ = other.destructor_;
+      destructor_ = copy_destructor(other);
       return *this;
     }
 
@@ -143,6 +146,45 @@ namespace refl {
       return type_info_ == other.type_info_ and type_info_->equality(data_, other.data_);
     }
 
+  private:
+    // Takes ownership of `ptr`, which must have been allocated with `new` as `t_info`'s type
+    static any adopt(const refl::type_info &t_info, void* ptr) {
+      any a { };
+      a.data_       = ptr;
+      a.destructor_ = [t = &t_info](void* p) {
+        if (p != nullptr) t->destroy(p);
+      };
+      a.type_info_  = &t_info;
+      return a;
+    }
+
+    // Takes ownership of the `t_info` object constructed in `storage`, which was allocated with
+    // `::operator new(size, alignment)`
+    static any adopt_constructed(
+      const refl::type_info &t_info, void* storage, std::size_t size, std::align_val_t alignment
+    ) {
+      any a { };
+      a.data_       = storage;
+      a.destructor_ = [t = &t_info, size, alignment](void* p) {
+        if (p != nullptr) {
+          t->destroy_at(p);
+          ::operator delete(p, size, alignment);
+        }
+      };
+      a.type_info_  = &t_info;
+      return a;
+    }
+
+    // Copies are made with `new`, whatever the storage of the original
+    static std::function<void(void*)> copy_destructor(const any &other) {
+      if (other.type_info_ == nullptr) {
+        return other.destructor_;
+      }
+      return [t = other.type_info_](void* p) {
+        if (p != nullptr) t->destroy(p);
+      };
+    }
+
   private:
     void* data_;
     [[refl::ignore]]
@@ -177,15 +219,13 @@ namespace refl {
     }
 
     any_ref(const refl::type_info &t_info, void* ptr) {
-      any_ref a { };
-      a.data_      = ptr;
-      a.type_info_ = &t_info;
+      data_      = ptr;
+      type_info_ = &t_info;
     }
 
     any_ref(refl::any &owner_any) {
-      any_ref a { };
-      a.data_      = owner_any.data();
-      a.type_info_ = &owner_any.type();
+      data_      = owner_any.data();
+      type_info_ = &owner_any.type();
     }
 
 
@@ -255,4 +295,56 @@ namespace refl {
     void* data_;
     const type_info* type_info_;
   };
+
+  any method_info::invoke(any_ref self, const any_ref* args, std::size_t count) const {
+    if (invoker == nullptr) {
+      throw std::runtime_error("Method is not invocable");
+    }
+    if (count != param_type_ids.size()) {
+      throw std::runtime_error("Wrong number of arguments for method invocation");
+    }
+
+    // Keep small calls off the heap
+    std::array<void*, 8> small_args{};
+    std::vector<void*>   large_args{};
+    void**               raw_args = small_args.data();
+    if (count > small_args.size()) {
+      large_args.resize(count);
+      raw_args = large_args.data();
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (args[i].is_null() or args[i].type().id() != param_type_ids[i]) {
+        throw std::bad_cast();
+      }
+      raw_args[i] = const_cast<void*>(args[i].data());
+    }
+
+    void* self_ptr = nullptr;
+    if (not is_static) {
+      if (self.is_null()) {
+        throw std::bad_cast();
+      }
+      self_ptr = self.data();
+    }
+
+    if (return_type == nullptr) {
+      invoker(self_ptr, raw_args, nullptr);
+      return any { };
+    }
+
+    const std::align_val_t alignment{result_alignment};
+    void*                  result = ::operator new(result_size, alignment);
+    try {
+      invoker(self_ptr, raw_args, result);
+    } catch (...) {
+      ::operator delete(result, result_size, alignment);
+      throw;
+    }
+    return any::adopt_constructed(return_type(), result, result_size, alignment);
+  }
+
+  any method_info::invoke(any_ref self, std::initializer_list<any_ref> args) const {
+    return invoke(self, args.begin(), args.size());
+  }
 }
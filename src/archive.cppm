@@ -33,6 +33,18 @@ namespace refl {
     bool contains(const std::string &path) const {
       return data_.contains(path);
     }
+
+    std::size_t size() const {
+      return data_.size();
+    }
+
+    auto begin() const {
+      return data_.begin();
+    }
+
+    auto end() const {
+      return data_.end();
+    }
   private:
     std::map<std::string, any> data_ { };
   };
@@ -0,0 +1,278 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  clone.cppm
+ *! \brief Deep copies of reflected values placed in a `std::pmr` memory resource.
+ *!
+ */
+
+export module reflect:clone;
+
+import std;
+
+import packtl;
+
+import :types;
+import :type_name;
+import :accessors;
+import :visitor;
+import :equality;
+
+export namespace refl {
+  /// Copy of `obj` built member by member, the same way `deep_eq` walks it. Every member whose
+  /// allocator can be made from a `std::pmr::memory_resource*` (`std::pmr::vector`,
+  /// `std::pmr::string`, `std::pmr::map`, ...) allocates from `arena`, all the way down, so a
+  /// `std::pmr::monotonic_buffer_resource` turns thousands of heap blocks into a few arena blocks
+  /// and tearing the clone down frees nothing.
+  ///
+  /// - Pointers follow `eq_policy`: `deep` ones (the default) point to a clone of their target
+  ///   placed in `arena`, whose destructor never runs, `shallow` ones keep the address and
+  ///   `skip` ones are null in the clone. `void*` always keeps the address.
+  /// - Objects reached through several `std::shared_ptr`, or several deep pointers, are cloned
+  ///   once and stay shared in the clone. Cloned `std::shared_ptr` targets live in `arena`.
+  /// - Cycles are followed through deep pointers, and through `std::shared_ptr` to reflected
+  ///   types that can be default constructed.
+  /// - `std::unique_ptr` targets are cloned on the heap, their deleter can't release arena memory.
+  /// - References are kept, as is everything else that is not a reflected type or a standard
+  ///   container.
+  ///
+  /// Targets are cloned as their static type. `arena` must outlive the clone.
+  template <Reflected R>
+  R deep_clone(const R& obj, std::pmr::memory_resource& arena);
+} // namespace refl
+
+namespace refl::deep_clone_impl {
+  /// Address and type of a cloned target. An object shares its address with its first member,
+  /// and an aliasing `std::shared_ptr` can point anywhere, so the address alone is not enough.
+  using target_key = std::pair<const void*, type_id_t>;
+
+  struct target_key_hash {
+    std::size_t operator()(const target_key& key) const {
+      return std::hash<const void*>{}(key.first) ^ key.second;
+    }
+  };
+
+  struct context {
+    std::pmr::memory_resource*                                             arena;
+    std::unordered_map<target_key, std::shared_ptr<void>, target_key_hash> shared{};
+    std::unordered_map<target_key, void*, target_key_hash>                 targets{};
+  };
+
+  /// Containers and strings that can allocate from the arena
+  template <typename T>
+  concept arena_aware = requires { typename T::allocator_type; } and
+                        std::constructible_from<typename T::allocator_type,
+                                                std::pmr::memory_resource*>;
+
+  template <typename T>
+  T clone_value(const T& value, context& ctx);
+
+  template <Reflected R>
+  void clone_into(const R& obj, R& out, context& ctx);
+
+  template <Reflected R>
+  R clone_fields(const R& obj, context& ctx);
+
+  /// Empty container allocating from the arena when it can
+  template <typename T>
+  T make_empty(context& ctx) {
+    if constexpr (arena_aware<T>) {
+      return T(typename T::allocator_type{ctx.arena});
+    } else {
+      return T{};
+    }
+  }
+
+  /// Elements that are copied as they are, so whole ranges can be copied at once
+  template <typename T>
+  constexpr bool is_plain = std::is_trivially_copyable_v<T>;
+
+  template <typename T>
+  T clone_sequence(const T& range, context& ctx) {
+    using E = typename T::value_type;
+    if constexpr (is_plain<E>) {
+      if constexpr (arena_aware<T>) {
+        return T(range, typename T::allocator_type{ctx.arena});
+      } else {
+        return range;
+      }
+    } else {
+      T out = make_empty<T>(ctx);
+      if constexpr (requires { out.reserve(range.size()); }) {
+        out.reserve(range.size());
+      }
+      for (const E& element: range) {
+        out.push_back(clone_value(element, ctx));
+      }
+      return out;
+    }
+  }
+
+  template <typename T>
+  T clone_associative(const T& range, context& ctx) {
+    T out = make_empty<T>(ctx);
+    if constexpr (requires { out.reserve(range.size()); }) {
+      out.reserve(range.size());
+    }
+    for (const auto& element: range) {
+      if constexpr (requires { typename T::mapped_type; }) {
+        out.emplace(clone_value(element.first, ctx), clone_value(element.second, ctx));
+      } else {
+        out.emplace(clone_value(element, ctx));
+      }
+    }
+    return out;
+  }
+
+  /// Clone of `*ptr` in the arena, shared with every other pointer to the same object
+  template <typename E>
+  E* clone_target(const E* ptr, context& ctx) {
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    const target_key key{ptr, type_id<E>};
+    if (auto it = ctx.targets.find(key); it != ctx.targets.end()) {
+      return static_cast<E*>(it->second);
+    }
+    // Registered before its members are cloned, so cycles lead back to it
+    std::pmr::polymorphic_allocator<> allocator{ctx.arena};
+    E*                                clone = allocator.allocate_object<E>();
+    ctx.targets.emplace(key, clone);
+    std::construct_at(clone, clone_value(*ptr, ctx));
+    return clone;
+  }
+
+  template <typename S>
+  S clone_shared(const S& ptr, context& ctx) {
+    using E = std::remove_cv_t<typename S::element_type>;
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    const target_key key{ptr.get(), type_id<E>};
+    if (auto it = ctx.shared.find(key); it != ctx.shared.end()) {
+      return std::static_pointer_cast<E>(it->second);
+    }
+    const std::pmr::polymorphic_allocator<E> allocator{ctx.arena};
+    if constexpr (Reflected<E> and std::default_initializable<E>) {
+      // Registered before its members are cloned, so cycles lead back to it
+      auto clone = std::allocate_shared<E>(allocator);
+      ctx.shared.emplace(key, clone);
+      clone_into<E>(*ptr, *clone, ctx);
+      return clone;
+    } else {
+      auto clone = std::allocate_shared<E>(allocator, clone_value<E>(*ptr, ctx));
+      ctx.shared.emplace(key, clone);
+      return clone;
+    }
+  }
+
+  template <typename T>
+  T clone_value(const T& value, context& ctx) {
+    if constexpr (packtl::is_type<std::basic_string, T>::value) {
+      if constexpr (arena_aware<T>) {
+        return T(value, typename T::allocator_type{ctx.arena});
+      } else {
+        return value;
+      }
+    } else if constexpr (packtl::is_type<std::vector, T>::value or
+                         packtl::is_type<std::deque, T>::value or
+                         packtl::is_type<std::list, T>::value) {
+      return clone_sequence(value, ctx);
+    } else if constexpr (packtl::is_type<std::map, T>::value or
+                         packtl::is_type<std::unordered_map, T>::value or
+                         packtl::is_type<std::set, T>::value or
+                         packtl::is_type<std::unordered_set, T>::value) {
+      return clone_associative(value, ctx);
+    } else if constexpr (is_std_array<T>::value) {
+      if constexpr (is_plain<typename T::value_type>) {
+        return value;
+      } else {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+          return T{clone_value(value[I], ctx)...};
+        }(std::make_index_sequence<std::tuple_size_v<T>>{});
+      }
+    } else if constexpr (packtl::is_type<std::pair, T>::value) {
+      return T(clone_value(value.first, ctx), clone_value(value.second, ctx));
+    } else if constexpr (packtl::is_type<std::tuple, T>::value) {
+      return std::apply(
+        [&](const auto&... elements) {
+          return T(clone_value(elements, ctx)...);
+        },
+        value
+      );
+    } else if constexpr (packtl::is_type<std::optional, T>::value) {
+      return value.has_value() ? T(std::in_place, clone_value(*value, ctx)) : T{};
+    } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
+      return clone_shared(value, ctx);
+    } else if constexpr (packtl::is_type<std::unique_ptr, T>::value) {
+      using E = typename T::element_type;
+      return value == nullptr ? T{} : std::make_unique<E>(clone_value(*value, ctx));
+    } else if constexpr (Reflected<T>) {
+      return clone_fields(value, ctx);
+    } else {
+      return value;
+    }
+  }
+
+  template <Reflected R, typename Field>
+  void clone_field(const R& obj, R& out, context& ctx) {
+    if constexpr (not Field::is_reference) {
+      using field_type  = typename Field::type;
+      const auto& value = Field::from_instance(obj);
+      auto&       dest  = Field::from_instance(out);
+
+      eq_policy::policy_e policy{eq_policy::deep};
+      if constexpr (Field::template has_metadata<eq_policy::policy_e>) {
+        policy = Field::template get_metadata<eq_policy::policy_e>;
+      }
+
+      if constexpr (Field::is_pointer) {
+        using pointee = std::remove_cv_t<std::remove_pointer_t<field_type>>;
+        if constexpr (std::is_void_v<pointee>) {
+          dest = value;
+        } else if (policy == eq_policy::deep) {
+          dest = clone_target<pointee>(value, ctx);
+        } else if (policy == eq_policy::shallow) {
+          dest = value;
+        } else {
+          dest = nullptr;
+        }
+      } else {
+        // Rebuilt in place rather than assigned, assigning would keep the allocator `out` was
+        // made with instead of the arena
+        field_type clone = clone_value(value, ctx);
+        std::destroy_at(&dest);
+        std::construct_at(&dest, std::move(clone));
+      }
+    }
+  }
+
+  template <Reflected R>
+  void clone_into(const R& obj, R& out, context& ctx) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (clone_field<R, field<R, I>>(obj, out, ctx), ...);
+    }(std::make_index_sequence<field_count<R>>{});
+  }
+
+  template <Reflected R>
+  R clone_fields(const R& obj, context& ctx) {
+    // Types that can't be default constructed are copied first, so references are kept
+    R out = [&] {
+      if constexpr (std::default_initializable<R>) {
+        return R{};
+      } else {
+        return R(obj);
+      }
+    }();
+    clone_into(obj, out, ctx);
+    return out;
+  }
+} // namespace refl::deep_clone_impl
+
+namespace refl {
+  template <Reflected R>
+  R deep_clone(const R& obj, std::pmr::memory_resource& arena) {
+    deep_clone_impl::context ctx{&arena};
+    return deep_clone_impl::clone_fields(obj, ctx);
+  }
+} // namespace refl
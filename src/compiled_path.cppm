@@ -0,0 +1,302 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  compiled_path.cppm
+ *! \brief Dotted member paths resolved once into folded offsets.
+ *!
+ */
+
+export module reflect:compiled_path;
+
+import std;
+
+import :types;
+import :accessors;
+import :type_info;
+
+export namespace refl {
+  /// Adds `offset` to the running address, then loads the pointer stored there if `deref` is set
+  struct path_step {
+    std::size_t offset = 0;
+    bool        deref  = false;
+
+    constexpr bool operator==(const path_step&) const = default;
+  };
+
+  /// A member path such as `"server.tls.port"` resolved against a root type. Consecutive plain
+  /// members fold into a single offset, so only reference members and pointers that are walked
+  /// through cost a step at runtime. A path without indirections is one addition.
+  ///
+  /// Reference members are always followed. A pointer member is followed when the path continues
+  /// past it, a path ending on a pointer member designates the pointer itself.
+  class compiled_path {
+  public:
+    static constexpr std::size_t inline_steps = 4;
+
+    /// Resolves `path` against `root` through its `type_info` field tables. Throws
+    /// `std::invalid_argument` for unknown members and for descending into a type without fields.
+    static compiled_path parse(const type_info& root, std::string_view path) {
+      compiled_path result{root};
+      const type_info* current = &root;
+      std::size_t      pending = 0;
+
+      while (true) {
+        const auto dot     = path.find('.');
+        const auto name    = path.substr(0, dot);
+        const bool is_last = dot == std::string_view::npos;
+        const auto field   = current->field_by_name(std::string{name});
+        if (not field.has_value()) {
+          throw std::invalid_argument(
+            std::format("'{}' has no member named '{}'", current->name(), name)
+          );
+        }
+
+        const field_info& info = *field.value();
+        pending += info.offset;
+        current = &info.type();
+        if (info.is_reference or (info.is_pointer and not is_last)) {
+          result.push({pending, true});
+          pending = 0;
+          if (info.is_pointer) {
+            current = &current->indirect_type();
+          }
+        }
+
+        if (is_last) {
+          break;
+        }
+        path.remove_prefix(dot + 1);
+      }
+
+      result.push({pending, false});
+      result.type_ = current;
+      result.rehash();
+      return result;
+    }
+
+    /// Path made of already resolved steps, see `compile_path<T, Path>()`
+    template <std::size_t N>
+    compiled_path(
+      const type_info&                root,
+      const type_info&                type,
+      const std::array<path_step, N>& steps,
+      std::size_t                     count
+    )
+        : root_(&root),
+          type_(&type) {
+      for (std::size_t i = 0; i < count; ++i) {
+        push(steps[i]);
+      }
+      rehash();
+    }
+
+    const type_info& root_type() const {
+      return *root_;
+    }
+
+    const type_info& type() const {
+      return *type_;
+    }
+
+    std::span<const path_step> steps() const {
+      return {heap_.empty() ? inline_.data() : heap_.data(), count_};
+    }
+
+    /// True when the path is a single constant offset from the root
+    bool is_direct() const {
+      return count_ == 1;
+    }
+
+    /// Address of the member inside `obj`, or null if a null pointer was walked through
+    void* get_ptr(void* obj) const {
+      auto* ptr = static_cast<char*>(obj);
+      for (const auto& step: steps()) {
+        ptr += step.offset;
+        if (step.deref) {
+          ptr = *reinterpret_cast<char**>(ptr);
+          if (ptr == nullptr) {
+            return nullptr;
+          }
+        }
+      }
+      return ptr;
+    }
+
+    const void* get_ptr(const void* obj) const {
+      return get_ptr(const_cast<void*>(obj));
+    }
+
+    template <typename T>
+    T& get_ref(void* obj) const {
+      void* ptr = get_ptr(obj);
+      if (ptr == nullptr) {
+        throw std::runtime_error("Field path walks through a null pointer");
+      }
+      return *static_cast<T*>(ptr);
+    }
+
+    std::size_t hash() const {
+      return hash_;
+    }
+
+    bool operator==(const compiled_path& other) const {
+      return hash_ == other.hash_ and root_ == other.root_ and
+             std::ranges::equal(steps(), other.steps());
+    }
+
+  private:
+    explicit compiled_path(const type_info& root)
+        : root_(&root),
+          type_(&root) {}
+
+    void push(path_step step) {
+      if (count_ < inline_steps) {
+        inline_[count_] = step;
+      } else {
+        if (heap_.empty()) {
+          heap_.assign(inline_.begin(), inline_.end());
+        }
+        heap_.push_back(step);
+      }
+      ++count_;
+    }
+
+    void rehash() {
+      std::size_t seed = root_->id();
+      for (const auto& step: steps()) {
+        const std::size_t value = step.offset << 1 | static_cast<std::size_t>(step.deref);
+        seed ^= std::hash<std::size_t>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+      hash_ = seed;
+    }
+
+  private:
+    const type_info*                    root_;
+    const type_info*                    type_;
+    std::array<path_step, inline_steps> inline_{};
+    std::vector<path_step>              heap_{};
+    std::size_t                         count_ = 0;
+    std::size_t                         hash_  = 0;
+  };
+} // namespace refl
+
+namespace refl::detail {
+  template <std::size_t N>
+  struct static_steps {
+    std::array<path_step, N> steps{};
+    std::size_t              count   = 0;
+    std::size_t              pending = 0;
+
+    constexpr void push(path_step step) {
+      steps[count++] = step;
+    }
+  };
+
+  /// Compile time counterpart of `compiled_path::parse`, one instantiation per path segment
+  template <typename T, field_name Path, std::size_t Start>
+  struct static_path {
+    static constexpr std::string_view rest    = Path.view().substr(Start);
+    static constexpr std::size_t      dot     = rest.find('.');
+    static constexpr bool             is_last = dot == std::string_view::npos;
+    static constexpr std::size_t      index   = field_index_of<T>(rest.substr(0, dot));
+    static_assert(index < field_count<T>, "no member with that name");
+
+    using field_t  = field<T, index>;
+    using member_t = std::remove_cvref_t<typename field_t::type>;
+
+    static constexpr bool walks_pointer = field_t::is_pointer and not is_last;
+    static constexpr bool deref         = field_t::is_reference or walks_pointer;
+
+    using next_t = std::remove_cv_t<
+      std::conditional_t<walks_pointer, std::remove_pointer_t<member_t>, member_t>>;
+
+    static constexpr std::size_t depth() {
+      if constexpr (is_last) {
+        return 1;
+      } else {
+        return 1 + static_path<next_t, Path, Start + dot + 1>::depth();
+      }
+    }
+
+    static consteval auto leaf() {
+      if constexpr (is_last) {
+        return std::type_identity<next_t>{};
+      } else {
+        return static_path<next_t, Path, Start + dot + 1>::leaf();
+      }
+    }
+
+    template <std::size_t N>
+    static constexpr void append(static_steps<N>& acc) {
+      acc.pending += field_t::offset;
+      if (deref) {
+        acc.push({acc.pending, true});
+        acc.pending = 0;
+      }
+      if constexpr (not is_last) {
+        static_path<next_t, Path, Start + dot + 1>::append(acc);
+      }
+    }
+  };
+
+  template <typename T, field_name Path>
+  constexpr auto static_path_steps = [] {
+    using path_t = static_path<T, Path, 0>;
+    static_steps<path_t::depth() + 1> acc{};
+    path_t::append(acc);
+    acc.push({acc.pending, false});
+    return acc;
+  }();
+
+  struct path_cache_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view path) const {
+      return std::hash<std::string_view>{}(path);
+    }
+  };
+} // namespace refl::detail
+
+export namespace refl {
+  /// Type of the member `Path` designates, e.g. `path_type<config, "server.tls.port">`
+  template <Reflected T, field_name Path>
+  using path_type = typename decltype(detail::static_path<T, Path, 0>::leaf())::type;
+
+  /// Resolves `Path` at compile time, e.g. `compile_path<config, "server.tls.port">()`
+  template <Reflected T, field_name Path>
+  const compiled_path& compile_path() {
+    using leaf_t         = path_type<T, Path>;
+    constexpr auto steps = detail::static_path_steps<T, Path>;
+    static const compiled_path path{
+      type_info::from<T>(), type_info::from<leaf_t>(), steps.steps, steps.count
+    };
+    return path;
+  }
+
+  /// Resolves `path` at runtime, each distinct string is only parsed once per `T`
+  template <Reflected T>
+  const compiled_path& compile_path(std::string_view path) {
+    using cache_t =
+      std::unordered_map<std::string, compiled_path, detail::path_cache_hash, std::equal_to<>>;
+    static cache_t           cache{};
+    static std::shared_mutex mutex{};
+
+    {
+      std::shared_lock lock{mutex};
+      if (auto it = cache.find(path); it != cache.end()) {
+        return it->second;
+      }
+    }
+
+    auto compiled = compiled_path::parse(type_info::from<T>(), path);
+    std::unique_lock lock{mutex};
+    return cache.try_emplace(std::string{path}, std::move(compiled)).first->second;
+  }
+} // namespace refl
+
+export template <>
+struct std::hash<refl::compiled_path> {
+  std::size_t operator()(const refl::compiled_path& path) const {
+    return path.hash();
+  }
+};
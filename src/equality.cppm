@@ -14,6 +14,8 @@ import packtl;
 
 import :types;
 import :accessors;
+import :instrumentation;
+import :parallel;
 
 export namespace refl::eq_policy {
   enum policy_e {
@@ -26,6 +28,12 @@ export namespace refl::eq_policy {
 export namespace refl {
   template<Reflected R>
   bool deep_eq(const R &lhs, const R &rhs);
+
+  /// `deep_eq` spread over several threads. The comparison is cut into tasks up front: one per
+  /// member, descending into reflected members, and one per chunk of large vectors and deques.
+  /// The first task to find a difference tells the others to stop.
+  template<Reflected R>
+  bool deep_eq(const R &lhs, const R &rhs, const parallel_policy &policy);
 }
 
 namespace refl::deep_eq_impl {
@@ -174,6 +182,79 @@ namespace refl::deep_eq_impl {
 
     return false;
   }
+
+  //! Parallel comparison, `tasks` is stopped as soon as a difference is found
+
+  template<Reflected R>
+  void plan_fields_eq(const R &lhs, const R &rhs, parallel_impl::task_list &tasks);
+
+  template<typename T>
+  void plan_eq(const T &lhs, const T &rhs, parallel_impl::task_list &tasks) {
+    if constexpr (packtl::is_type<std::vector, T>::value or packtl::is_type<std::deque, T>::value) {
+      using E = typename T::value_type;
+
+      if (lhs.size() != rhs.size()) {
+        tasks.stop();
+        return;
+      }
+      if (lhs.size() > tasks.policy().min_chunk) {
+        tasks.add_chunks(lhs.size(), tasks.policy().min_chunk,
+          [&lhs, &rhs, &tasks](std::size_t begin, std::size_t end) {
+            // Polling every element would cost more than comparing simple ones
+            static constexpr std::size_t poll_interval = 1024;
+            for (std::size_t i = begin; i < end; ++i) {
+              if ((i - begin) % poll_interval == 0 and tasks.stopped()) {
+                return;
+              }
+              if (not ref_eq<E>(lhs[i], rhs[i])) {
+                tasks.stop();
+                return;
+              }
+            }
+          });
+        return;
+      }
+    } else if constexpr (Reflected<T> and not std::equality_comparable<T>) {
+      // Same precedence as `ref_eq`, a type's own `operator==` is used as a whole
+      plan_fields_eq(lhs, rhs, tasks);
+      return;
+    }
+
+    tasks.add([&lhs, &rhs, &tasks] {
+      if (not ref_eq<T>(lhs, rhs)) {
+        tasks.stop();
+      }
+    });
+  }
+
+  template<Reflected R, typename field_data>
+  void plan_field_eq(const R &lhs, const R &rhs, parallel_impl::task_list &tasks) {
+    if constexpr (field_data::template has_metadata<eq_policy::policy_e>) {
+      if constexpr (field_data::template get_metadata<eq_policy::policy_e> == eq_policy::skip) {
+        return;
+      }
+    }
+
+    if constexpr (field_data::is_reference or field_data::is_pointer) {
+      tasks.add([&lhs, &rhs, &tasks] {
+        if (not field_eq<R, field_data>(lhs, rhs)) {
+          tasks.stop();
+        }
+      });
+    } else {
+      using field_type = typename field_data::type;
+      plan_eq<field_type>(
+        field_data::from_instance(lhs), field_data::from_instance(rhs), tasks
+      );
+    }
+  }
+
+  template<Reflected R>
+  void plan_fields_eq(const R &lhs, const R &rhs, parallel_impl::task_list &tasks) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (plan_field_eq<R, field<R, I>>(lhs, rhs, tasks), ...);
+    }(std::make_index_sequence<field_count<R>> { });
+  }
 } // namespace refl::deep_eq_impl
 
 namespace refl {
@@ -181,10 +262,26 @@ namespace refl {
   bool deep_eq(const R &lhs, const R &rhs) {
     static constexpr auto count = field_count<R>;
 
+    using instrumentation::operation;
     auto impl = [&]<std::size_t... I>(std::index_sequence<I...>) {
-      return ((deep_eq_impl::field_eq<R, field<R, I>>(lhs, rhs)) && ...);
+      return (instrumentation::probe<operation::compare, R, field<R, I>>([&] {
+        return deep_eq_impl::field_eq<R, field<R, I>>(lhs, rhs);
+      }) && ...);
     };
 
-    return impl(std::make_index_sequence<count> { });
+    return instrumentation::probe<operation::compare, R>([&] {
+      return impl(std::make_index_sequence<count> { });
+    });
+  }
+
+  template<Reflected R>
+  bool deep_eq(const R &lhs, const R &rhs, const parallel_policy &policy) {
+    parallel_impl::task_list tasks {policy};
+    deep_eq_impl::plan_fields_eq(lhs, rhs, tasks);
+    if (tasks.stopped()) {
+      return false;
+    }
+    tasks.run();
+    return not tasks.stopped();
   }
 }
@@ -0,0 +1,413 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  generate.cppm
+ *! \brief Deterministic synthetic values of reflected types, for benchmarks and fuzzing.
+ *!
+ */
+
+export module reflect:generate;
+
+import std;
+
+import packtl;
+
+import :types;
+import :accessors;
+import :visitor;
+import :parallel;
+
+export namespace refl::gen {
+  /// Field annotations shaping what `refl::generate` produces, e.g.
+  ///
+  ///   [[meta(refl::gen::length{4, 16})]] std::string name;
+  ///   [[meta(refl::gen::count{0, 100})]] std::vector<sample> samples;
+  ///   [[meta(refl::gen::range{-1.0, 1.0})]] double weight;
+  ///
+  /// `length` and `range` also apply to strings and numbers nested in containers of the field,
+  /// `count` only to the outermost container. Bounds are inclusive.
+  struct length {
+    std::size_t min = 0;
+    std::size_t max = 0;
+  };
+
+  struct count {
+    std::size_t min = 0;
+    std::size_t max = 0;
+  };
+
+  struct range {
+    double min = 0.0;
+    double max = 0.0;
+  };
+
+  /// `skip` leaves the field as its default member initializer made it
+  enum policy_e {
+    fill,
+    skip
+  };
+
+  /// Small and fast 64 bit generator, a good default for `refl::generate`. Unlike the standard
+  /// distributions, everything built on it produces the same values on every platform.
+  class splitmix64 {
+  public:
+    using result_type = std::uint64_t;
+
+    explicit constexpr splitmix64(std::uint64_t seed = 0)
+        : state_(seed) {}
+
+    static constexpr result_type min() {
+      return 0;
+    }
+
+    static constexpr result_type max() {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    constexpr result_type operator()() {
+      return mix(state_ += 0x9e3779b97f4a7c15);
+    }
+
+    static constexpr std::uint64_t mix(std::uint64_t z) {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      return z ^ (z >> 31);
+    }
+
+  private:
+    std::uint64_t state_;
+  };
+} // namespace refl::gen
+
+export namespace refl {
+  struct generate_options {
+    /// Largest string length and container size, unless annotated otherwise
+    std::size_t size_hint = 8;
+    /// Containers, optionals and smart pointers nested deeper than this are left empty, which
+    /// bounds the output of recursive types
+    std::size_t max_depth = 4;
+    /// Threads used by `generate_n`, `0` uses every hardware thread
+    std::size_t threads = 0;
+  };
+} // namespace refl
+
+namespace refl::generate_impl {
+  /// Annotations in effect for the value being generated
+  struct constraints {
+    std::optional<gen::length> length{};
+    std::optional<gen::count>  count{};
+    std::optional<gen::range>  range{};
+
+    template <typename Field>
+    static constexpr constraints of() {
+      constraints result{};
+      if constexpr (Field::template has_metadata<gen::length>) {
+        result.length = Field::template get_metadata<gen::length>;
+      }
+      if constexpr (Field::template has_metadata<gen::count>) {
+        result.count = Field::template get_metadata<gen::count>;
+      }
+      if constexpr (Field::template has_metadata<gen::range>) {
+        result.range = Field::template get_metadata<gen::range>;
+      }
+      return result;
+    }
+
+    constexpr constraints nested() const {
+      return {length, std::nullopt, range};
+    }
+  };
+
+  template <typename C>
+  concept associative = requires { typename C::key_type; };
+
+  template <typename C>
+  concept keyed = associative<C> and requires { typename C::mapped_type; };
+
+  template <typename C>
+  concept back_insertable = requires(C container, typename C::value_type value) {
+    container.push_back(std::move(value));
+  };
+
+  template <typename C>
+  concept front_insertable = requires(C container, typename C::value_type value) {
+    container.push_front(std::move(value));
+  };
+
+  template <typename C>
+  concept growable = keyed<C> or associative<C> or back_insertable<C> or front_insertable<C>;
+
+  inline constexpr std::string_view alphabet =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+  template <typename RNG>
+  class generator {
+    static_assert(
+      RNG::min() == 0 and RNG::max() == std::numeric_limits<std::uint64_t>::max(),
+      "refl::generate needs a generator of full 64 bit words, e.g. refl::gen::splitmix64"
+    );
+
+  public:
+    generator(RNG& rng, const generate_options& options)
+        : rng_(rng),
+          options_(options) {}
+
+    template <typename T>
+    void fill(T& value, const constraints& limits) {
+      if constexpr (std::same_as<T, bool>) {
+        value = (rng_() >> 63) != 0;
+      } else if constexpr (std::is_integral_v<T>) {
+        value = limits.range.has_value() ? integer<T>(
+                                             static_cast<T>(limits.range->min),
+                                             static_cast<T>(limits.range->max)
+                                           )
+                                         : integer<T>(
+                                             std::numeric_limits<T>::min(),
+                                             std::numeric_limits<T>::max()
+                                           );
+      } else if constexpr (std::is_floating_point_v<T>) {
+        const gen::range bounds = limits.range.value_or(gen::range{-1e6, 1e6});
+        value = static_cast<T>(bounds.min + (bounds.max - bounds.min) * unit());
+      } else if constexpr (std::is_enum_v<T>) {
+        // Without a range there is no telling which values are valid
+        if (limits.range.has_value()) {
+          std::underlying_type_t<T> underlying{};
+          fill(underlying, limits);
+          value = static_cast<T>(underlying);
+        }
+      } else if constexpr (packtl::is_type<std::basic_string, T>::value) {
+        fill_string(value, limits);
+      } else if constexpr (packtl::is_type<std::optional, T>::value) {
+        if (nest_allowed() and (rng_() >> 63) != 0) {
+          nested guard{depth_};
+          fill(value.emplace(), limits.nested());
+        }
+      } else if constexpr (packtl::is_type<std::unique_ptr, T>::value or
+                           packtl::is_type<std::shared_ptr, T>::value) {
+        fill_pointer(value, limits);
+      } else if constexpr (packtl::is_type<std::variant, T>::value) {
+        fill_variant(value, limits);
+      } else if constexpr (packtl::is_type<std::pair, T>::value) {
+        fill(value.first, limits);
+        fill(value.second, limits);
+      } else if constexpr (packtl::is_type<std::tuple, T>::value) {
+        std::apply([&](auto&... items) { (fill(items, limits), ...); }, value);
+      } else if constexpr (std::is_array_v<T> or is_std_array<T>::value) {
+        for (auto& item: value) {
+          fill(item, limits);
+        }
+      } else if constexpr (Reflected<T>) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (fill_field<T, field<T, I>>(value), ...);
+        }(std::make_index_sequence<field_count<T>>{});
+      } else if constexpr (growable<T>) {
+        fill_container(value, limits);
+      } else {
+        // Opaque: raw pointers, std::function, adaptors... keep their default value
+      }
+    }
+
+  private:
+    /// Depth of the containers, optionals and pointers being filled, restored on scope exit
+    struct nested {
+      explicit nested(std::size_t& counter)
+          : depth(counter) {
+        ++depth;
+      }
+
+      ~nested() {
+        --depth;
+      }
+
+      std::size_t& depth;
+    };
+
+    bool nest_allowed() const {
+      return depth_ < options_.max_depth;
+    }
+
+    /// Uniform in `[0, bound)`, any 64 bit word when `bound` is 0
+    std::uint64_t below(std::uint64_t bound) {
+      return bound == 0 ? rng_() : rng_() % bound;
+    }
+
+    /// Uniform in `[0, 1)`
+    double unit() {
+      return static_cast<double>(rng_() >> 11) * 0x1p-53;
+    }
+
+    template <typename I>
+    I integer(I min, I max) {
+      using U = std::make_unsigned_t<I>;
+      if (max < min) {
+        std::swap(min, max);
+      }
+      const U             width = static_cast<U>(static_cast<U>(max) - static_cast<U>(min));
+      const std::uint64_t span  = static_cast<std::uint64_t>(width) + 1;
+      return static_cast<I>(static_cast<U>(static_cast<U>(min) + static_cast<U>(below(span))));
+    }
+
+    std::size_t size(const std::optional<gen::length>& length) {
+      const auto [min, max] = length.value_or(gen::length{0, options_.size_hint});
+      return integer<std::size_t>(min, max);
+    }
+
+    std::size_t size(const std::optional<gen::count>& count) {
+      const auto [min, max] = count.value_or(gen::count{0, options_.size_hint});
+      return integer<std::size_t>(min, max);
+    }
+
+    template <typename S>
+    void fill_string(S& str, const constraints& limits) {
+      using char_type  = typename S::value_type;
+      const auto count = size(limits.length);
+      str.clear();
+      str.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        str.push_back(static_cast<char_type>(alphabet[below(alphabet.size())]));
+      }
+    }
+
+    template <typename C>
+    void fill_container(C& container, const constraints& limits) {
+      container.clear();
+      if (not nest_allowed()) {
+        return;
+      }
+      nested     guard{depth_};
+      const auto count = size(limits.count);
+      const auto inner = limits.nested();
+      if constexpr (requires { container.reserve(count); }) {
+        container.reserve(count);
+      }
+      // Keys that come up twice collapse, associative containers may end up smaller
+      for (std::size_t i = 0; i < count; ++i) {
+        if constexpr (keyed<C>) {
+          typename C::key_type    key{};
+          typename C::mapped_type mapped{};
+          fill(key, inner);
+          fill(mapped, inner);
+          container.emplace(std::move(key), std::move(mapped));
+        } else {
+          typename C::value_type item{};
+          fill(item, inner);
+          if constexpr (associative<C>) {
+            container.insert(std::move(item));
+          } else if constexpr (back_insertable<C>) {
+            container.push_back(std::move(item));
+          } else {
+            container.push_front(std::move(item));
+          }
+        }
+      }
+    }
+
+    template <typename P>
+    void fill_pointer(P& ptr, const constraints& limits) {
+      using element_type = typename P::element_type;
+      // Arrays and abstract bases have no single obvious value to make
+      if constexpr (std::is_array_v<element_type> or
+                    not std::is_default_constructible_v<element_type>) {
+        return;
+      } else {
+        if (not nest_allowed()) {
+          return;
+        }
+        nested guard{depth_};
+        if constexpr (packtl::is_type<std::unique_ptr, P>::value) {
+          ptr = std::make_unique<element_type>();
+        } else {
+          ptr = std::make_shared<element_type>();
+        }
+        fill(*ptr, limits.nested());
+      }
+    }
+
+    template <typename V>
+    void fill_variant(V& value, const constraints& limits) {
+      constexpr std::size_t alternatives = std::variant_size_v<V>;
+      const std::size_t     index        = below(alternatives);
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (void)((index == I ? (fill(value.template emplace<I>(), limits), true) : false) or ...);
+      }(std::make_index_sequence<alternatives>{});
+    }
+
+    template <Reflected R, typename Field>
+    void fill_field(R& obj) {
+      using value_type = std::remove_reference_t<typename Field::type>;
+      if constexpr (Field::is_reference or Field::is_pointer or std::is_const_v<value_type>) {
+        // Borrowed or immutable, nothing to fill
+        return;
+      } else {
+        gen::policy_e policy{gen::fill};
+        if constexpr (Field::template has_metadata<gen::policy_e>) {
+          policy = Field::template get_metadata<gen::policy_e>;
+        }
+        if (policy == gen::skip) {
+          return;
+        }
+        fill(Field::from_instance(obj), constraints::of<Field>());
+      }
+    }
+
+  private:
+    RNG&                    rng_;
+    const generate_options& options_;
+    std::size_t             depth_ = 0;
+  };
+
+  /// Seed of element `index` of a `generate_n` dataset, independent of how it is split
+  constexpr std::uint64_t element_seed(std::uint64_t seed, std::size_t index) {
+    return gen::splitmix64::mix(seed ^ gen::splitmix64::mix(static_cast<std::uint64_t>(index)));
+  }
+} // namespace refl::generate_impl
+
+export namespace refl {
+  /// A value of `T` with every field filled in from `rng`: numbers across their whole range,
+  /// strings of `[a-zA-Z0-9]`, containers, optionals, variants, smart pointers and nested
+  /// reflected types. Raw pointers, references, const fields and enums without a `gen::range`
+  /// keep their default value. The same generator state always produces the same value.
+  template <typename T, typename RNG>
+    requires std::default_initializable<T>
+  T generate(RNG& rng, const generate_options& options) {
+    T                             value{};
+    generate_impl::generator<RNG> generator{rng, options};
+    generator.fill(value, generate_impl::constraints{});
+    return value;
+  }
+
+  template <typename T, typename RNG>
+    requires std::default_initializable<T>
+  T generate(RNG& rng, std::size_t size_hint = generate_options{}.size_hint) {
+    return generate<T>(rng, generate_options{.size_hint = size_hint});
+  }
+
+  /// `count` values generated across `options.threads` threads. Element `i` only depends on
+  /// `seed` and `i`, so the dataset is the same whatever the number of threads.
+  template <typename T>
+    requires std::default_initializable<T>
+  std::vector<T>
+  generate_n(std::size_t count, std::uint64_t seed, const generate_options& options = {}) {
+    std::vector<T> values(count);
+
+    const auto fill_range = [&](std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) {
+        gen::splitmix64                           rng{generate_impl::element_seed(seed, i)};
+        generate_impl::generator<gen::splitmix64> generator{rng, options};
+        generator.fill(values[i], generate_impl::constraints{});
+      }
+    };
+
+    // Below this many elements per thread, starting a thread costs more than it saves
+    constexpr std::size_t min_chunk = 256;
+    std::size_t threads =
+      options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    threads = std::clamp<std::size_t>(count / min_chunk, 1, std::max<std::size_t>(threads, 1));
+
+    const std::size_t chunk = (count + threads - 1) / threads;
+    parallel_for(parallel_policy{.threads = threads}, threads, [&](std::size_t t) {
+      fill_range(t * chunk, std::min(count, (t + 1) * chunk));
+    });
+    return values;
+  }
+} // namespace refl
@@ -0,0 +1,451 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  hash.cppm
+ *! \brief Structural hash of reflected values, consistent with `deep_eq`.
+ *!
+ */
+
+export module reflect:hash;
+
+import std;
+
+import packtl;
+
+import :types;
+import :accessors;
+import :visitor;
+import :equality;
+import :parallel;
+
+export namespace refl {
+  /// Hash of the members of `obj`, following the same policies as `deep_eq`: skipped members are
+  /// left out, shallow references and pointers hash their address and deep ones their target.
+  /// Values that are `deep_eq` hash the same, as long as the reflected types with an
+  /// `operator==` of their own compare every member. Unordered containers hash the same whatever
+  /// their iteration order. Containers and other values that are not reflected are hashed the
+  /// same way as they would be as members.
+  template <typename T>
+  std::uint64_t deep_hash(const T& obj);
+
+  /// `deep_hash` spread over several threads, cut into tasks the same way as the parallel
+  /// `deep_eq`. Gives the same value as `deep_hash` whatever the policy.
+  template <Reflected R>
+  std::uint64_t deep_hash(const R& obj, const parallel_policy& policy);
+} // namespace refl
+
+namespace refl::deep_hash_impl {
+  inline constexpr std::uint64_t seed = 0x243f6a8885a308d3;
+
+  /// Sequences are folded in blocks of this many elements, so blocks hashed on different threads
+  /// combine into the same value as a sequential pass
+  inline constexpr std::size_t block_size = 4096;
+
+  constexpr std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+  }
+
+  constexpr std::uint64_t combine(std::uint64_t hash, std::uint64_t value) {
+    return mix(hash ^ (value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2)));
+  }
+
+  template <typename T>
+  std::uint64_t value_hash(const T& value);
+
+  template <typename T>
+  constexpr bool is_ordered =
+    packtl::is_type<std::vector, T>::value or packtl::is_type<std::list, T>::value or
+    packtl::is_type<std::forward_list, T>::value or packtl::is_type<std::deque, T>::value or
+    packtl::is_type<std::set, T>::value or packtl::is_type<std::multiset, T>::value or
+    packtl::is_type<std::map, T>::value or packtl::is_type<std::multimap, T>::value or
+    is_std_array<T>::value;
+
+  template <typename T>
+  constexpr bool is_unordered =
+    packtl::is_type<std::unordered_map, T>::value or
+    packtl::is_type<std::unordered_multimap, T>::value or
+    packtl::is_type<std::unordered_set, T>::value or
+    packtl::is_type<std::unordered_multiset, T>::value;
+
+  template <Reflected R>
+  std::uint64_t fields_hash(const R& obj);
+
+  template <typename I>
+  std::uint64_t block_hash(const I& range, std::size_t begin, std::size_t end) {
+    std::uint64_t hash = seed;
+    for (std::size_t i = begin; i < end; ++i) {
+      hash = combine(hash, value_hash(static_cast<const typename I::value_type&>(range[i])));
+    }
+    return hash;
+  }
+
+  template <typename I>
+  std::uint64_t ordered_hash(const I& range) {
+    // `std::forward_list` has no `size()`
+    std::uint64_t hash  = combine(seed, static_cast<std::uint64_t>(std::ranges::distance(range)));
+    std::uint64_t block = seed;
+    std::size_t   count = 0;
+    // Through `value_type`, so the proxies of `std::vector<bool>` hash as `bool`
+    for (const typename I::value_type& element: range) {
+      block = combine(block, value_hash(element));
+      if (++count % block_size == 0) {
+        hash  = combine(hash, block);
+        block = seed;
+      }
+    }
+    return count % block_size == 0 ? hash : combine(hash, block);
+  }
+
+  /// Commutative, so iteration order does not matter
+  template <typename I>
+  std::uint64_t unordered_hash(const I& range) {
+    std::uint64_t sum = 0;
+    for (const auto& element: range) {
+      sum += mix(value_hash(element));
+    }
+    return combine(combine(seed, range.size()), sum);
+  }
+
+  template <typename T>
+  std::uint64_t value_hash(const T& value) {
+    if constexpr (is_ordered<T>) {
+      return ordered_hash(value);
+    } else if constexpr (is_unordered<T>) {
+      return unordered_hash(value);
+    } else if constexpr (packtl::is_type<std::pair, T>::value) {
+      return combine(value_hash(value.first), value_hash(value.second));
+    } else if constexpr (packtl::is_type<std::tuple, T>::value) {
+      return std::apply(
+        [](const auto&... elements) {
+          std::uint64_t hash = seed;
+          ((hash = combine(hash, value_hash(elements))), ...);
+          return hash;
+        },
+        value
+      );
+    } else if constexpr (packtl::is_type<std::function, T>::value) {
+      // Like `deep_eq`, functions are only told apart by the type of their target
+      return value.target_type().hash_code();
+    } else if constexpr (packtl::is_type<std::optional, T>::value) {
+      return value.has_value() ? combine(seed, value_hash(*value)) : seed;
+    } else if constexpr (std::floating_point<T>) {
+      // `0.0 == -0.0`, so both have to hash the same
+      return value == T{0} ? 0 : std::hash<T>{}(value);
+    } else if constexpr (packtl::is_type<std::chrono::duration, T>::value) {
+      return value_hash(value.count());
+    } else if constexpr (packtl::is_type<std::chrono::time_point, T>::value) {
+      return value_hash(value.time_since_epoch());
+    } else if constexpr (Reflected<T>) {
+      return fields_hash(value);
+    } else if constexpr (requires { std::hash<T>{}(value); }) {
+      return std::hash<T>{}(value);
+    } else {
+      // Comparable but opaque, every value falls in the same bucket
+      return seed;
+    }
+  }
+
+  template <Reflected R, typename Field>
+  std::uint64_t field_hash(const R& obj) {
+    const auto& value = Field::from_instance(obj);
+
+    eq_policy::policy_e policy{eq_policy::deep};
+    if constexpr (Field::template has_metadata<eq_policy::policy_e>) {
+      policy = Field::template get_metadata<eq_policy::policy_e>;
+    }
+
+    if constexpr (Field::is_reference) {
+      if (policy == eq_policy::shallow) {
+        return std::hash<const void*>{}(&value);
+      }
+      return value_hash(value);
+    } else if constexpr (Field::is_pointer) {
+      using pointee = std::remove_pointer_t<typename Field::type>;
+      if constexpr (std::is_void_v<pointee>) {
+        return std::hash<const void*>{}(value);
+      } else {
+        if (policy == eq_policy::shallow or value == nullptr) {
+          return std::hash<const void*>{}(value);
+        }
+        return value_hash(*value);
+      }
+    } else {
+      return value_hash(value);
+    }
+  }
+
+  template <typename Field>
+  constexpr bool is_skipped = [] {
+    if constexpr (Field::template has_metadata<eq_policy::policy_e>) {
+      return Field::template get_metadata<eq_policy::policy_e> == eq_policy::skip;
+    } else {
+      return false;
+    }
+  }();
+
+  /// Backs `is_content_hashable`, `Seen` are the reflected types being checked, which a recursive
+  /// type reaches again
+  template <typename T, typename... Seen>
+  constexpr bool content_hashable() {
+    if constexpr ((std::same_as<T, Seen> or ...)) {
+      return true;
+    } else if constexpr (std::is_arithmetic_v<T> or std::is_enum_v<T> or
+                         std::same_as<T, std::string> or std::same_as<T, std::string_view> or
+                         packtl::is_type<std::chrono::duration, T>::value or
+                         packtl::is_type<std::chrono::time_point, T>::value) {
+      return true;
+    } else if constexpr (is_ordered<T> or is_unordered<T> or
+                         packtl::is_type<std::optional, T>::value) {
+      return content_hashable<std::remove_cv_t<typename T::value_type>, Seen...>();
+    } else if constexpr (packtl::is_type<std::pair, T>::value or
+                         packtl::is_type<std::tuple, T>::value) {
+      return []<std::size_t... I>(std::index_sequence<I...>) {
+        return (
+          content_hashable<std::remove_cv_t<std::tuple_element_t<I, T>>, Seen...>() and ...
+        );
+      }(std::make_index_sequence<std::tuple_size_v<T>>{});
+    } else if constexpr (Reflected<T>) {
+      return []<std::size_t... I>(std::index_sequence<I...>) {
+        return ([] {
+          using Field = field<T, I>;
+          if constexpr (is_skipped<Field> or Field::is_reference or Field::is_pointer) {
+            return false;
+          } else {
+            return content_hashable<std::remove_cv_t<typename Field::type>, T, Seen...>();
+          }
+        }() and ...);
+      }(std::make_index_sequence<field_count<T>>{});
+    } else {
+      return false;
+    }
+  }
+
+  /// Whether a `T` can hold a floating point zero that `zero_signs` has to look at, `Seen` are
+  /// the reflected types being checked
+  template <typename T, typename... Seen>
+  constexpr bool holds_floating_point() {
+    if constexpr ((std::same_as<T, Seen> or ...)) {
+      return false;
+    } else if constexpr (std::floating_point<T>) {
+      return true;
+    } else if constexpr (packtl::is_type<std::chrono::duration, T>::value) {
+      return std::floating_point<typename T::rep>;
+    } else if constexpr (packtl::is_type<std::chrono::time_point, T>::value) {
+      return holds_floating_point<typename T::duration, Seen...>();
+    } else if constexpr (is_ordered<T> or is_unordered<T> or
+                         packtl::is_type<std::optional, T>::value) {
+      return holds_floating_point<std::remove_cv_t<typename T::value_type>, Seen...>();
+    } else if constexpr (packtl::is_type<std::pair, T>::value or
+                         packtl::is_type<std::tuple, T>::value) {
+      return []<std::size_t... I>(std::index_sequence<I...>) {
+        return (
+          holds_floating_point<std::remove_cv_t<std::tuple_element_t<I, T>>, Seen...>() or ...
+        );
+      }(std::make_index_sequence<std::tuple_size_v<T>>{});
+    } else if constexpr (Reflected<T>) {
+      return []<std::size_t... I>(std::index_sequence<I...>) {
+        return ([] {
+          using Field = field<T, I>;
+          if constexpr (is_skipped<Field> or Field::is_reference or Field::is_pointer) {
+            return false;
+          } else {
+            return holds_floating_point<std::remove_cv_t<typename Field::type>, T, Seen...>();
+          }
+        }() or ...);
+      }(std::make_index_sequence<field_count<T>>{});
+    } else {
+      return false;
+    }
+  }
+
+  /// Adds the zero signs of the element at `index` to `hash`, leaving it alone when there are none
+  constexpr std::uint64_t fold_signs(std::uint64_t hash, std::uint64_t index, std::uint64_t signs) {
+    return signs == 0 ? hash : combine(hash ^ mix(index), signs);
+  }
+
+  /// Where `value` holds a `-0.0`, in the order `value_hash` visits it, `0` when it holds none.
+  /// Covers the same values as `content_hashable`.
+  template <typename T>
+  std::uint64_t zero_signs(const T& value) {
+    if constexpr (not holds_floating_point<T>()) {
+      return 0;
+    } else if constexpr (std::floating_point<T>) {
+      return value == T{0} and std::signbit(value) ? 1 : 0;
+    } else if constexpr (packtl::is_type<std::chrono::duration, T>::value) {
+      return zero_signs(value.count());
+    } else if constexpr (packtl::is_type<std::chrono::time_point, T>::value) {
+      return zero_signs(value.time_since_epoch());
+    } else if constexpr (packtl::is_type<std::optional, T>::value) {
+      return value.has_value() ? zero_signs(*value) : 0;
+    } else if constexpr (is_unordered<T>) {
+      std::uint64_t sum = 0;
+      for (const auto& element: value) {
+        const std::uint64_t signs = zero_signs(element);
+        sum += signs == 0 ? 0 : mix(signs);
+      }
+      return sum;
+    } else if constexpr (is_ordered<T>) {
+      std::uint64_t hash  = 0;
+      std::uint64_t index = 0;
+      for (const typename T::value_type& element: value) {
+        hash = fold_signs(hash, index++, zero_signs(element));
+      }
+      return hash;
+    } else if constexpr (packtl::is_type<std::pair, T>::value or
+                         packtl::is_type<std::tuple, T>::value) {
+      return std::apply(
+        [](const auto&... elements) {
+          std::uint64_t hash  = 0;
+          std::uint64_t index = 0;
+          ((hash = fold_signs(hash, index++, zero_signs(elements))), ...);
+          return hash;
+        },
+        value
+      );
+    } else {
+      std::uint64_t hash = 0;
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+          [&] {
+            using Field = field<T, I>;
+            if constexpr (not is_skipped<Field> and not Field::is_reference and
+                          not Field::is_pointer) {
+              hash = fold_signs(hash, I, zero_signs(Field::from_instance(value)));
+            }
+          }(),
+          ...
+        );
+      }(std::make_index_sequence<field_count<T>>{});
+      return hash;
+    }
+  }
+
+  template <Reflected R>
+  std::uint64_t fields_hash(const R& obj) {
+    std::uint64_t hash = seed;
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (
+        [&] {
+          if constexpr (not is_skipped<field<R, I>>) {
+            hash = combine(hash, field_hash<R, field<R, I>>(obj));
+          }
+        }(),
+        ...
+      );
+    }(std::make_index_sequence<field_count<R>>{});
+    return hash;
+  }
+
+  //! Parallel hash. Planning a value adds the tasks computing its parts and returns how to
+  //! combine them once every task ran.
+
+  using deferred_hash = std::function<std::uint64_t()>;
+
+  template <Reflected R>
+  deferred_hash plan_fields_hash(const R& obj, parallel_impl::task_list& tasks);
+
+  template <typename T>
+  deferred_hash plan_hash(const T& value, parallel_impl::task_list& tasks) {
+    if constexpr (packtl::is_type<std::vector, T>::value or packtl::is_type<std::deque, T>::value) {
+      const std::size_t size = value.size();
+      if (size > tasks.policy().min_chunk) {
+        auto blocks = std::make_shared<std::vector<std::uint64_t>>(
+          (size + block_size - 1) / block_size
+        );
+        // Chunks are whole blocks
+        const std::size_t chunk =
+          (tasks.policy().min_chunk + block_size - 1) / block_size * block_size;
+        tasks.add_chunks(size, chunk, [&value, blocks, size](std::size_t begin, std::size_t end) {
+          for (std::size_t first = begin; first < end; first += block_size) {
+            (*blocks)[first / block_size] =
+              block_hash(value, first, std::min(first + block_size, size));
+          }
+        });
+        return [blocks, size] {
+          std::uint64_t hash = combine(seed, size);
+          for (const std::uint64_t block: *blocks) {
+            hash = combine(hash, block);
+          }
+          return hash;
+        };
+      }
+    } else if constexpr (Reflected<T>) {
+      return plan_fields_hash(value, tasks);
+    }
+
+    auto result = std::make_shared<std::uint64_t>(0);
+    tasks.add([&value, result] {
+      *result = value_hash(value);
+    });
+    return [result] {
+      return *result;
+    };
+  }
+
+  template <Reflected R>
+  deferred_hash plan_fields_hash(const R& obj, parallel_impl::task_list& tasks) {
+    std::vector<deferred_hash> parts{};
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (
+        [&] {
+          using Field = field<R, I>;
+          if constexpr (is_skipped<Field>) {
+            return;
+          } else if constexpr (Field::is_reference or Field::is_pointer) {
+            auto result = std::make_shared<std::uint64_t>(0);
+            tasks.add([&obj, result] {
+              *result = field_hash<R, Field>(obj);
+            });
+            parts.emplace_back([result] {
+              return *result;
+            });
+          } else {
+            parts.push_back(plan_hash(Field::from_instance(obj), tasks));
+          }
+        }(),
+        ...
+      );
+    }(std::make_index_sequence<field_count<R>>{});
+
+    return [parts = std::move(parts)] {
+      std::uint64_t hash = seed;
+      for (const auto& part: parts) {
+        hash = combine(hash, part());
+      }
+      return hash;
+    };
+  }
+} // namespace refl::deep_hash_impl
+
+export namespace refl {
+  /// Whether `deep_hash` of a `T` depends on everything it holds, so two of them only hash the
+  /// same by collision when they differ: there are no opaque values, hashed all alike, no pointers,
+  /// references or smart pointers, hashed by address, and no members `deep_eq` skips.
+  template <typename T>
+  constexpr bool is_content_hashable = deep_hash_impl::content_hashable<T>();
+
+  /// What `deep_hash` leaves out of a content hashable `value`: where it holds a `-0.0`, which is
+  /// `deep_eq` to `0.0` but written differently. `0` when it holds none.
+  template <typename T>
+    requires is_content_hashable<T>
+  std::uint64_t zero_signs_hash(const T& value) {
+    return deep_hash_impl::zero_signs(value);
+  }
+} // namespace refl
+
+namespace refl {
+  template <typename T>
+  std::uint64_t deep_hash(const T& obj) {
+    return deep_hash_impl::value_hash(obj);
+  }
+
+  template <Reflected R>
+  std::uint64_t deep_hash(const R& obj, const parallel_policy& policy) {
+    parallel_impl::task_list tasks{policy};
+    const auto               hash = deep_hash_impl::plan_fields_hash(obj, tasks);
+    tasks.run();
+    return hash();
+  }
+} // namespace refl
@@ -0,0 +1,543 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  indexed_table.cppm
+ *! \brief Row storage with secondary indexes generated from field annotations.
+ *!
+ */
+
+export module reflect:indexed_table;
+
+import std;
+
+import :types;
+import :accessors;
+
+export namespace refl::index {
+  /// Field annotation, `[[meta(refl::index::hash)]]` or `[[meta(refl::index::ordered)]]`
+  enum kind_e {
+    hash,
+    ordered,
+  };
+} // namespace refl::index
+
+namespace refl::detail {
+  using row_id = std::size_t;
+
+  inline constexpr row_id no_row = std::numeric_limits<row_id>::max();
+
+  template <typename T, std::size_t I>
+  const auto& index_key(const std::vector<std::optional<T>>& rows, row_id id) {
+    return field<T, I>::from_instance(*rows[id]);
+  }
+
+  /// Open addressing table with one slot per distinct key. Rows sharing a key are chained through
+  /// `next_` / `prev_`, so erasing any of them is O(1) once its slot is found.
+  template <typename T, std::size_t I>
+  class hash_index {
+  public:
+    using key_type = std::remove_cvref_t<typename field<T, I>::type>;
+    using rows_t   = std::vector<std::optional<T>>;
+
+    void insert(const rows_t& rows, row_id id) {
+      if (id >= next_.size()) {
+        next_.resize(id + 1, no_row);
+        prev_.resize(id + 1, no_row);
+      }
+      if ((used_ + 1) * 8 > slots_.size() * 7) {
+        rehash(std::max<std::size_t>(16, std::bit_ceil((distinct_ + 1) * 2)));
+      }
+
+      const auto& key      = index_key<T, I>(rows, id);
+      const auto  hash     = hasher_(key);
+      std::size_t free_pos = slots_.size();
+      for (std::size_t pos = hash & mask();; pos = (pos + 1) & mask()) {
+        auto& slot = slots_[pos];
+        if (slot.head == empty) {
+          if (free_pos == slots_.size()) {
+            free_pos = pos;
+            ++used_;
+          }
+          break;
+        }
+        if (slot.head == tombstone) {
+          free_pos = std::min(free_pos, pos);
+          continue;
+        }
+        if (slot.hash == hash and index_key<T, I>(rows, slot.head) == key) {
+          next_[id]        = slot.head;
+          prev_[id]        = no_row;
+          prev_[slot.head] = id;
+          slot.head        = id;
+          return;
+        }
+      }
+      slots_[free_pos] = {hash, id};
+      next_[id]        = no_row;
+      prev_[id]        = no_row;
+      ++distinct_;
+    }
+
+    /// Must run before the row's key changes
+    void erase(const rows_t& rows, row_id id) {
+      const row_id next = next_[id];
+      const row_id prev = prev_[id];
+      if (next != no_row) {
+        prev_[next] = prev;
+      }
+      if (prev != no_row) {
+        next_[prev] = next;
+        return;
+      }
+
+      const auto pos = find_slot(rows, index_key<T, I>(rows, id));
+      if (next != no_row) {
+        slots_[pos].head = next;
+      } else {
+        slots_[pos].head = tombstone;
+        --distinct_;
+      }
+    }
+
+    row_id find(const rows_t& rows, const key_type& key) const {
+      const auto pos = find_slot(rows, key);
+      return pos == slots_.size() ? no_row : slots_[pos].head;
+    }
+
+    void find_all(const rows_t& rows, const key_type& key, std::vector<row_id>& out) const {
+      for (row_id id = find(rows, key); id != no_row; id = next_[id]) {
+        out.push_back(id);
+      }
+    }
+
+    void clear() {
+      slots_.clear();
+      next_.clear();
+      prev_.clear();
+      used_     = 0;
+      distinct_ = 0;
+    }
+
+  private:
+    static constexpr row_id empty     = no_row;
+    static constexpr row_id tombstone = no_row - 1;
+
+    struct slot_t {
+      std::size_t hash = 0;
+      row_id      head = empty;
+    };
+
+    std::size_t mask() const {
+      return slots_.size() - 1;
+    }
+
+    std::size_t find_slot(const rows_t& rows, const key_type& key) const {
+      if (slots_.empty()) {
+        return 0;
+      }
+      const auto hash = hasher_(key);
+      for (std::size_t pos = hash & mask();; pos = (pos + 1) & mask()) {
+        const auto& slot = slots_[pos];
+        if (slot.head == empty) {
+          return slots_.size();
+        }
+        if (slot.head != tombstone and slot.hash == hash and
+            index_key<T, I>(rows, slot.head) == key) {
+          return pos;
+        }
+      }
+    }
+
+    void rehash(std::size_t capacity) {
+      std::vector<slot_t> old = std::exchange(slots_, std::vector<slot_t>(capacity));
+      used_                   = 0;
+      for (const auto& slot: old) {
+        if (slot.head == empty or slot.head == tombstone) {
+          continue;
+        }
+        std::size_t pos = slot.hash & mask();
+        while (slots_[pos].head != empty) {
+          pos = (pos + 1) & mask();
+        }
+        slots_[pos] = slot;
+        ++used_;
+      }
+    }
+
+  private:
+    [[no_unique_address]] std::hash<key_type> hasher_{};
+    std::vector<slot_t>                       slots_{};
+    std::vector<row_id>                       next_{};
+    std::vector<row_id>                       prev_{};
+    std::size_t                               used_     = 0;
+    std::size_t                               distinct_ = 0;
+  };
+
+  /// Row ids sorted by `(key, id)` in a list of bounded blocks, a two level B-tree. Lookups binary
+  /// search the block boundaries then the block, inserts and erases only shift one block.
+  template <typename T, std::size_t I>
+  class ordered_index {
+  public:
+    using key_type = std::remove_cvref_t<typename field<T, I>::type>;
+    using rows_t   = std::vector<std::optional<T>>;
+
+    static constexpr std::size_t max_block = 512;
+
+    void insert(const rows_t& rows, row_id id) {
+      if (blocks_.empty()) {
+        blocks_.push_back({id});
+        return;
+      }
+      auto  less  = entry_less(rows);
+      auto  block = block_for(rows, id);
+      auto& items = blocks_[block];
+      items.insert(std::ranges::lower_bound(items, id, less), id);
+      if (items.size() > max_block) {
+        std::vector<row_id> upper(items.begin() + max_block / 2, items.end());
+        items.resize(max_block / 2);
+        const auto next = blocks_.begin() + static_cast<std::ptrdiff_t>(block) + 1;
+        blocks_.insert(next, std::move(upper));
+      }
+    }
+
+    /// Must run before the row's key changes
+    void erase(const rows_t& rows, row_id id) {
+      const auto block = block_for(rows, id);
+      auto&      items = blocks_[block];
+      const auto pos   = std::ranges::lower_bound(items, id, entry_less(rows));
+      if (pos != items.end() and *pos == id) {
+        items.erase(pos);
+      }
+      if (items.empty()) {
+        blocks_.erase(blocks_.begin() + static_cast<std::ptrdiff_t>(block));
+      }
+    }
+
+    row_id find(const rows_t& rows, const key_type& key) const {
+      auto [block, pos] = lower_bound(rows, key);
+      if (block == blocks_.size() or key < index_key<T, I>(rows, blocks_[block][pos])) {
+        return no_row;
+      }
+      return blocks_[block][pos];
+    }
+
+    void find_all(const rows_t& rows, const key_type& key, std::vector<row_id>& out) const {
+      scan(rows, lower_bound(rows, key), [&](const key_type& current) {
+        return not(key < current);
+      }, out);
+    }
+
+    /// Rows with `lo <= key < hi`, in key order
+    void range(
+      const rows_t& rows, const key_type& lo, const key_type& hi, std::vector<row_id>& out
+    ) const {
+      scan(rows, lower_bound(rows, lo), [&](const key_type& current) {
+        return current < hi;
+      }, out);
+    }
+
+    void clear() {
+      blocks_.clear();
+    }
+
+  private:
+    static auto entry_less(const rows_t& rows) {
+      return [&rows](row_id lhs, row_id rhs) {
+        const auto& a = index_key<T, I>(rows, lhs);
+        const auto& b = index_key<T, I>(rows, rhs);
+        return a < b or (not(b < a) and lhs < rhs);
+      };
+    }
+
+    /// First block whose last entry is not less than `id`, clamped to the last block
+    std::size_t block_for(const rows_t& rows, row_id id) const {
+      const auto less = entry_less(rows);
+      const auto it   = std::ranges::partition_point(blocks_, [&](const auto& items) {
+        return less(items.back(), id);
+      });
+      return std::min<std::size_t>(it - blocks_.begin(), blocks_.size() - 1);
+    }
+
+    std::pair<std::size_t, std::size_t> lower_bound(const rows_t& rows, const key_type& key) const {
+      const auto block_it = std::ranges::partition_point(blocks_, [&](const auto& items) {
+        return index_key<T, I>(rows, items.back()) < key;
+      });
+      if (block_it == blocks_.end()) {
+        return {blocks_.size(), 0};
+      }
+      const auto pos = std::ranges::partition_point(*block_it, [&](row_id id) {
+        return index_key<T, I>(rows, id) < key;
+      });
+      return {
+        static_cast<std::size_t>(block_it - blocks_.begin()),
+        static_cast<std::size_t>(pos - block_it->begin()),
+      };
+    }
+
+    template <typename Pred>
+    void scan(
+      const rows_t&                       rows,
+      std::pair<std::size_t, std::size_t> from,
+      Pred                                keep,
+      std::vector<row_id>&                out
+    ) const {
+      for (auto [block, pos] = from; block < blocks_.size(); ++block, pos = 0) {
+        for (; pos < blocks_[block].size(); ++pos) {
+          const row_id id = blocks_[block][pos];
+          if (not keep(index_key<T, I>(rows, id))) {
+            return;
+          }
+          out.push_back(id);
+        }
+      }
+    }
+
+  private:
+    std::vector<std::vector<row_id>> blocks_{};
+  };
+
+  template <typename T, std::size_t I>
+  consteval int index_kind() {
+    if constexpr (field<T, I>::template has_metadata<index::kind_e>) {
+      return field<T, I>::template get_metadata<index::kind_e>;
+    } else {
+      return -1;
+    }
+  }
+
+  template <typename T, std::size_t I, int Kind = index_kind<T, I>()>
+  struct index_for {
+    using type = std::monostate;
+  };
+
+  template <typename T, std::size_t I>
+  struct index_for<T, I, index::hash> {
+    using type = hash_index<T, I>;
+  };
+
+  template <typename T, std::size_t I>
+  struct index_for<T, I, index::ordered> {
+    using type = ordered_index<T, I>;
+  };
+
+  template <typename T, typename Seq>
+  struct index_tuple;
+
+  template <typename T, std::size_t... I>
+  struct index_tuple<T, std::index_sequence<I...>> {
+    using type = std::tuple<typename index_for<T, I>::type...>;
+  };
+} // namespace refl::detail
+
+export namespace refl {
+  /// Stores rows of `T` and keeps one secondary index per annotated field:
+  ///
+  ///   struct user {
+  ///     [[meta(refl::index::hash)]]    int         id;
+  ///     [[meta(refl::index::hash)]]    std::string name;
+  ///     [[meta(refl::index::ordered)]] std::int64_t created;
+  ///   };
+  ///
+  /// Hash indexes answer `find` / `find_all` in O(1), ordered indexes answer them in O(log n) and
+  /// also serve `range`. Rows are addressed by a stable `row_id`, ids of erased rows are reused.
+  /// Rows are only mutable through `set` and `modify`, which keep the indexes in sync.
+  template <Reflected T>
+  class indexed_table {
+  public:
+    using row_id     = detail::row_id;
+    using value_type = T;
+
+    static constexpr std::size_t field_count = refl::field_count<T>;
+
+    template <std::size_t I>
+    using field_type = std::remove_cvref_t<typename field<T, I>::type>;
+
+    template <std::size_t I>
+    static constexpr bool is_indexed = detail::index_kind<T, I>() >= 0;
+
+    row_id insert(T value) {
+      row_id id;
+      if (free_.empty()) {
+        id = rows_.size();
+        rows_.emplace_back(std::move(value));
+      } else {
+        id = free_.back();
+        free_.pop_back();
+        rows_[id].emplace(std::move(value));
+      }
+      ++size_;
+      index_all(id);
+      return id;
+    }
+
+    void erase(row_id id) {
+      check(id);
+      unindex_all(id);
+      rows_[id].reset();
+      free_.push_back(id);
+      --size_;
+    }
+
+    bool contains(row_id id) const {
+      return id < rows_.size() and rows_[id].has_value();
+    }
+
+    const T& operator[](row_id id) const {
+      return *rows_[id];
+    }
+
+    const T& at(row_id id) const {
+      check(id);
+      return *rows_[id];
+    }
+
+    /// Assigns field `Name` of row `id`, re-indexing it if the field is indexed. If the assignment
+    /// throws, the row is re-indexed under whatever value the field was left with.
+    template <field_name Name, typename V>
+    void set(row_id id, V&& value) {
+      constexpr std::size_t I = field_index<T, Name>;
+      static_assert(I < field_count, "no field with that name");
+      check(id);
+
+      if constexpr (is_indexed<I>) {
+        auto& index = std::get<I>(indexes_);
+        index.erase(rows_, id);
+        try {
+          field<T, I>::from_instance(*rows_[id]) = std::forward<V>(value);
+        } catch (...) {
+          index.insert(rows_, id);
+          throw;
+        }
+        index.insert(rows_, id);
+      } else {
+        field<T, I>::from_instance(*rows_[id]) = std::forward<V>(value);
+      }
+    }
+
+    /// Arbitrary mutation of row `id`, every index is refreshed. If `func` throws, the row is
+    /// re-indexed as `func` left it before the exception propagates.
+    template <typename F>
+    void modify(row_id id, F&& func) {
+      check(id);
+      unindex_all(id);
+      try {
+        std::forward<F>(func)(*rows_[id]);
+      } catch (...) {
+        index_all(id);
+        throw;
+      }
+      index_all(id);
+    }
+
+    /// Any row whose field `Name` equals `key`
+    template <field_name Name>
+    std::optional<row_id> find(const field_type<field_index<T, Name>>& key) const {
+      const row_id id = index_of<Name>().find(rows_, key);
+      return id == detail::no_row ? std::nullopt : std::optional<row_id>{id};
+    }
+
+    template <field_name Name>
+    std::vector<row_id> find_all(const field_type<field_index<T, Name>>& key) const {
+      std::vector<row_id> out{};
+      index_of<Name>().find_all(rows_, key, out);
+      return out;
+    }
+
+    /// Rows with `lo <= Name < hi` in key order, only for `ordered` fields
+    template <field_name Name>
+    std::vector<row_id> range(
+      const field_type<field_index<T, Name>>& lo, const field_type<field_index<T, Name>>& hi
+    ) const {
+      static_assert(
+        detail::index_kind<T, field_index<T, Name>>() == index::ordered,
+        "range lookups need an ordered index"
+      );
+      std::vector<row_id> out{};
+      index_of<Name>().range(rows_, lo, hi, out);
+      return out;
+    }
+
+    /// Calls `func(id, row)` for every live row
+    template <typename F>
+    void for_each(F&& func) const {
+      for (row_id id = 0; id < rows_.size(); ++id) {
+        if (rows_[id].has_value()) {
+          func(id, *rows_[id]);
+        }
+      }
+    }
+
+    std::size_t size() const {
+      return size_;
+    }
+
+    bool empty() const {
+      return size_ == 0;
+    }
+
+    void reserve(std::size_t capacity) {
+      rows_.reserve(capacity);
+    }
+
+    void clear() {
+      rows_.clear();
+      free_.clear();
+      size_ = 0;
+      std::apply([](auto&... index) { (clear_index(index), ...); }, indexes_);
+    }
+
+  private:
+    template <field_name Name>
+    const auto& index_of() const {
+      constexpr std::size_t I = field_index<T, Name>;
+      static_assert(I < field_count, "no field with that name");
+      static_assert(is_indexed<I>, "field is not indexed, annotate it with refl::index");
+      return std::get<I>(indexes_);
+    }
+
+    void check(row_id id) const {
+      if (not contains(id)) {
+        throw std::out_of_range(std::format("indexed_table has no row {}", id));
+      }
+    }
+
+    void index_all(row_id id) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (index_one<I>(id), ...);
+      }(std::make_index_sequence<field_count>{});
+    }
+
+    void unindex_all(row_id id) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (unindex_one<I>(id), ...);
+      }(std::make_index_sequence<field_count>{});
+    }
+
+    template <std::size_t I>
+    void index_one(row_id id) {
+      if constexpr (is_indexed<I>) {
+        std::get<I>(indexes_).insert(rows_, id);
+      }
+    }
+
+    template <std::size_t I>
+    void unindex_one(row_id id) {
+      if constexpr (is_indexed<I>) {
+        std::get<I>(indexes_).erase(rows_, id);
+      }
+    }
+
+    template <typename Index>
+    static void clear_index(Index& index) {
+      if constexpr (not std::same_as<Index, std::monostate>) {
+        index.clear();
+      }
+    }
+
+  private:
+    std::vector<std::optional<T>> rows_{};
+    std::vector<row_id>           free_{};
+    std::size_t                   size_ = 0;
+    typename detail::index_tuple<T, std::make_index_sequence<field_count>>::type indexes_{};
+  };
+} // namespace refl
@@ -0,0 +1,268 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  instrumentation.cppm
+ *! \brief Opt-in per type and per field counters for visitors and comparisons.
+ *!
+ */
+
+export module reflect:instrumentation;
+
+import std;
+
+import :types;
+import :type_name;
+
+export namespace refl::instrumentation {
+  /// Set by building with `CPP_REFLECT_INSTRUMENTATION` (the CMake option of the same name).
+  /// Otherwise every probe is a plain call of its body.
+#ifdef CPP_REFLECT_INSTRUMENTATION
+  inline constexpr bool enabled = true;
+#else
+  inline constexpr bool enabled = false;
+#endif
+
+  enum class operation : unsigned char {
+    visit,
+    compare,
+  };
+
+  constexpr std::string_view to_string(operation op) {
+    switch (op) {
+      case operation::visit:
+        return "visit";
+      case operation::compare:
+        return "compare";
+    }
+    return "unknown";
+  }
+
+  struct counters {
+    std::uint64_t visits      = 0;
+    std::uint64_t bytes       = 0;
+    std::uint64_t nanoseconds = 0;
+  };
+
+  struct profile_entry {
+    operation        op = operation::visit;
+    std::string_view type{};
+    /// Empty for the whole object
+    std::string_view field{};
+    counters         totals{};
+  };
+
+  /// Counters of every thread merged together, sorted by decreasing time
+  struct profile {
+    std::vector<profile_entry> entries{};
+
+    const profile_entry*
+    find(operation op, std::string_view type, std::string_view field = {}) const {
+      const auto it = std::ranges::find_if(entries, [&](const profile_entry& entry) {
+        return entry.op == op and entry.type == type and entry.field == field;
+      });
+      return it == entries.end() ? nullptr : &*it;
+    }
+
+    std::string to_json() const;
+  };
+} // namespace refl::instrumentation
+
+namespace refl::instrumentation::detail {
+  struct site {
+    operation        op;
+    std::string_view type;
+    std::string_view field;
+  };
+
+  /// Only the owning thread writes a cell, merging threads read it concurrently
+  struct cell {
+    explicit cell(site where_)
+        : where(where_) {}
+
+    site                       where;
+    std::atomic<std::uint64_t> visits{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+  };
+
+  /// The cells of one thread, kept alive after it exits so its counts are not lost
+  struct accumulator {
+    std::mutex       mutex{};
+    std::deque<cell> cells{};
+  };
+
+  struct registry {
+    std::mutex                                mutex{};
+    std::vector<std::shared_ptr<accumulator>> accumulators{};
+
+    static registry& get() {
+      static registry instance{};
+      return instance;
+    }
+  };
+
+  inline accumulator& local_accumulator() {
+    thread_local std::shared_ptr<accumulator> local = [] {
+      auto             acc = std::make_shared<accumulator>();
+      auto&            reg = registry::get();
+      std::scoped_lock lock{reg.mutex};
+      reg.accumulators.push_back(acc);
+      return acc;
+    }();
+    return *local;
+  }
+
+  inline cell& new_cell(site where) {
+    auto&            acc = local_accumulator();
+    std::scoped_lock lock{acc.mutex};
+    return acc.cells.emplace_back(where);
+  }
+
+  /// One cell per probe site and thread, found once and then reached through a thread local
+  template <operation Op, typename T, typename Field>
+  cell& slot() {
+    thread_local cell& local = new_cell({
+      .op    = Op,
+      .type  = type_name<T>,
+      .field = [] {
+        if constexpr (std::is_void_v<Field>) {
+          return std::string_view{};
+        } else {
+          return std::string_view{Field::name};
+        }
+      }(),
+    });
+    return local;
+  }
+
+  struct no_position {
+    constexpr std::size_t operator()() const {
+      return 0;
+    }
+  };
+
+  inline void write_json_string(std::string& out, std::string_view str) {
+    out += '"';
+    for (const char c: str) {
+      if (c == '"' or c == '\\') {
+        out += '\\';
+      }
+      out += c;
+    }
+    out += '"';
+  }
+} // namespace refl::instrumentation::detail
+
+export namespace refl::instrumentation {
+  /// Runs `body`, counting one visit of `T` (or of its field `Field`), the time it took and how
+  /// far `position()` advanced, e.g. the bytes a format wrote meanwhile. Times are inclusive of
+  /// nested probes.
+  template <operation Op, typename T, typename Field = void, typename Body, typename Position>
+  decltype(auto) probe(Body&& body, [[maybe_unused]] Position&& position) {
+    if constexpr (not enabled) {
+      return body();
+    } else {
+      struct guard {
+        detail::cell&                         cell;
+        Position&                             position;
+        std::size_t                           start_position;
+        std::chrono::steady_clock::time_point start;
+
+        ~guard() {
+          const auto elapsed = std::chrono::steady_clock::now() - start;
+          detail::cell::add(cell.visits, 1);
+          detail::cell::add(cell.bytes, position() - start_position);
+          detail::cell::add(
+            cell.nanoseconds,
+            static_cast<std::uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+            )
+          );
+        }
+      } probe_guard{
+        detail::slot<Op, T, Field>(), position, position(), std::chrono::steady_clock::now()
+      };
+      return body();
+    }
+  }
+
+  template <operation Op, typename T, typename Field = void, typename Body>
+  decltype(auto) probe(Body&& body) {
+    detail::no_position position{};
+    return probe<Op, T, Field>(std::forward<Body>(body), position);
+  }
+
+  /// Merges the counters of every thread. Counts being written meanwhile may or may not be
+  /// included.
+  inline profile snapshot() {
+    using key_t = std::tuple<operation, std::string_view, std::string_view>;
+    std::map<key_t, counters> merged{};
+
+    auto&            reg = detail::registry::get();
+    std::scoped_lock lock{reg.mutex};
+    for (const auto& acc: reg.accumulators) {
+      std::scoped_lock cells_lock{acc->mutex};
+      for (const auto& cell: acc->cells) {
+        auto& totals = merged[{cell.where.op, cell.where.type, cell.where.field}];
+        totals.visits += cell.visits.load(std::memory_order_relaxed);
+        totals.bytes += cell.bytes.load(std::memory_order_relaxed);
+        totals.nanoseconds += cell.nanoseconds.load(std::memory_order_relaxed);
+      }
+    }
+
+    profile result{};
+    for (const auto& [key, totals]: merged) {
+      if (totals.visits > 0) {
+        const auto& [op, type, field] = key;
+        result.entries.push_back({op, type, field, totals});
+      }
+    }
+    std::ranges::stable_sort(result.entries, std::ranges::greater{}, [](const profile_entry& e) {
+      return e.totals.nanoseconds;
+    });
+    return result;
+  }
+
+  /// Zeroes the counters of every thread
+  inline void reset() {
+    auto&            reg = detail::registry::get();
+    std::scoped_lock lock{reg.mutex};
+    for (const auto& acc: reg.accumulators) {
+      std::scoped_lock cells_lock{acc->mutex};
+      for (auto& cell: acc->cells) {
+        cell.visits.store(0, std::memory_order_relaxed);
+        cell.bytes.store(0, std::memory_order_relaxed);
+        cell.nanoseconds.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// `{"entries": [{"operation": ..., "type": ..., "field": ..., "visits": ..., ...}, ...]}`
+  inline std::string profile::to_json() const {
+    std::string out{"{\"entries\":["};
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      const auto& entry = entries[i];
+      if (i > 0) {
+        out += ',';
+      }
+      out += "{\"operation\":";
+      detail::write_json_string(out, to_string(entry.op));
+      out += ",\"type\":";
+      detail::write_json_string(out, entry.type);
+      out += ",\"field\":";
+      detail::write_json_string(out, entry.field);
+      out += std::format(
+        ",\"visits\":{},\"bytes\":{},\"nanoseconds\":{}}}",
+        entry.totals.visits,
+        entry.totals.bytes,
+        entry.totals.nanoseconds
+      );
+    }
+    out += "]}";
+    return out;
+  }
+} // namespace refl::instrumentation
@@ -0,0 +1,260 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  layout.cppm
+ *! \brief Padding and cache line analysis of reflected types.
+ *!
+ */
+
+export module reflect:layout;
+
+import std;
+
+import :types;
+import :type_name;
+import :accessors;
+
+export namespace refl {
+  inline constexpr std::size_t cache_line_size = 64;
+
+  /// Placement of one field inside its enclosing object, in bytes
+  struct field_layout {
+    std::size_t      index  = 0;
+    std::string_view name   = {};
+    std::size_t      offset = 0;
+    std::size_t      size   = 0;
+    std::size_t      align  = 1;
+
+    constexpr std::size_t end() const {
+      return offset + size;
+    }
+
+    constexpr std::size_t first_cache_line() const {
+      return offset / cache_line_size;
+    }
+
+    constexpr std::size_t last_cache_line() const {
+      return (end() - (size == 0 ? 0 : 1)) / cache_line_size;
+    }
+
+    constexpr bool straddles_cache_line() const {
+      return first_cache_line() != last_cache_line();
+    }
+  };
+
+  /// Unused bytes between two fields, or after the last one
+  struct layout_hole {
+    std::size_t offset = 0;
+    std::size_t size   = 0;
+  };
+
+  /// The analysis behind `refl::layout<T>`, also usable at runtime on layouts gathered some other
+  /// way. `fields` must be sorted by offset. Bytes before the first field belong to bases and the
+  /// vtable pointer and are not counted as padding.
+  namespace layout_analysis {
+    constexpr std::size_t align_up(std::size_t value, std::size_t align) {
+      return (value + align - 1) / align * align;
+    }
+
+    constexpr std::size_t header_bytes(std::span<const field_layout> fields, std::size_t size) {
+      return fields.empty() ? size : fields.front().offset;
+    }
+
+    /// Calls `func(layout_hole)` for every gap, the tail padding last
+    template <typename F>
+    constexpr void for_each_hole(std::span<const field_layout> fields, std::size_t size, F&& func) {
+      if (fields.empty()) {
+        return;
+      }
+      std::size_t cursor = fields.front().offset;
+      for (const auto& field: fields) {
+        if (field.offset > cursor) {
+          func(layout_hole{cursor, field.offset - cursor});
+        }
+        cursor = std::max(cursor, field.end());
+      }
+      if (size > cursor) {
+        func(layout_hole{cursor, size - cursor});
+      }
+    }
+
+    constexpr std::size_t padding_bytes(std::span<const field_layout> fields, std::size_t size) {
+      std::size_t total = 0;
+      for_each_hole(fields, size, [&](const layout_hole& hole) { total += hole.size; });
+      return total;
+    }
+
+    constexpr std::size_t hole_count(std::span<const field_layout> fields, std::size_t size) {
+      std::size_t count = 0;
+      for_each_hole(fields, size, [&](const layout_hole&) { ++count; });
+      return count;
+    }
+
+    /// Positions into `fields` by decreasing alignment, then decreasing size, the current order
+    /// breaking ties. Laying fields out in that order leaves at most tail padding.
+    constexpr void
+    suggest_order(std::span<const field_layout> fields, std::span<std::size_t> order) {
+      for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+      }
+      // `std::ranges::sort` is usable in constant expressions, the position makes it stable
+      std::ranges::sort(order, std::ranges::greater{}, [&](std::size_t position) {
+        return std::tuple{fields[position].align, fields[position].size, ~position};
+      });
+    }
+
+    /// Size of the object if its fields were laid out in `order`
+    constexpr std::size_t reordered_size(
+      std::span<const field_layout> fields,
+      std::span<const std::size_t>  order,
+      std::size_t                   header,
+      std::size_t                   align
+    ) {
+      std::size_t cursor = header;
+      for (const auto position: order) {
+        cursor = align_up(cursor, fields[position].align) + fields[position].size;
+      }
+      return align_up(std::max<std::size_t>(cursor, 1), align);
+    }
+  } // namespace layout_analysis
+} // namespace refl
+
+namespace refl::detail {
+  template <typename T, std::size_t I>
+  constexpr field_layout make_field_layout() {
+    using type = typename field<T, I>::type;
+    // The plugin reports sizes in bits, references as the pointer that stores them
+    constexpr std::size_t align =
+      std::is_reference_v<type> ? alignof(void*) : alignof(std::remove_cvref_t<type>);
+    return {
+      .index  = I,
+      .name   = field<T, I>::name,
+      .offset = field<T, I>::offset,
+      .size   = field<T, I>::size / 8,
+      .align  = align,
+    };
+  }
+} // namespace refl::detail
+
+export namespace refl {
+  /// Compile time layout report of `T`:
+  ///
+  ///   static_assert(refl::layout<packet>::padding_bytes == 0);
+  ///   std::println("{}", refl::layout<packet>::report());
+  ///
+  /// Fields excluded with `[[refl::ignore]]` are invisible here and show up as holes.
+  template <Reflected T>
+  struct layout {
+    static constexpr std::size_t size        = sizeof(T);
+    static constexpr std::size_t align       = alignof(T);
+    static constexpr std::size_t field_count = refl::field_count<T>;
+
+    /// Fields sorted by offset
+    static constexpr std::array<field_layout, field_count> fields = [] {
+      std::array<field_layout, field_count> result{};
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((result[I] = detail::make_field_layout<T, I>()), ...);
+      }(std::make_index_sequence<field_count>{});
+      std::ranges::sort(result, {}, [](const field_layout& field) {
+        return std::pair{field.offset, field.index};
+      });
+      return result;
+    }();
+
+    static constexpr std::size_t header_bytes = layout_analysis::header_bytes(fields, size);
+    static constexpr std::size_t padding_bytes = layout_analysis::padding_bytes(fields, size);
+    static constexpr std::size_t cache_lines = (size + cache_line_size - 1) / cache_line_size;
+
+    static constexpr auto holes = [] {
+      std::array<layout_hole, layout_analysis::hole_count(fields, size)> result{};
+      std::size_t                                                        next = 0;
+      layout_analysis::for_each_hole(fields, size, [&](const layout_hole& hole) {
+        result[next++] = hole;
+      });
+      return result;
+    }();
+
+    static constexpr std::size_t tail_padding = [] {
+      if (fields.empty()) {
+        return std::size_t{0};
+      }
+      std::size_t end = 0;
+      for (const auto& field: fields) {
+        end = std::max(end, field.end());
+      }
+      return size - end;
+    }();
+
+    /// Field indexes (as in `refl::field<T, I>`) in the order that minimizes padding
+    static constexpr std::array<std::size_t, field_count> suggested_order = [] {
+      std::array<std::size_t, field_count> positions{};
+      layout_analysis::suggest_order(fields, positions);
+      std::array<std::size_t, field_count> result{};
+      for (std::size_t i = 0; i < field_count; ++i) {
+        result[i] = fields[positions[i]].index;
+      }
+      return result;
+    }();
+
+    static constexpr std::size_t suggested_size = [] {
+      std::array<std::size_t, field_count> positions{};
+      layout_analysis::suggest_order(fields, positions);
+      return layout_analysis::reordered_size(fields, positions, header_bytes, align);
+    }();
+
+    static constexpr std::size_t straddling_fields =
+      std::ranges::count_if(fields, &field_layout::straddles_cache_line);
+
+    /// Human readable table of the fields, their cache lines and the holes between them
+    static std::string report() {
+      std::string out{};
+      auto        it = std::back_inserter(out);
+      std::format_to(
+        it,
+        "{}: {} bytes, align {}, {} cache line(s), {} padding byte(s)\n",
+        type_name<T>,
+        size,
+        align,
+        cache_lines,
+        padding_bytes
+      );
+      if (header_bytes > 0) {
+        std::format_to(it, "  {:>6}  {:>6}  bases / vtable\n", 0, header_bytes);
+      }
+
+      std::size_t cursor = header_bytes;
+      for (const auto& field: fields) {
+        if (field.offset > cursor) {
+          std::format_to(it, "  {:>6}  {:>6}  <hole>\n", cursor, field.offset - cursor);
+        }
+        std::format_to(
+          it,
+          "  {:>6}  {:>6}  {} (align {}, line {}{})\n",
+          field.offset,
+          field.size,
+          field.name,
+          field.align,
+          field.first_cache_line(),
+          field.straddles_cache_line() ? std::format("-{}", field.last_cache_line()) : ""
+        );
+        cursor = std::max(cursor, field.end());
+      }
+      if (size > cursor) {
+        std::format_to(it, "  {:>6}  {:>6}  <tail padding>\n", cursor, size - cursor);
+      }
+
+      if (suggested_size < size) {
+        std::format_to(it, "  reordering saves {} byte(s):", size - suggested_size);
+        for (const auto index: suggested_order) {
+          const auto& field = *std::ranges::find(fields, index, &field_layout::index);
+          std::format_to(it, " {}", field.name);
+        }
+        out += '\n';
+      }
+      return out;
+    }
+  };
+
+  template <Reflected T>
+  constexpr std::size_t padding_bytes = layout<T>::padding_bytes;
+} // namespace refl
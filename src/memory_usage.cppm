@@ -0,0 +1,409 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  memory_usage.cppm
+ *! \brief Deep accounting of the memory owned by reflected objects.
+ *!
+ */
+
+export module reflect:memory_usage;
+
+import std;
+
+import packtl;
+
+import :types;
+import :type_name;
+import :accessors;
+import :visitor;
+
+export namespace refl::memory_policy {
+  /// Raw pointers and references are `borrowed` unless annotated `owned`. `skip` ignores
+  /// everything reachable from the field.
+  enum policy_e {
+    owned,
+    borrowed,
+    skip
+  };
+} // namespace refl::memory_policy
+
+export namespace refl {
+  struct memory_usage_options {
+    /// Containers with more elements than this only walk an evenly spaced sample of them and
+    /// scale the result, `0` walks everything
+    std::size_t sample_limit = 0;
+  };
+
+  struct memory_usage_report {
+    /// Everything reached through one field, summed over every instance of its owner
+    struct field_usage {
+      std::string_view owner{};
+      std::string_view name{};
+      std::size_t      bytes     = 0;
+      std::size_t      instances = 0;
+    };
+
+    /// Heap blocks holding values of one type, e.g. a vector's buffer or a map's nodes
+    struct type_usage {
+      std::string_view name{};
+      std::size_t      bytes       = 0;
+      std::size_t      allocations = 0;
+    };
+
+    /// `sizeof` the root object
+    std::size_t inline_bytes = 0;
+    /// Heap owned by the root, including unused capacity and node overhead
+    std::size_t heap_bytes = 0;
+    /// Part of `heap_bytes` allocated but not holding elements
+    std::size_t slack_bytes = 0;
+    /// Part of `heap_bytes` reached through `std::shared_ptr`, each pointee counted once
+    std::size_t shared_bytes = 0;
+
+    /// Sorted by decreasing bytes
+    std::vector<field_usage> fields{};
+    std::vector<type_usage>  types{};
+
+    std::size_t total() const {
+      return inline_bytes + heap_bytes;
+    }
+
+    const field_usage* field(std::string_view owner, std::string_view name) const {
+      const auto it = std::ranges::find_if(fields, [&](const field_usage& usage) {
+        return usage.owner == owner and usage.name == name;
+      });
+      return it == fields.end() ? nullptr : &*it;
+    }
+
+    const type_usage* type(std::string_view name) const {
+      const auto it = std::ranges::find(types, name, &type_usage::name);
+      return it == types.end() ? nullptr : &*it;
+    }
+  };
+
+  template <Reflected R>
+  memory_usage_report memory_usage(const R& obj, const memory_usage_options& options = {});
+} // namespace refl
+
+namespace refl::memory_usage_impl {
+  constexpr std::size_t align_up(std::size_t value, std::size_t align) {
+    return (value + align - 1) / align * align;
+  }
+
+  /// Size of a node holding `V` after `header` bytes of links. Matches the node layouts of the
+  /// common standard libraries closely, but remains an estimate.
+  template <typename V>
+  constexpr std::size_t node_bytes(std::size_t header) {
+    return align_up(
+      align_up(header, alignof(V)) + sizeof(V), std::max(alignof(V), alignof(void*))
+    );
+  }
+
+  // Left, right, parent and the color, padded to a pointer
+  template <typename V>
+  constexpr std::size_t tree_node_bytes = node_bytes<V>(4 * sizeof(void*));
+  // Previous and next
+  template <typename V>
+  constexpr std::size_t list_node_bytes = node_bytes<V>(2 * sizeof(void*));
+  // Next and the cached hash
+  template <typename V>
+  constexpr std::size_t hash_node_bytes = node_bytes<V>(sizeof(void*) + sizeof(std::size_t));
+
+  // Strong and weak counts next to the vtable pointer of the control block
+  constexpr std::size_t shared_control_bytes = 3 * sizeof(void*);
+
+  template <typename T>
+  constexpr std::size_t deque_block_elements = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+
+  /// Values of these types never own memory, containers of them are accounted without
+  /// visiting their elements
+  template <typename T>
+  constexpr bool is_flat = std::is_arithmetic_v<T> or std::is_enum_v<T>;
+
+  /// `std::queue`, `std::stack` and `std::priority_queue` keep their container as `c`
+  template <typename Adaptor>
+  struct adaptor_access: Adaptor {
+    static const typename Adaptor::container_type& get(const Adaptor& adaptor) {
+      return adaptor.*(&adaptor_access::c);
+    }
+  };
+
+  class walker {
+  public:
+    walker(memory_usage_report& report, const memory_usage_options& options)
+        : report_(report),
+          options_(options) {}
+
+    /// Heap owned by `value`, not counting `sizeof(value)` itself
+    template <typename T>
+    std::size_t owned(const T& value) {
+      if constexpr (is_flat<T>) {
+        return 0;
+      } else if constexpr (packtl::is_type<std::basic_string, T>::value) {
+        return string_bytes(value);
+      } else if constexpr (packtl::is_type<std::vector, T>::value) {
+        return vector_bytes(value);
+      } else if constexpr (packtl::is_type<std::deque, T>::value) {
+        return deque_bytes(value);
+      } else if constexpr (packtl::is_type<std::list, T>::value) {
+        return node_container_bytes(value, list_node_bytes<typename T::value_type>);
+      } else if constexpr (packtl::is_type<std::forward_list, T>::value) {
+        return node_container_bytes(value, node_bytes<typename T::value_type>(sizeof(void*)));
+      } else if constexpr (packtl::is_type<std::map, T>::value or
+                           packtl::is_type<std::multimap, T>::value or
+                           packtl::is_type<std::set, T>::value or
+                           packtl::is_type<std::multiset, T>::value) {
+        return node_container_bytes(value, tree_node_bytes<typename T::value_type>);
+      } else if constexpr (packtl::is_type<std::unordered_map, T>::value or
+                           packtl::is_type<std::unordered_multimap, T>::value or
+                           packtl::is_type<std::unordered_set, T>::value or
+                           packtl::is_type<std::unordered_multiset, T>::value) {
+        const std::size_t buckets = value.bucket_count() * sizeof(void*);
+        allocate<void*>(buckets, 0, buckets == 0 ? 0 : 1);
+        return buckets + node_container_bytes(value, hash_node_bytes<typename T::value_type>);
+      } else if constexpr (packtl::is_type<std::queue, T>::value or
+                           packtl::is_type<std::stack, T>::value or
+                           packtl::is_type<std::priority_queue, T>::value) {
+        return owned(adaptor_access<T>::get(value));
+      } else if constexpr (packtl::is_type<std::unique_ptr, T>::value) {
+        return unique_bytes(value);
+      } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
+        return shared_bytes(value);
+      } else if constexpr (packtl::is_type<std::optional, T>::value) {
+        return value.has_value() ? owned(*value) : 0;
+      } else if constexpr (packtl::is_type<std::variant, T>::value) {
+        return std::visit([&](const auto& alternative) { return owned(alternative); }, value);
+      } else if constexpr (packtl::is_type<std::pair, T>::value) {
+        return owned(value.first) + owned(value.second);
+      } else if constexpr (packtl::is_type<std::tuple, T>::value) {
+        return std::apply([&](const auto&... items) { return (owned(items) + ... + 0); }, value);
+      } else if constexpr (std::is_array_v<T> or is_std_array<T>::value) {
+        std::size_t bytes = 0;
+        for (const auto& item: value) {
+          bytes += owned(item);
+        }
+        return bytes;
+      } else if constexpr (Reflected<T>) {
+        return reflected_bytes(value);
+      } else {
+        // Opaque: std::function, handles, weak pointers...
+        return 0;
+      }
+    }
+
+    /// Heap owned through a raw pointer, each pointee counted once
+    template <typename T>
+    std::size_t pointee(const T* ptr) {
+      if constexpr (std::is_void_v<T> or std::is_function_v<T>) {
+        return 0;
+      } else {
+        if (ptr == nullptr or not visited_.insert(ptr).second) {
+          return 0;
+        }
+        allocate<T>(sizeof(T), 0, 1);
+        return sizeof(T) + owned(*ptr);
+      }
+    }
+
+    void finish() {
+      for (auto& [key, usage]: fields_) {
+        report_.fields.push_back(usage);
+      }
+      for (auto& [id, usage]: types_) {
+        report_.types.push_back(usage);
+      }
+      std::ranges::sort(report_.fields, std::ranges::greater{}, &field_usage::bytes);
+      std::ranges::sort(report_.types, std::ranges::greater{}, &type_usage::bytes);
+    }
+
+  private:
+    using field_usage = memory_usage_report::field_usage;
+    using type_usage  = memory_usage_report::type_usage;
+
+    std::size_t scaled(std::size_t bytes) const {
+      return scale_ == 1.0 ? bytes : static_cast<std::size_t>(static_cast<double>(bytes) * scale_);
+    }
+
+    template <typename Elem>
+    void allocate(std::size_t bytes, std::size_t slack, std::size_t allocations) {
+      bytes = scaled(bytes);
+      report_.heap_bytes += bytes;
+      report_.slack_bytes += scaled(slack);
+      auto& usage = types_[type_id<Elem>];
+      usage.name  = type_name<Elem>;
+      usage.bytes += bytes;
+      usage.allocations += scaled(allocations);
+    }
+
+    /// Heap owned by the elements of `range`, sampled when there are too many of them
+    template <typename Range>
+    std::size_t elements_bytes(const Range& range, std::size_t size) {
+      using value_type = std::ranges::range_value_t<Range>;
+      if constexpr (is_flat<value_type>) {
+        return 0;
+      } else {
+        if (size == 0) {
+          return 0;
+        }
+        std::size_t stride = 1;
+        if (options_.sample_limit != 0 and size > options_.sample_limit) {
+          stride = (size + options_.sample_limit - 1) / options_.sample_limit;
+        }
+        const std::size_t sampled = (size + stride - 1) / stride;
+        const double      factor  = static_cast<double>(size) / static_cast<double>(sampled);
+        const double      outer   = scale_;
+        scale_ *= factor;
+
+        std::size_t bytes = 0;
+        std::size_t index = 0;
+        for (const auto& item: range) {
+          if (index++ % stride == 0) {
+            bytes += owned(item);
+          }
+        }
+        scale_ = outer;
+        return stride == 1 ? bytes : static_cast<std::size_t>(static_cast<double>(bytes) * factor);
+      }
+    }
+
+    template <typename S>
+    std::size_t string_bytes(const S& str) {
+      using char_type = typename S::value_type;
+      // Short strings live inside the object itself
+      const auto* data  = reinterpret_cast<const char*>(str.data());
+      const auto* begin = reinterpret_cast<const char*>(&str);
+      if (data >= begin and data < begin + sizeof(S)) {
+        return 0;
+      }
+      const std::size_t bytes = (str.capacity() + 1) * sizeof(char_type);
+      allocate<char_type>(bytes, (str.capacity() - str.size()) * sizeof(char_type), 1);
+      return bytes;
+    }
+
+    template <typename V>
+    std::size_t vector_bytes(const V& vec) {
+      using value_type = typename V::value_type;
+      if (vec.capacity() == 0) {
+        return 0;
+      }
+      if constexpr (std::same_as<value_type, bool>) {
+        const std::size_t words = (vec.capacity() + 63) / 64;
+        allocate<bool>(words * 8, words * 8 - (vec.size() + 7) / 8, 1);
+        return words * 8;
+      } else {
+        const std::size_t bytes = vec.capacity() * sizeof(value_type);
+        allocate<value_type>(bytes, (vec.capacity() - vec.size()) * sizeof(value_type), 1);
+        return bytes + elements_bytes(vec, vec.size());
+      }
+    }
+
+    template <typename D>
+    std::size_t deque_bytes(const D& deque) {
+      using value_type               = typename D::value_type;
+      constexpr std::size_t per_block = deque_block_elements<value_type>;
+      if (deque.empty()) {
+        return 0;
+      }
+      const std::size_t blocks = (deque.size() + per_block - 1) / per_block;
+      const std::size_t bytes  = blocks * per_block * sizeof(value_type);
+      allocate<value_type>(bytes, bytes - deque.size() * sizeof(value_type), blocks);
+      allocate<void*>(blocks * sizeof(void*), 0, 1);
+      return bytes + blocks * sizeof(void*) + elements_bytes(deque, deque.size());
+    }
+
+    template <typename C>
+    std::size_t node_container_bytes(const C& container, std::size_t node) {
+      using value_type = typename C::value_type;
+      const std::size_t size =
+        static_cast<std::size_t>(std::ranges::distance(container.begin(), container.end()));
+      const std::size_t bytes = size * node;
+      allocate<value_type>(bytes, size * (node - sizeof(value_type)), size);
+      return bytes + elements_bytes(container, size);
+    }
+
+    template <typename P>
+    std::size_t unique_bytes(const P& ptr) {
+      using element_type = typename P::element_type;
+      // Neither the length of an array nor the dynamic type of the pointee is known
+      if constexpr (std::is_array_v<element_type>) {
+        return 0;
+      } else {
+        return pointee(ptr.get());
+      }
+    }
+
+    template <typename P>
+    std::size_t shared_bytes(const P& ptr) {
+      using element_type = typename P::element_type;
+      if constexpr (std::is_array_v<element_type> or std::is_void_v<element_type>) {
+        return 0;
+      } else {
+        if (ptr == nullptr or not visited_.insert(ptr.get()).second) {
+          return 0;
+        }
+        const std::size_t block = sizeof(element_type) + shared_control_bytes;
+        allocate<element_type>(block, 0, 1);
+        const std::size_t bytes = block + owned(*ptr);
+        report_.shared_bytes += scaled(bytes);
+        return bytes;
+      }
+    }
+
+    template <Reflected R>
+    std::size_t reflected_bytes(const R& obj) {
+      return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return (field_bytes<R, field<R, I>>(obj) + ... + 0);
+      }(std::make_index_sequence<field_count<R>>{});
+    }
+
+    template <Reflected R, typename Field>
+    std::size_t field_bytes(const R& obj) {
+      memory_policy::policy_e policy{memory_policy::borrowed};
+      if constexpr (Field::template has_metadata<memory_policy::policy_e>) {
+        policy = Field::template get_metadata<memory_policy::policy_e>;
+      }
+      if (policy == memory_policy::skip) {
+        return 0;
+      }
+
+      const auto& value = Field::from_instance(obj);
+      std::size_t bytes = 0;
+      if constexpr (Field::is_reference) {
+        bytes = policy == memory_policy::owned ? pointee(&value) : 0;
+      } else if constexpr (Field::is_pointer) {
+        bytes = policy == memory_policy::owned ? pointee(value) : 0;
+      } else {
+        bytes = owned(value);
+      }
+
+      auto& usage = fields_[{type_id<R>, Field::index}];
+      usage.owner = type_name<R>;
+      usage.name  = Field::name;
+      usage.bytes += scaled(Field::size / 8 + bytes);
+      usage.instances += scaled(1);
+      return bytes;
+    }
+
+  private:
+    memory_usage_report&                               report_;
+    const memory_usage_options&                        options_;
+    double                                             scale_ = 1.0;
+    std::unordered_set<const void*>                    visited_{};
+    std::map<std::pair<type_id_t, std::size_t>, field_usage> fields_{};
+    std::unordered_map<type_id_t, type_usage>          types_{};
+  };
+} // namespace refl::memory_usage_impl
+
+namespace refl {
+  /// Walks `obj` the way `deep_eq` does and accounts for the memory it owns. Standard containers,
+  /// strings and smart pointers are understood, node sizes and deque blocks are estimated from
+  /// the usual standard library layouts. Objects behind `std::shared_ptr` are counted once, for
+  /// the first field that reaches them. Pointees are accounted by their static type.
+  template <Reflected R>
+  memory_usage_report memory_usage(const R& obj, const memory_usage_options& options) {
+    memory_usage_report      report{.inline_bytes = sizeof(R)};
+    memory_usage_impl::walker walker{report, options};
+    walker.owned(obj);
+    walker.finish();
+    return report;
+  }
+} // namespace refl
@@ -0,0 +1,126 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  parallel.cppm
+ *! \brief Execution policy and task runner for the parallel deep operations.
+ *!
+ */
+
+export module reflect:parallel;
+
+import std;
+
+export namespace refl {
+  /// Opts a deep operation into running on several threads, e.g. `refl::deep_eq(a, b, refl::par)`
+  struct parallel_policy {
+    /// `0` uses every hardware thread
+    std::size_t threads = 0;
+    /// Random access containers with at least this many elements are split into chunks of this
+    /// size, smaller ones are handled by a single task
+    std::size_t min_chunk = std::size_t{1} << 14;
+  };
+
+  inline constexpr parallel_policy par{};
+} // namespace refl
+
+namespace refl::parallel_impl {
+  /// Work of one parallel operation, cut into independent tasks up front. Threads take the next
+  /// task from a shared counter, so a thread that finishes early moves on to whatever is left.
+  class task_list {
+  public:
+    explicit task_list(const parallel_policy& policy)
+        : policy_(policy) {}
+
+    const parallel_policy& policy() const {
+      return policy_;
+    }
+
+    /// Set once the result is known, tasks are expected to poll it and return early
+    bool stopped() const {
+      return stop_.load(std::memory_order_relaxed);
+    }
+
+    void stop() {
+      stop_.store(true, std::memory_order_relaxed);
+    }
+
+    void add(std::function<void()> task) {
+      tasks_.push_back(std::move(task));
+    }
+
+    /// `[0, size)` cut into chunks of `chunk` elements, `task(begin, end)` is added for each
+    template <typename F>
+    void add_chunks(std::size_t size, std::size_t chunk, F&& task) {
+      chunk = std::max<std::size_t>(chunk, 1);
+      for (std::size_t begin = 0; begin < size; begin += chunk) {
+        add([task, begin, end = std::min(begin + chunk, size)] {
+          task(begin, end);
+        });
+      }
+    }
+
+    /// Runs every task that is not skipped by `stop()`. Rethrows the exception of the lowest
+    /// failing task, the tasks after it are skipped.
+    void run() {
+      const std::size_t hardware = std::thread::hardware_concurrency();
+      const std::size_t threads  = std::min(
+        std::max<std::size_t>(policy_.threads != 0 ? policy_.threads : hardware, 1), tasks_.size()
+      );
+
+      std::atomic<std::size_t>        next{0};
+      std::atomic<std::size_t>        failed{tasks_.size()};
+      std::vector<std::exception_ptr> errors(tasks_.size());
+      const auto                      work = [&] {
+        for (std::size_t i = next.fetch_add(1); i < tasks_.size(); i = next.fetch_add(1)) {
+          // Tasks are handed out in order, every later one is past the failure too
+          if (stopped() or i > failed.load(std::memory_order_relaxed)) {
+            return;
+          }
+          try {
+            tasks_[i]();
+          } catch (...) {
+            errors[i] = std::current_exception();
+            // Skip what follows `i`, unless an earlier task already failed
+            std::size_t lowest = failed.load(std::memory_order_relaxed);
+            while (i < lowest and not failed.compare_exchange_weak(lowest, i)) {}
+          }
+        }
+      };
+
+      std::vector<std::thread> workers{};
+      workers.reserve(threads > 0 ? threads - 1 : 0);
+      for (std::size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(work);
+      }
+      work();
+      for (auto& worker: workers) {
+        worker.join();
+      }
+      for (const auto& error: errors) {
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+    }
+
+  private:
+    parallel_policy                    policy_;
+    std::vector<std::function<void()>> tasks_{};
+    std::atomic<bool>                  stop_{false};
+  };
+} // namespace refl::parallel_impl
+
+export namespace refl {
+  /// Runs `task(i)` for every `i < tasks` on the threads of `policy`, tasks being handed out in
+  /// order. Rethrows the exception of the lowest failing task.
+  template <typename F>
+  void parallel_for(const parallel_policy& policy, std::size_t tasks, F&& task) {
+    parallel_impl::task_list list{policy};
+    for (std::size_t i = 0; i < tasks; ++i) {
+      list.add([&task, i] {
+        task(i);
+      });
+    }
+    list.run();
+  }
+} // namespace refl
@@ -0,0 +1,276 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  query.cppm
+ *! \brief Batched filtering and projection over contiguous sequences of reflected types.
+ *!
+ */
+
+export module reflect:query;
+
+import std;
+
+import :types;
+import :accessors;
+import :soa_vector;
+import :parallel;
+
+export namespace refl {
+  /// Comparisons accepted by `query::where`, any binary predicate works as well
+  namespace ops {
+    inline constexpr std::ranges::equal_to      eq{};
+    inline constexpr std::ranges::not_equal_to  ne{};
+    inline constexpr std::ranges::less          lt{};
+    inline constexpr std::ranges::less_equal    le{};
+    inline constexpr std::ranges::greater       gt{};
+    inline constexpr std::ranges::greater_equal ge{};
+  } // namespace ops
+
+  /// Filters rows of `T` by field value, e.g.
+  ///
+  ///   refl::query<order>(orders).where<"price">(refl::ops::gt, 100).select<"id", "qty">()
+  ///
+  /// Field names are resolved at compile time. Each field is read through a base pointer and a
+  /// stride (`field<T, I>::offset` and `sizeof(T)` for a span of rows, the column itself for a
+  /// `soa_vector`), so predicates only touch the bytes of the field they test. Predicates are
+  /// evaluated eagerly, 64 rows at a time, and AND-ed into a selection bitmap. Arithmetic fields
+  /// are gathered into a contiguous block per batch so the comparison loop vectorizes.
+  ///
+  /// The source must outlive the query.
+  template <Reflected T>
+  class query {
+  public:
+    static constexpr std::size_t field_count = refl::field_count<T>;
+    static constexpr std::size_t batch_size  = 64;
+
+    template <std::size_t I>
+    using field_type = std::remove_cvref_t<typename field<T, I>::type>;
+
+    template <field_name Name>
+    static constexpr std::size_t index_of = [] {
+      static_assert(field_index<T, Name> < field_count, "no field with that name");
+      static_assert(
+        not field<T, field_index<T, Name>>::is_reference, "reference fields can not be queried"
+      );
+      return field_index<T, Name>;
+    }();
+
+    explicit query(std::span<const T> rows)
+        : rows_(rows.data()),
+          size_(rows.size()) {
+      if (not rows.empty()) {
+        const auto* base = reinterpret_cast<const std::byte*>(rows.data());
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          ((bases_[I] = base + field<T, I>::offset, strides_[I] = sizeof(T)), ...);
+        }(std::make_index_sequence<field_count>{});
+      }
+      reset();
+    }
+
+    explicit query(const soa_vector<T>& rows)
+        : soa_(&rows),
+          size_(rows.size()) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((bases_[I]   = reinterpret_cast<const std::byte*>(rows.template column<I>().data()),
+          strides_[I] = sizeof(field_type<I>)),
+         ...);
+      }(std::make_index_sequence<field_count>{});
+      reset();
+    }
+
+    /// Splits predicate evaluation across `threads` workers, predicates must then be safe to call
+    /// concurrently. Small inputs stay on the calling thread regardless.
+    query& parallel(std::size_t threads = std::thread::hardware_concurrency()) {
+      threads_ = std::max<std::size_t>(threads, 1);
+      return *this;
+    }
+
+    /// Keeps the rows whose field `Name` satisfies `pred(field, value)`
+    template <field_name Name, typename Pred, typename V>
+    query& where(Pred pred, const V& value) {
+      constexpr std::size_t I = index_of<Name>;
+      for_word_ranges([&](std::size_t first, std::size_t last) {
+        filter_field<I>(first, last, pred, value);
+      });
+      return *this;
+    }
+
+    /// Keeps the rows for which `pred(row)` holds. Rows of a `soa_vector` are materialized first.
+    template <typename Pred>
+    query& where(Pred pred) {
+      for_word_ranges([&](std::size_t first, std::size_t last) {
+        for (std::size_t w = first; w < last; ++w) {
+          std::uint64_t hits = 0;
+          for_each_bit(words_[w], [&](std::size_t bit) {
+            const std::size_t index = w * batch_size + bit;
+            if (soa_ != nullptr ? pred(soa_->load(index)) : pred(rows_[index])) {
+              hits |= std::uint64_t{1} << bit;
+            }
+          });
+          words_[w] = hits;
+        }
+      });
+      return *this;
+    }
+
+    /// Selects every row again
+    query& reset() {
+      words_.assign((size_ + batch_size - 1) / batch_size, ~std::uint64_t{0});
+      if (const std::size_t tail = size_ % batch_size; tail != 0) {
+        words_.back() = (std::uint64_t{1} << tail) - 1;
+      }
+      return *this;
+    }
+
+    std::size_t size() const {
+      return size_;
+    }
+
+    std::size_t count() const {
+      std::size_t total = 0;
+      for (const auto word: words_) {
+        total += static_cast<std::size_t>(std::popcount(word));
+      }
+      return total;
+    }
+
+    /// One bit per row, row `i` is bit `i % 64` of word `i / 64`
+    std::span<const std::uint64_t> selection() const {
+      return words_;
+    }
+
+    bool selected(std::size_t index) const {
+      return (words_[index / batch_size] >> (index % batch_size) & 1U) != 0;
+    }
+
+    /// Calls `func(index)` for every selected row, in order
+    template <typename F>
+    void for_each(F&& func) const {
+      for (std::size_t w = 0; w < words_.size(); ++w) {
+        for_each_bit(words_[w], [&](std::size_t bit) { func(w * batch_size + bit); });
+      }
+    }
+
+    std::vector<std::size_t> indices() const {
+      std::vector<std::size_t> result{};
+      result.reserve(count());
+      for_each([&](std::size_t index) { result.push_back(index); });
+      return result;
+    }
+
+    /// Copies fields `Names...` of every selected row
+    template <field_name... Names>
+    std::vector<std::tuple<field_type<index_of<Names>>...>> select() const {
+      std::vector<std::tuple<field_type<index_of<Names>>...>> result{};
+      result.reserve(count());
+      for_each([&](std::size_t index) {
+        result.emplace_back(get<index_of<Names>>(index)...);
+      });
+      return result;
+    }
+
+    /// Copies every selected row
+    std::vector<T> collect() const {
+      std::vector<T> result{};
+      result.reserve(count());
+      for_each([&](std::size_t index) { result.push_back(row(index)); });
+      return result;
+    }
+
+    /// Sum of an arithmetic field over the selected rows, accumulated in `double` or a 64 bit
+    /// integer
+    template <field_name Name>
+      requires std::is_arithmetic_v<field_type<index_of<Name>>>
+    auto sum() const {
+      constexpr std::size_t I = index_of<Name>;
+      using F                 = field_type<I>;
+      using acc_t             = std::conditional_t<
+        std::is_floating_point_v<F>,
+        double,
+        std::conditional_t<std::is_signed_v<F>, std::int64_t, std::uint64_t>>;
+
+      acc_t total{};
+      for_each([&](std::size_t index) { total += static_cast<acc_t>(get<I>(index)); });
+      return total;
+    }
+
+    template <std::size_t I>
+    const field_type<I>& get(std::size_t index) const {
+      const auto* ptr = bases_[I] + index * strides_[I];
+      return *std::launder(reinterpret_cast<const field_type<I>*>(ptr));
+    }
+
+  private:
+    T row(std::size_t index) const {
+      return soa_ != nullptr ? soa_->load(index) : rows_[index];
+    }
+
+    template <typename F>
+    static void for_each_bit(std::uint64_t word, F&& func) {
+      while (word != 0) {
+        func(static_cast<std::size_t>(std::countr_zero(word)));
+        word &= word - 1;
+      }
+    }
+
+    template <std::size_t I, typename Pred, typename V>
+    void filter_field(std::size_t first, std::size_t last, Pred& pred, const V& value) {
+      using F = field_type<I>;
+
+      for (std::size_t w = first; w < last; ++w) {
+        if (words_[w] == 0) {
+          continue;
+        }
+        const std::size_t begin = w * batch_size;
+        const std::size_t count = std::min(batch_size, size_ - begin);
+
+        std::uint64_t hits = 0;
+        if constexpr (std::is_arithmetic_v<F>) {
+          // Gather the strided field into a contiguous block, then compare without branches
+          F    block[batch_size];
+          bool mask[batch_size]{};
+          for (std::size_t j = 0; j < count; ++j) {
+            block[j] = get<I>(begin + j);
+          }
+          for (std::size_t j = 0; j < count; ++j) {
+            mask[j] = static_cast<bool>(pred(block[j], value));
+          }
+          for (std::size_t j = 0; j < count; ++j) {
+            hits |= std::uint64_t{mask[j]} << j;
+          }
+        } else {
+          for_each_bit(words_[w], [&](std::size_t bit) {
+            if (pred(get<I>(begin + bit), value)) {
+              hits |= std::uint64_t{1} << bit;
+            }
+          });
+        }
+        words_[w] &= hits;
+      }
+    }
+
+    /// Runs `body(first_word, last_word)` over the whole bitmap, split across `threads_` workers.
+    /// Workers own disjoint word ranges so they never write to the same word.
+    template <typename F>
+    void for_word_ranges(F&& body) {
+      static constexpr std::size_t min_words_per_thread = 256;
+
+      const std::size_t words = words_.size();
+      const std::size_t workers =
+        std::clamp<std::size_t>(words / min_words_per_thread, 1, threads_);
+      const std::size_t per_worker = (words + workers - 1) / workers;
+      parallel_for(parallel_policy{.threads = workers}, workers, [&](std::size_t worker) {
+        body(std::min(words, worker * per_worker), std::min(words, (worker + 1) * per_worker));
+      });
+    }
+
+  private:
+    const T*                                  rows_ = nullptr;
+    const soa_vector<T>*                      soa_  = nullptr;
+    std::size_t                               size_ = 0;
+    std::array<const std::byte*, field_count> bases_{};
+    std::array<std::size_t, field_count>      strides_{};
+    std::vector<std::uint64_t>                words_{};
+    std::size_t                               threads_ = 1;
+  };
+} // namespace refl
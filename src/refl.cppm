@@ -13,9 +13,24 @@ export import std;
 export import :types;
 export import :type_name;
 export import :accessors;
+export import :value_visitor;
 export import :type_info;
 export import :visitor;
 
+export import :parallel;
 export import :equality;
+export import :hash;
+export import :clone;
 export import :any;
 export import :archive;
+export import :tracked;
+export import :versioned;
+export import :soa_vector;
+export import :query;
+export import :indexed_table;
+export import :sort;
+export import :compiled_path;
+export import :layout;
+export import :memory_usage;
+export import :instrumentation;
+export import :generate;
@@ -0,0 +1,312 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  chunked.cppm
+ *! \brief Resumable serialization that hands out output in bounded chunks.
+ *!
+ */
+
+export module reflect.marshal.chunked;
+
+import std;
+
+import reflect.marshal.sink;
+import reflect.marshal.formats.default_fmt;
+
+export namespace refl {
+  /// Fixed capacity sink. When the buffer is full it hands control back to whoever is consuming
+  /// the chunks and only continues once they ask for the next one.
+  class chunk_sink {
+  public:
+    using yield_fn = void (*)(void* context);
+
+    chunk_sink(std::size_t capacity, yield_fn yield, void* context)
+        : buffer_(std::make_unique_for_overwrite<char[]>(capacity)),
+          capacity_(capacity),
+          yield_(yield),
+          context_(context) {
+      if (capacity == 0) {
+        throw std::invalid_argument("chunk_sink capacity must be greater than zero");
+      }
+    }
+
+    chunk_sink(const chunk_sink&)            = delete;
+    chunk_sink& operator=(const chunk_sink&) = delete;
+
+    void write(std::string_view str) {
+      while (not str.empty()) {
+        if (size_ == capacity_) {
+          yield_(context_);
+        }
+        const std::size_t count = std::min(capacity_ - size_, str.size());
+        std::memcpy(buffer_.get() + size_, str.data(), count);
+        size_ += count;
+        str.remove_prefix(count);
+      }
+    }
+
+    void put(char c) {
+      write(std::string_view{&c, 1});
+    }
+
+    auto inserter() {
+      return sink_iterator<chunk_sink>{this};
+    }
+
+    void clear() {
+      size_ = 0;
+    }
+
+    std::string_view view() const {
+      return {buffer_.get(), size_};
+    }
+
+    std::size_t size() const {
+      return size_;
+    }
+
+    std::size_t capacity() const {
+      return capacity_;
+    }
+
+    chunk_sink& operator<<(std::string_view str) {
+      write(str);
+      return *this;
+    }
+
+    chunk_sink& operator<<(char c) {
+      put(c);
+      return *this;
+    }
+
+  private:
+    std::unique_ptr<char[]> buffer_;
+    std::size_t             capacity_;
+    std::size_t             size_ = 0;
+    yield_fn                yield_;
+    void*                   context_;
+  };
+
+  /// Lazily produced sequence of serialized chunks. Each chunk is only valid until the iterator is
+  /// advanced.
+  class chunk_generator {
+  public:
+    struct promise_type {
+      std::string_view   current{};
+      std::exception_ptr error{};
+
+      chunk_generator get_return_object() {
+        return chunk_generator{handle_t::from_promise(*this)};
+      }
+
+      std::suspend_always initial_suspend() noexcept {
+        return {};
+      }
+
+      std::suspend_always final_suspend() noexcept {
+        return {};
+      }
+
+      std::suspend_always yield_value(std::string_view chunk) noexcept {
+        current = chunk;
+        return {};
+      }
+
+      void return_void() noexcept {}
+
+      void unhandled_exception() {
+        error = std::current_exception();
+      }
+    };
+
+    using handle_t = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type        = std::string_view;
+      using difference_type   = std::ptrdiff_t;
+
+      iterator() = default;
+
+      explicit iterator(handle_t handle)
+          : handle_(handle) {}
+
+      std::string_view operator*() const {
+        return handle_.promise().current;
+      }
+
+      iterator& operator++() {
+        advance(handle_);
+        return *this;
+      }
+
+      void operator++(int) {
+        ++*this;
+      }
+
+      friend bool operator==(const iterator& it, std::default_sentinel_t) {
+        return it.handle_ == nullptr or it.handle_.done();
+      }
+
+    private:
+      handle_t handle_{};
+    };
+
+    chunk_generator(const chunk_generator&)            = delete;
+    chunk_generator& operator=(const chunk_generator&) = delete;
+
+    chunk_generator(chunk_generator&& rhs) noexcept
+        : handle_(std::exchange(rhs.handle_, {})) {}
+
+    chunk_generator& operator=(chunk_generator&& rhs) noexcept {
+      if (this != &rhs) {
+        if (handle_) {
+          handle_.destroy();
+        }
+        handle_ = std::exchange(rhs.handle_, {});
+      }
+      return *this;
+    }
+
+    ~chunk_generator() {
+      if (handle_) {
+        handle_.destroy();
+      }
+    }
+
+    iterator begin() {
+      advance(handle_);
+      return iterator{handle_};
+    }
+
+    std::default_sentinel_t end() {
+      return {};
+    }
+
+  private:
+    explicit chunk_generator(handle_t handle)
+        : handle_(handle) {}
+
+    static void advance(handle_t handle) {
+      handle.resume();
+      if (auto error = std::exchange(handle.promise().error, {})) {
+        std::rethrow_exception(error);
+      }
+    }
+
+  private:
+    handle_t handle_{};
+  };
+
+  namespace detail {
+    /// Thrown inside an abandoned serialization to unwind the serializer's stack.
+    struct serialization_cancelled {};
+
+    /// Runs a serializer on a thread of its own so it can be suspended from deep inside the
+    /// visitor recursion every time the chunk buffer fills up. Only one side runs at a time, each
+    /// hands control to the other through a semaphore.
+    class serialize_worker {
+    public:
+      using body_t = std::function<void(chunk_sink&)>;
+
+      serialize_worker(std::size_t chunk_size, body_t body)
+          : body_(std::move(body)),
+            sink_(chunk_size, &serialize_worker::yield, this) {}
+
+      serialize_worker(const serialize_worker&)            = delete;
+      serialize_worker& operator=(const serialize_worker&) = delete;
+
+      ~serialize_worker() {
+        if (worker_.joinable()) {
+          if (not done_) {
+            cancel_ = true;
+            resume_.release();
+          }
+          worker_.join();
+        }
+      }
+
+      /// Runs the serializer until the next chunk is ready. Returns `false` once everything has
+      /// been handed out.
+      bool resume() {
+        if (done_) {
+          return false;
+        }
+        if (worker_.joinable()) {
+          resume_.release();
+        } else {
+          worker_ = std::thread{&serialize_worker::run, this};
+        }
+        ready_.acquire();
+        if (auto error = std::exchange(error_, {})) {
+          std::rethrow_exception(error);
+        }
+        return not done_ or sink_.size() > 0;
+      }
+
+      std::string_view chunk() const {
+        return sink_.view();
+      }
+
+    private:
+      void run() {
+        try {
+          body_(sink_);
+        } catch (const serialization_cancelled&) {
+        } catch (...) {
+          error_ = std::current_exception();
+        }
+        done_ = true;
+        ready_.release();
+      }
+
+      static void yield(void* context) {
+        auto* self = static_cast<serialize_worker*>(context);
+        self->ready_.release();
+        self->resume_.acquire();
+        if (self->cancel_) {
+          throw serialization_cancelled{};
+        }
+        self->sink_.clear();
+      }
+
+    private:
+      body_t                body_;
+      chunk_sink            sink_;
+      std::thread           worker_{};
+      std::binary_semaphore resume_{0};
+      std::binary_semaphore ready_{0};
+      std::exception_ptr    error_{};
+      bool                  done_   = false;
+      bool                  cancel_ = false;
+    };
+  } // namespace detail
+
+  /// Serializes `obj` in chunks of at most `chunk_size` bytes, producing the next chunk only when
+  /// the consumer asks for it. `obj` must outlive the generator. Abandoning the generator, or
+  /// requesting a stop on `stop`, unwinds the in-progress serialization cleanly. The format runs
+  /// on a thread of its own, which waits while the consumer holds a chunk.
+  template <template <typename> typename Format = formats::default_fmt, typename T>
+  chunk_generator serialize_chunks(
+    const T&                                       obj,
+    std::size_t                                    chunk_size,
+    std::stop_token                                stop,
+    typename Format<chunk_sink>::args_t            args = {}
+  ) {
+    detail::serialize_worker worker{chunk_size, [&obj, args](chunk_sink& sink) {
+      auto format = Format<chunk_sink>{sink, args};
+      format.serialize(obj);
+    }};
+    while (not stop.stop_requested() and worker.resume()) {
+      co_yield worker.chunk();
+    }
+  }
+
+  template <template <typename> typename Format = formats::default_fmt, typename T>
+  chunk_generator serialize_chunks(
+    const T& obj, std::size_t chunk_size, typename Format<chunk_sink>::args_t args = {}
+  ) {
+    return serialize_chunks<Format>(obj, chunk_size, std::stop_token{}, args);
+  }
+} // namespace refl
@@ -12,6 +12,7 @@ import std;
 
 import packtl;
 import reflect;
+import reflect.marshal.sink;
 
 export namespace serialize::policy {
   enum policy_e {
@@ -28,6 +29,9 @@ export namespace serialize {
   struct name {
     std::string value;
   };
+  /// Marks a field whose value never changes once built (a lookup table, a catalog), so its
+  /// output can be served from a `refl::serialization_cache`
+  struct immutable {};
 }
 
 
@@ -46,9 +50,7 @@ export namespace formats {
     void print_obj_field_impl(O& out, const R& obj, std::size_t indent) {
       using f = refl::field<R, I>;
 
-      for (std::size_t i = 0; i < std::max((indent * args.indent), 0UL); ++i) {
-        out << " ";
-      }
+      refl::write_indent(out, indent * args.indent);
 
       switch (f::access) {
         case refl::access_spec::NONE:
@@ -78,7 +80,7 @@ export namespace formats {
       if constexpr (std::is_reference_v<typename f::type>) {
         const auto& it = f::from_instance(obj);
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)&it);
+        refl::write_format(out, "0x{:X}", (std::size_t)&it);
         out << "} ";
 
         // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -88,7 +90,7 @@ export namespace formats {
       } else if constexpr (std::is_pointer_v<typename f::type>) {
         const auto* it = f::from_instance(obj);
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)it);
+        refl::write_format(out, "0x{:X}", (std::size_t)it);
         out << "} ";
 
         // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -111,18 +113,14 @@ export namespace formats {
       }
       // }
 
-      out << std::endl;
+      out << '\n';
     }
 
     template <typename O, refl::Reflected R, std::size_t... I>
     void print_obj_impl(O& out, const R& obj, std::size_t indent, std::index_sequence<I...>) {
       out << refl::type_name<R> << " {" << "\n";
       ((print_obj_field_impl<O, R, I>(out, obj, indent + 1)), ...);
-      for (std::size_t i = 0; i < indent; ++i) {
-        for (std::size_t j = 0; j < args.indent; ++j) {
-          out << " ";
-        }
-      }
+      refl::write_indent(out, indent * args.indent);
       out << "}";
     }
 
@@ -163,16 +161,14 @@ export namespace formats {
     template <typename O, typename T>
     void print_std_iterable(O& out, const T& it, std::size_t indent) {
       using item_type = typename T::value_type;
-      out << "[" << std::endl;
+      out << "[\n";
       for (auto item = it.begin(); item != it.end(); ++item) {
-        for (std::size_t i = 0; i < std::max((indent * args.indent), 0UL); ++i) {
-          out << " ";
-        }
+        refl::write_indent(out, indent * args.indent);
 
         if constexpr (std::is_reference_v<item_type>) {
           const auto& value = *item;
           out << " {";
-          out << std::format("0x{:X}", (std::size_t)&value);
+          refl::write_format(out, "0x{:X}", (std::size_t)&value);
           out << "} ";
 
           // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -182,7 +178,7 @@ export namespace formats {
         } else if constexpr (std::is_pointer_v<item_type>) {
           const auto* value = *item;
           out << " {";
-          out << std::format("0x{:X}", (std::size_t)value);
+          refl::write_format(out, "0x{:X}", (std::size_t)value);
           out << "} ";
 
           // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -205,11 +201,9 @@ export namespace formats {
             out << " }";
           }
         }
-        out << "," << std::endl;
-      }
-      for (std::size_t i = 0; i < std::max((indent * args.indent), 0UL); ++i) {
-        out << " ";
+        out << ",\n";
       }
+      refl::write_indent(out, indent * args.indent);
       out << "]";
     }
 
@@ -222,7 +216,7 @@ export namespace formats {
       if constexpr (std::is_reference_v<item_type_1>) {
         const auto& value = it.first;
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)&value);
+        refl::write_format(out, "0x{:X}", (std::size_t)&value);
         out << "} ";
 
         // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -232,7 +226,7 @@ export namespace formats {
       } else if constexpr (std::is_pointer_v<item_type_1>) {
         const auto* value = it.first;
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "} ";
 
         // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -259,7 +253,7 @@ export namespace formats {
       if constexpr (std::is_reference_v<item_type_2>) {
         const auto& value = it.second;
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)&value);
+        refl::write_format(out, "0x{:X}", (std::size_t)&value);
         out << "} ";
 
         // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -269,7 +263,7 @@ export namespace formats {
       } else if constexpr (std::is_pointer_v<item_type_2>) {
         const auto* value = it.second;
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "} ";
 
         // if constexpr (refl::Reflected<std::remove_reference_t<typename f::type>>) {
@@ -320,19 +314,19 @@ export namespace formats {
       } else if constexpr (packtl::is_type<std::unique_ptr, T>::value) {
         const auto* value = it.get();
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "} ";
         print_any(out, *value, indent);
       } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
         const auto* value = it.get();
         out << "{";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "} ";
         print_any(out, *value, indent);
       } else if constexpr (packtl::is_type<std::weak_ptr, T>::value) {
         const auto* value = it.get();
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "}: ";
         print_any(out, *value, indent);
       } else if constexpr (refl::Reflected<T>) {
@@ -343,11 +337,11 @@ export namespace formats {
         visited_.emplace((std::size_t)&it);
         print_obj(out, it, indent);
       } else if constexpr (std::is_convertible_v<T, std::string>) {
-        out << std::format("{:?}", it);
+        refl::write_format(out, "{:?}", it);
       } else if constexpr (std::same_as<T, char>) {
-        out << std::format("0x{:X} '{}'", (int)it, it);
+        refl::write_format(out, "0x{:X} '{}'", (int)it, it);
       } else if constexpr (std::formattable<T, char>) {
-        out << std::format("{}", it);
+        refl::write_format(out, "{}", it);
       }
     }
 
@@ -0,0 +1,705 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  binary.cppm
+ *! \brief Writer and reader shared by the self-describing binary formats, MessagePack and CBOR.
+ *!
+ */
+
+export module reflect.marshal.formats.binary;
+
+import std;
+
+import packtl;
+import reflect;
+
+import reflect.marshal.formats.base;
+import reflect.marshal.sink;
+
+export namespace formats {
+  struct binary_fmt_args {};
+
+  /// What a header announces
+  enum class binary_kind : unsigned char {
+    nil,
+    boolean,
+    /// Unsigned integer in `value`
+    uint,
+    /// Negative integer, `-1 - value`
+    nint,
+    floating,
+    text,
+    bytes,
+    array,
+    map,
+    /// A tagged item follows (CBOR)
+    tag,
+    /// Closes an indefinite length item (CBOR)
+    end,
+    /// Any other simple value, which can only be skipped
+    simple,
+  };
+
+  /// A decoded header. Strings are followed by `value` bytes, containers by `value` elements, or
+  /// by chunks or elements up to an `end` when `indefinite`.
+  struct binary_token {
+    binary_kind   kind       = binary_kind::nil;
+    std::uint64_t value      = 0;
+    double        real       = 0.0;
+    bool          indefinite = false;
+  };
+
+  namespace detail {
+    /// `lead`, then the low `bytes` bytes of `value`, most significant first
+    template <typename O>
+    void write_big_endian(O& out, std::uint8_t lead, std::uint64_t value, std::size_t bytes) {
+      std::array<char, 9> buffer{static_cast<char>(lead)};
+      for (std::size_t i = 0; i < bytes; ++i) {
+        buffer[bytes - i] = static_cast<char>(value >> (8 * i));
+      }
+      refl::write(out, std::string_view{buffer.data(), bytes + 1});
+    }
+
+    /// `bytes` bytes at `pos`, most significant first. False if the input ends before.
+    inline bool read_big_endian(
+      std::string_view input, std::size_t& pos, std::size_t bytes, std::uint64_t& value
+    ) {
+      if (input.size() - pos < bytes) {
+        return false;
+      }
+      value = 0;
+      for (std::size_t i = 0; i < bytes; ++i) {
+        value = value << 8 | static_cast<std::uint8_t>(input[pos++]);
+      }
+      return true;
+    }
+
+    template <typename Field>
+    constexpr bool is_skipped = [] {
+      if constexpr (Field::template has_metadata<serialize::policy::policy_e>) {
+        return Field::template get_metadata<serialize::policy::policy_e> ==
+               serialize::policy::skip;
+      } else {
+        return false;
+      }
+    }();
+
+    template <typename Field>
+    std::string serialized_key() {
+      if constexpr (Field::template has_metadata<serialize::name>) {
+        return Field::template get_metadata<serialize::name>.value;
+      } else {
+        return Field::name;
+      }
+    }
+  } // namespace detail
+
+  /// Streaming writer of a binary format whose headers are laid out by `Encoding`, such as
+  /// `msgpack_encoding` or `cbor_encoding`. Reflected values are maps from the key of each field
+  /// to its value, in declaration order. The key of every field, header included, is encoded once
+  /// per program and copied as it is.
+  ///
+  /// Values follow what `json_fmt` writes, in the format's own types: booleans, integers and
+  /// floating point numbers are native, `char` is a one character string, containers are arrays
+  /// and maps, with keys of any type. Pointers and references follow the `serialize::policy` of
+  /// their field and are `nil` unless they are `deep`, as are circular references.
+  template <typename O, typename Encoding>
+  struct binary_fmt: refl::visitor<binary_fmt<O, Encoding>> {
+    using args_t = binary_fmt_args;
+
+    explicit binary_fmt(O& out_, args_t args_)
+        : refl::visitor<binary_fmt>(),
+          out(out_),
+          args(args_) {}
+
+    template <typename T>
+    void handle_pointer(const T* it) {
+      if constexpr (std::same_as<T, char>) {
+        this->handle_value(it);
+      } else {
+        Encoding::write_nil(out);
+      }
+    }
+
+    template <typename T>
+    void handle_reference(const T&) {
+      Encoding::write_nil(out);
+    }
+
+    template <typename T>
+    void handle_value(const T& it) {
+      if constexpr (refl::is_tracked<T>::value) {
+        this->handle_value(it.value());
+      } else if constexpr (refl::is_soa_vector<T>::value) {
+        Encoding::write_array_header(out, it.size());
+        for (std::size_t i = 0; i < it.size(); ++i) {
+          this->handle_value(it.load(i));
+        }
+      } else if constexpr (packtl::is_type<std::unique_ptr, T>::value or
+                           packtl::is_type<std::optional, T>::value) {
+        if (not it) {
+          Encoding::write_nil(out);
+        } else {
+          this->handle_value(*it);
+        }
+      } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
+        if (it == nullptr or current_policy != serialize::policy::deep) {
+          Encoding::write_nil(out);
+        } else {
+          this->handle_value(*it);
+        }
+      } else if constexpr (packtl::is_type<std::weak_ptr, T>::value) {
+        const auto target = it.lock();
+        if (target == nullptr or current_policy != serialize::policy::deep) {
+          Encoding::write_nil(out);
+        } else {
+          this->handle_value(*target);
+        }
+      } else if constexpr (std::is_pointer_v<T>) {
+        if constexpr (std::same_as<T, char*> or std::same_as<T, const char*>) {
+          if (it == nullptr) {
+            Encoding::write_nil(out);
+          } else {
+            write_text(it);
+          }
+        } else {
+          this->handle_pointer(it);
+        }
+      } else if constexpr (std::same_as<T, bool>) {
+        Encoding::write_bool(out, it);
+      } else if constexpr (std::same_as<T, char>) {
+        write_text(std::string_view{&it, 1});
+      } else if constexpr (std::is_enum_v<T>) {
+        this->handle_value(std::to_underlying(it));
+      } else if constexpr (std::integral<T> and std::is_signed_v<T>) {
+        Encoding::write_int(out, static_cast<std::int64_t>(it));
+      } else if constexpr (std::integral<T>) {
+        Encoding::write_uint(out, static_cast<std::uint64_t>(it));
+      } else if constexpr (std::same_as<T, float>) {
+        Encoding::write_float(out, it);
+      } else if constexpr (std::floating_point<T>) {
+        Encoding::write_double(out, static_cast<double>(it));
+      } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+        write_text(std::string_view{it});
+      } else if constexpr (is_mapping<T>) {
+        Encoding::write_map_header(out, it.size());
+        for (const auto& [key, value]: it) {
+          this->handle_value(key);
+          this->handle_value(value);
+        }
+      } else if constexpr (is_sequence<T>) {
+        Encoding::write_array_header(out, it.size());
+        this->visit_iterable(it);
+      } else if constexpr (packtl::is_type<std::pair, T>::value or
+                           packtl::is_type<std::tuple, T>::value) {
+        Encoding::write_array_header(out, std::tuple_size_v<T>);
+        this->visit_tuple(it);
+      } else if constexpr (refl::Reflected<T>) {
+        this->handle_obj(it);
+      } else if constexpr (std::formattable<T, char>) {
+        write_text(std::format("{}", it));
+      } else {
+        Encoding::write_nil(out);
+      }
+    }
+
+    template <typename T, typename Field>
+    void handle_field(const T& obj) {
+      if constexpr (not detail::is_skipped<Field>) {
+        refl::write(out, encoded_key<Field>());
+        write_field_value<T, Field>(obj);
+      }
+    }
+
+    template <typename T>
+    void handle_obj(const T& obj) {
+      if (std::ranges::contains(path_, static_cast<const void*>(&obj))) {
+        Encoding::write_nil(out);
+        return;
+      }
+      path_.push_back(&obj);
+      Encoding::write_map_header(out, emitted_fields<T>);
+      this->visit_obj(obj);
+      path_.pop_back();
+    }
+
+    template <refl::Reflected R>
+    void serialize(const R& obj) {
+      this->visit(obj);
+    }
+
+    template <typename T>
+    void serialize(const refl::tracked<T>& obj) {
+      this->visit(obj.value());
+    }
+
+    /// Output position reported to the instrumentation probes
+    std::size_t bytes_written() const {
+      return refl::bytes_written(out);
+    }
+
+  private:
+    template <typename T>
+    static constexpr bool is_sequence =
+      packtl::is_type<std::vector, T>::value or refl::is_std_array<T>::value or
+      packtl::is_type<std::list, T>::value or packtl::is_type<std::deque, T>::value or
+      packtl::is_type<std::set, T>::value or packtl::is_type<std::unordered_set, T>::value;
+
+    template <typename T>
+    static constexpr bool is_mapping =
+      packtl::is_type<std::map, T>::value or packtl::is_type<std::unordered_map, T>::value;
+
+    template <typename T>
+    static constexpr std::size_t emitted_fields =
+      []<std::size_t... I>(std::index_sequence<I...>) {
+        return (std::size_t{0} + ... + (detail::is_skipped<refl::field<T, I>> ? 0 : 1));
+      }(std::make_index_sequence<refl::field_count<T>>{});
+
+    /// Key of `Field` with its string header, encoded the first time it is written
+    template <typename Field>
+    static std::string_view encoded_key() {
+      static const std::string key = [] {
+        const std::string  name = detail::serialized_key<Field>();
+        refl::string_sink sink{};
+        Encoding::write_text_header(sink, name.size());
+        refl::write(sink, name);
+        return sink.str();
+      }();
+      return key;
+    }
+
+    template <typename T, typename Field>
+    void write_field_value(const T& obj) {
+      const auto parent_policy = current_policy;
+      current_policy           = serialize::policy::shallow;
+      if constexpr (Field::template has_metadata<serialize::policy::policy_e>) {
+        current_policy = Field::template get_metadata<serialize::policy::policy_e>;
+        if constexpr (Field::template get_metadata<serialize::policy::policy_e> ==
+                      serialize::policy::deep) {
+          if constexpr (Field::is_pointer) {
+            const auto* it = Field::from_instance(obj);
+            if (it == nullptr) {
+              Encoding::write_nil(out);
+            } else {
+              this->handle_value(*it);
+            }
+          } else {
+            this->handle_value(Field::from_instance(obj));
+          }
+        } else if constexpr (Field::is_reference or Field::is_pointer) {
+          Encoding::write_nil(out);
+        } else {
+          this->handle_value(Field::from_instance(obj));
+        }
+      } else {
+        this->template visit_obj_field<T, Field>(obj);
+      }
+      current_policy = parent_policy;
+    }
+
+    void write_text(std::string_view str) {
+      Encoding::write_text_header(out, str.size());
+      refl::write(out, str);
+    }
+
+  private:
+    O&                       out;
+    args_t                   args;
+    std::vector<const void*> path_{};
+
+    serialize::policy::policy_e current_policy{serialize::policy::shallow};
+  };
+} // namespace formats
+
+export namespace refl {
+  /// Pull reader over a document in the binary format `Encoding` decodes. Every header says how
+  /// long its item is, so unknown keys and members that can't be read into are skipped without
+  /// decoding or copying what they hold.
+  ///
+  /// Values are read into the types `formats::binary_fmt` writes them from. `nil` leaves a value
+  /// as it was, except for `std::optional` and `std::unique_ptr`, which are reset. Strings are
+  /// copied into `std::string` members and borrowed by `std::string_view` ones, which then point
+  /// into the input and are only valid as long as it is. Numbers that don't fit the member they
+  /// are read into are an error, as are containers nested deeper than `max_depth`. Throws
+  /// `std::invalid_argument` on malformed input.
+  template <typename Encoding>
+  class binary_reader {
+  public:
+    /// Arrays, maps and string chunks nested deeper than this are rejected, read or skipped
+    static constexpr std::size_t max_depth = 512;
+
+    explicit binary_reader(std::string_view input)
+        : input_(input) {}
+
+    template <typename V>
+    void read_value(V& value) {
+      read_value(next(), value);
+    }
+
+    /// Skips one value of any kind, and everything inside it
+    void skip_value() {
+      skip_payload(next());
+    }
+
+    /// Fails unless the whole input was read
+    void finish() {
+      if (pos_ != input_.size()) {
+        fail("unexpected trailing bytes");
+      }
+    }
+
+  private:
+    using binary_kind  = formats::binary_kind;
+    using binary_token = formats::binary_token;
+
+    template <typename Field>
+    static constexpr bool is_writable =
+      not Field::is_reference and not Field::is_pointer and
+      not std::is_const_v<std::remove_reference_t<typename Field::type>>;
+
+    [[noreturn]] void fail(std::string_view what) const {
+      throw std::invalid_argument(
+        std::format("Malformed {} at offset {}: {}", Encoding::name, pos_, what)
+      );
+    }
+
+    /// Next header, past any tags in front of it
+    binary_token next() {
+      binary_token token{};
+      do {
+        if (not Encoding::decode(input_, pos_, token)) {
+          fail(pos_ >= input_.size() ? "unexpected end of input" : "invalid header");
+        }
+      } while (token.kind == binary_kind::tag);
+      return token;
+    }
+
+    /// Consumes the `end` of an indefinite length item, if it is next
+    bool consume_end() {
+      std::size_t  pos = pos_;
+      binary_token token{};
+      if (Encoding::decode(input_, pos, token) and token.kind == binary_kind::end) {
+        pos_ = pos;
+        return true;
+      }
+      return false;
+    }
+
+    /// The `size` bytes of a string, in the input
+    std::string_view take(std::uint64_t size) {
+      if (input_.size() - pos_ < size) {
+        fail("unexpected end of input");
+      }
+      const std::string_view bytes = input_.substr(pos_, size);
+      pos_ += size;
+      return bytes;
+    }
+
+    /// Calls `element()` once per element of the container `head` announced, or per chunk of an
+    /// indefinite length string
+    template <typename F>
+    void for_each_element(const binary_token& head, F&& element) {
+      if (depth_ == max_depth) {
+        fail("nested too deeply");
+      }
+      ++depth_;
+      struct guard {
+        std::size_t& depth;
+
+        ~guard() {
+          --depth;
+        }
+      } nesting_guard{depth_};
+      if (head.indefinite) {
+        while (not consume_end()) {
+          element();
+        }
+      } else {
+        for (std::uint64_t i = 0; i < head.value; ++i) {
+          element();
+        }
+      }
+    }
+
+    void skip_payload(const binary_token& token) {
+      switch (token.kind) {
+        case binary_kind::text:
+        case binary_kind::bytes:
+          if (token.indefinite) {
+            for_each_element(token, [&] {
+              skip_value();
+            });
+          } else {
+            take(token.value);
+          }
+          break;
+        case binary_kind::array:
+          for_each_element(token, [&] {
+            skip_value();
+          });
+          break;
+        case binary_kind::map:
+          for_each_element(token, [&] {
+            skip_value();
+            skip_value();
+          });
+          break;
+        case binary_kind::end:
+          fail("unexpected end of an indefinite length item");
+        default:
+          break;
+      }
+    }
+
+    /// Serialized keys of a type and their field indices, in declaration order and sorted
+    struct key_table {
+      std::vector<std::pair<std::string, std::size_t>> declared{};
+      std::vector<std::pair<std::string, std::size_t>> sorted{};
+    };
+
+    template <Reflected R>
+    static const key_table& keys() {
+      static const key_table table = [] {
+        key_table result{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (
+            [&] {
+              if constexpr (not formats::detail::is_skipped<field<R, I>>) {
+                result.declared.emplace_back(formats::detail::serialized_key<field<R, I>>(), I);
+              }
+            }(),
+            ...
+          );
+        }(std::make_index_sequence<field_count<R>>{});
+        result.sorted = result.declared;
+        std::ranges::sort(result.sorted);
+        return result;
+      }();
+      return table;
+    }
+
+    template <Reflected R, typename Field>
+    static void read_field(binary_reader& reader, R& obj) {
+      if constexpr (is_writable<Field>) {
+        reader.read_value(Field::from_instance(obj));
+      } else {
+        reader.skip_value();
+      }
+    }
+
+    template <Reflected R>
+    void read_object(const binary_token& head, R& obj) {
+      static constexpr auto readers = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<void (*)(binary_reader&, R&), sizeof...(I)>{
+          &read_field<R, field<R, I>>...
+        };
+      }(std::make_index_sequence<field_count<R>>{});
+
+      if (head.kind != binary_kind::map) {
+        fail("expected a map");
+      }
+      const auto& table = keys<R>();
+      // Writers usually keep declaration order, the field after the last one read is tried first
+      std::size_t expected = 0;
+      for_each_element(head, [&] {
+        const binary_token key = next();
+        if (key.kind != binary_kind::text or key.indefinite) {
+          skip_payload(key);
+          skip_value();
+          return;
+        }
+        const std::string_view name = take(key.value);
+        if (expected < table.declared.size() and table.declared[expected].first == name) {
+          readers[table.declared[expected++].second](*this, obj);
+          return;
+        }
+        const auto it =
+          std::ranges::lower_bound(table.sorted, name, std::less<>{}, [](const auto& k) {
+            return std::string_view{k.first};
+          });
+        if (it != table.sorted.end() and it->first == name) {
+          readers[it->second](*this, obj);
+          const auto declared = std::ranges::find(table.declared, it->second, [](const auto& k) {
+            return k.second;
+          });
+          expected = static_cast<std::size_t>(declared - table.declared.begin()) + 1;
+        } else {
+          skip_value();
+        }
+      });
+    }
+
+    template <typename N>
+    N read_integer(const binary_token& token) {
+      if (token.kind == binary_kind::uint) {
+        if (token.value <= static_cast<std::uint64_t>(std::numeric_limits<N>::max())) {
+          return static_cast<N>(token.value);
+        }
+      } else if (token.kind == binary_kind::nint) {
+        if constexpr (std::is_signed_v<N>) {
+          // -1 - value >= min
+          if (token.value <= static_cast<std::uint64_t>(-(std::numeric_limits<N>::min() + 1))) {
+            return static_cast<N>(-1 - static_cast<std::int64_t>(token.value));
+          }
+        }
+      } else {
+        fail("expected an integer");
+      }
+      fail("integer out of range");
+    }
+
+    template <typename N>
+    N read_floating(const binary_token& token) {
+      switch (token.kind) {
+        case binary_kind::floating:
+          return static_cast<N>(token.real);
+        case binary_kind::uint:
+          return static_cast<N>(token.value);
+        case binary_kind::nint:
+          return static_cast<N>(-1.0L - static_cast<long double>(token.value));
+        default:
+          fail("expected a number");
+      }
+    }
+
+    /// A string into `out`, chunk by chunk if it has an indefinite length
+    void read_text(const binary_token& token, std::string& out) {
+      if (token.kind != binary_kind::text and token.kind != binary_kind::bytes) {
+        fail("expected a string");
+      }
+      if (not token.indefinite) {
+        out.assign(take(token.value));
+        return;
+      }
+      out.clear();
+      while (not consume_end()) {
+        const binary_token chunk = next();
+        if (chunk.kind != token.kind or chunk.indefinite) {
+          fail("invalid string chunk");
+        }
+        out.append(take(chunk.value));
+      }
+    }
+
+    template <typename V>
+    void read_value(const binary_token& token, V& value) {
+      if constexpr (packtl::is_type<std::unique_ptr, V>::value) {
+        if (token.kind == binary_kind::nil) {
+          value.reset();
+        } else {
+          auto pointee = std::make_unique<typename V::element_type>();
+          read_value(token, *pointee);
+          value = std::move(pointee);
+        }
+      } else if constexpr (packtl::is_type<std::optional, V>::value) {
+        if (token.kind == binary_kind::nil) {
+          value.reset();
+        } else {
+          read_value(token, value.emplace());
+        }
+      } else if (token.kind == binary_kind::nil) {
+        return;
+      } else if constexpr (std::same_as<V, bool>) {
+        if (token.kind != binary_kind::boolean) {
+          fail("expected a boolean");
+        }
+        value = token.value != 0;
+      } else if constexpr (std::same_as<V, char>) {
+        if (token.kind != binary_kind::text or token.indefinite or token.value != 1) {
+          fail("expected a single character");
+        }
+        value = take(1).front();
+      } else if constexpr (std::is_enum_v<V>) {
+        std::underlying_type_t<V> underlying{};
+        read_value(token, underlying);
+        value = static_cast<V>(underlying);
+      } else if constexpr (std::integral<V>) {
+        value = read_integer<V>(token);
+      } else if constexpr (std::floating_point<V>) {
+        value = read_floating<V>(token);
+      } else if constexpr (std::same_as<V, std::string>) {
+        read_text(token, value);
+      } else if constexpr (std::same_as<V, std::string_view>) {
+        if (token.kind != binary_kind::text and token.kind != binary_kind::bytes) {
+          fail("expected a string");
+        }
+        if (token.indefinite) {
+          fail("a string of indefinite length can't be borrowed");
+        }
+        value = take(token.value);
+      } else if constexpr (packtl::is_type<std::vector, V>::value or
+                           packtl::is_type<std::list, V>::value or
+                           packtl::is_type<std::deque, V>::value or
+                           packtl::is_type<std::set, V>::value or
+                           packtl::is_type<std::unordered_set, V>::value) {
+        if (token.kind != binary_kind::array) {
+          fail("expected an array");
+        }
+        value.clear();
+        if constexpr (requires { value.reserve(token.value); }) {
+          // Every element takes at least a byte, a corrupt count can't reserve more memory than
+          // the rest of the input takes
+          if (not token.indefinite) {
+            const std::size_t fits = (input_.size() - pos_) / sizeof(typename V::value_type);
+            value.reserve(std::min<std::uint64_t>(token.value, fits));
+          }
+        }
+        for_each_element(token, [&] {
+          typename V::value_type item{};
+          read_value(item);
+          if constexpr (requires { value.push_back(std::move(item)); }) {
+            value.push_back(std::move(item));
+          } else {
+            value.insert(std::move(item));
+          }
+        });
+      } else if constexpr (is_std_array<V>::value) {
+        if (token.kind != binary_kind::array) {
+          fail("expected an array");
+        }
+        std::size_t index = 0;
+        for_each_element(token, [&] {
+          if (index < value.size()) {
+            read_value(value[index++]);
+          } else {
+            skip_value();
+          }
+        });
+      } else if constexpr (packtl::is_type<std::map, V>::value or
+                           packtl::is_type<std::unordered_map, V>::value) {
+        if (token.kind != binary_kind::map) {
+          fail("expected a map");
+        }
+        value.clear();
+        for_each_element(token, [&] {
+          typename V::key_type    key{};
+          typename V::mapped_type mapped{};
+          read_value(key);
+          read_value(mapped);
+          value.insert_or_assign(std::move(key), std::move(mapped));
+        });
+      } else if constexpr (packtl::is_type<std::pair, V>::value or
+                           packtl::is_type<std::tuple, V>::value) {
+        if (token.kind != binary_kind::array or token.indefinite or
+            token.value != std::tuple_size_v<V>) {
+          fail(std::format("expected an array of {} elements", std::tuple_size_v<V>));
+        }
+        std::apply(
+          [&](auto&... elements) {
+            (read_value(elements), ...);
+          },
+          value
+        );
+      } else if constexpr (Reflected<V>) {
+        read_object(token, value);
+      } else {
+        skip_payload(token);
+      }
+    }
+
+  private:
+    std::string_view input_;
+    std::size_t      pos_   = 0;
+    std::size_t      depth_ = 0;
+  };
+} // namespace refl
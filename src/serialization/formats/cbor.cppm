@@ -0,0 +1,216 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  cbor.cppm
+ *! \brief CBOR writer and reader.
+ *!
+ */
+
+export module reflect.marshal.formats.cbor;
+
+import std;
+
+import reflect;
+
+import reflect.marshal.formats.binary;
+
+export namespace formats {
+  /// Headers of CBOR (RFC 8949), written in their shortest form and with definite lengths. Reading
+  /// also accepts indefinite lengths, half precision floats and tags, which are skipped in front of
+  /// the item they tag.
+  struct cbor_encoding {
+    static constexpr std::string_view name = "CBOR";
+
+    enum major_type : std::uint8_t {
+      unsigned_integer = 0,
+      negative_integer = 1,
+      byte_string      = 2,
+      text_string      = 3,
+      array            = 4,
+      map              = 5,
+      tag              = 6,
+      simple           = 7,
+    };
+
+    /// Major type and argument, in the fewest bytes
+    template <typename O>
+    static void write_head(O& out, major_type type, std::uint64_t argument) {
+      const auto lead = static_cast<std::uint8_t>(type << 5);
+      if (argument < 24) {
+        out.put(static_cast<char>(lead | argument));
+      } else if (argument <= 0xFF) {
+        detail::write_big_endian(out, lead | 24, argument, 1);
+      } else if (argument <= 0xFFFF) {
+        detail::write_big_endian(out, lead | 25, argument, 2);
+      } else if (argument <= 0xFFFF'FFFF) {
+        detail::write_big_endian(out, lead | 26, argument, 4);
+      } else {
+        detail::write_big_endian(out, lead | 27, argument, 8);
+      }
+    }
+
+    template <typename O>
+    static void write_nil(O& out) {
+      out.put('\xF6');
+    }
+
+    template <typename O>
+    static void write_bool(O& out, bool value) {
+      out.put(value ? '\xF5' : '\xF4');
+    }
+
+    template <typename O>
+    static void write_uint(O& out, std::uint64_t value) {
+      write_head(out, unsigned_integer, value);
+    }
+
+    template <typename O>
+    static void write_int(O& out, std::int64_t value) {
+      if (value >= 0) {
+        write_head(out, unsigned_integer, static_cast<std::uint64_t>(value));
+      } else {
+        write_head(out, negative_integer, static_cast<std::uint64_t>(-1 - value));
+      }
+    }
+
+    template <typename O>
+    static void write_float(O& out, float value) {
+      detail::write_big_endian(out, 0xFA, std::bit_cast<std::uint32_t>(value), 4);
+    }
+
+    template <typename O>
+    static void write_double(O& out, double value) {
+      detail::write_big_endian(out, 0xFB, std::bit_cast<std::uint64_t>(value), 8);
+    }
+
+    template <typename O>
+    static void write_text_header(O& out, std::size_t size) {
+      write_head(out, text_string, size);
+    }
+
+    template <typename O>
+    static void write_array_header(O& out, std::size_t size) {
+      write_head(out, array, size);
+    }
+
+    template <typename O>
+    static void write_map_header(O& out, std::size_t size) {
+      write_head(out, map, size);
+    }
+
+    /// Header at `pos`, moving `pos` past it. False if it is invalid or truncated.
+    static bool decode(std::string_view input, std::size_t& pos, binary_token& token) {
+      if (pos >= input.size()) {
+        return false;
+      }
+      const auto         lead     = static_cast<std::uint8_t>(input[pos++]);
+      const auto         type     = static_cast<major_type>(lead >> 5);
+      const std::uint8_t info     = lead & 0x1F;
+      std::uint64_t      argument = info;
+      if (info >= 24 and info <= 27) {
+        if (not detail::read_big_endian(input, pos, std::size_t{1} << (info - 24), argument)) {
+          return false;
+        }
+      } else if (info > 27 and info < 31) {
+        return false;
+      }
+
+      if (type == simple) {
+        switch (info) {
+          case 20:
+          case 21:
+            token = {.kind = binary_kind::boolean, .value = info - 20u};
+            return true;
+          case 22:
+          case 23:
+            // null and undefined
+            token = {.kind = binary_kind::nil};
+            return true;
+          case 25:
+            token = {.kind = binary_kind::floating, .real = half_to_double(argument)};
+            return true;
+          case 26: {
+            const auto value = std::bit_cast<float>(static_cast<std::uint32_t>(argument));
+            token            = {.kind = binary_kind::floating, .real = value};
+            return true;
+          }
+          case 27:
+            token = {.kind = binary_kind::floating, .real = std::bit_cast<double>(argument)};
+            return true;
+          case 31:
+            token = {.kind = binary_kind::end};
+            return true;
+          default:
+            token = {.kind = binary_kind::simple, .value = argument};
+            return true;
+        }
+      }
+
+      if (info == 31) {
+        // Only strings and containers have indefinite lengths
+        if (type < byte_string or type > map) {
+          return false;
+        }
+        token.indefinite = true;
+        argument         = 0;
+      }
+      switch (type) {
+        case unsigned_integer:
+          token.kind = binary_kind::uint;
+          break;
+        case negative_integer:
+          token.kind = binary_kind::nint;
+          break;
+        case byte_string:
+          token.kind = binary_kind::bytes;
+          break;
+        case text_string:
+          token.kind = binary_kind::text;
+          break;
+        case array:
+          token.kind = binary_kind::array;
+          break;
+        case map:
+          token.kind = binary_kind::map;
+          break;
+        default:
+          token.kind = binary_kind::tag;
+          break;
+      }
+      token.value = argument;
+      return true;
+    }
+
+  private:
+    /// IEEE 754 half precision, RFC 8949 appendix D
+    static double half_to_double(std::uint64_t half) {
+      const auto exponent = static_cast<int>((half >> 10) & 0x1F);
+      const auto mantissa = static_cast<double>(half & 0x3FF);
+      double     value    = 0.0;
+      if (exponent == 0) {
+        value = std::ldexp(mantissa, -24);
+      } else if (exponent != 31) {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+      } else {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity()
+                              : std::numeric_limits<double>::quiet_NaN();
+      }
+      return (half & 0x8000) != 0 ? -value : value;
+    }
+  };
+
+  /// CBOR writer, e.g. `refl::to_string<formats::cbor_fmt>(obj)`
+  template <typename O>
+  using cbor_fmt = binary_fmt<O, cbor_encoding>;
+} // namespace formats
+
+export namespace refl {
+  /// Decodes the CBOR map `bytes` into `out`, see `binary_reader`. Members missing from the input
+  /// keep their value and unknown keys are skipped. `std::string_view` members point into `bytes`.
+  template <Reflected T>
+  void read_cbor(std::string_view bytes, T& out) {
+    binary_reader<formats::cbor_encoding> reader{bytes};
+    reader.read_value(out);
+    reader.finish();
+  }
+} // namespace refl
@@ -14,14 +14,17 @@ import packtl;
 import reflect;
 
 import reflect.marshal.formats.base;
+import reflect.marshal.sink;
 
 export namespace formats {
+  struct default_fmt_args {
+    bool         pretty = true;
+    unsigned int indent = 2;
+  };
+
   template <typename O>
   struct default_fmt: refl::visitor<default_fmt<O>> {
-    struct args_t {
-      bool         pretty = true;
-      unsigned int indent = 2;
-    };
+    using args_t = default_fmt_args;
 
     explicit default_fmt(O& out_, args_t args_): refl::visitor<default_fmt<O>>(), out(out_), args(args_) {}
 
@@ -29,20 +32,40 @@ export namespace formats {
     void handle_value(const T& it) {
       if constexpr (std::is_same_v<T, std::atomic_flag>) {
         out << (it.test() ? "SET" : "CLEAR");
+      } else if constexpr (std::same_as<T, refl::any> or std::same_as<T, refl::any_ref>) {
+        if (it.is_null()) {
+          out << "null;";
+        } else {
+          this->handle_dynamic(it.type(), it.data());
+        }
+        return;
+      } else if constexpr (std::same_as<T, refl::archive>) {
+        this->handle_archive(it);
+        out << ";";
+        return;
+      } else if constexpr (refl::is_tracked<T>::value) {
+        this->handle_value(it.value());
+        return;
+      } else if constexpr (refl::is_soa_vector<T>::value) {
+        for (std::size_t i = 0; i < it.size(); ++i) {
+          this->handle_value(it.load(i));
+        }
+        out << ";";
+        return;
       } else if constexpr (packtl::is_type<std::unique_ptr, T>::value) {
         const auto* value = it.get();
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "} ";
       } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
         const auto* value = it.get();
         out << "{";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "} ";
       } else if constexpr (packtl::is_type<std::weak_ptr, T>::value) {
         const auto* value = it.get();
         out << " {";
-        out << std::format("0x{:X}", (std::size_t)value);
+        refl::write_format(out, "0x{:X}", (std::size_t)value);
         out << "}: ";
       } else if constexpr (refl::Reflected<T>) {
         if (visited_.contains((std::size_t)&it)) {
@@ -51,11 +74,11 @@ export namespace formats {
         }
         visited_.emplace((std::size_t)&it);
       } else if constexpr (std::is_convertible_v<T, std::string>) {
-        out << std::format("{:?}", it);
+        refl::write_format(out, "{:?}", it);
       } else if constexpr (std::same_as<T, char>) {
-        out << std::format("0x{:X} '{}'", (int)it, it);
+        refl::write_format(out, "0x{:X} '{}'", (int)it, it);
       } else if constexpr (std::formattable<T, char>) {
-        out << std::format("{}", it);
+        refl::write_format(out, "{}", it);
       }
 
       this->visit_value(it);
@@ -69,34 +92,20 @@ export namespace formats {
 
     template <typename T, typename Field>
     void handle_field(const T& obj) {
-      switch (Field::access) {
-        case refl::access_spec::NONE:
-          out << " -";
-          break;
-        case refl::access_spec::PRIVATE:
-          // out << "🔒";
-          out << "🔒";
-          break;
-        // 🔓
-        case refl::access_spec::PROTECTED:
-          out << " \\";
-          break;
-        case refl::access_spec::PUBLIC:
-          out << "  ";
-          break;
-        default:
-          break;
-      }
+      write_access(Field::access);
 
-      out << Field::name;
-      out << ": " << refl::type_name<typename Field::type> << " = ";
+      refl::write_static(out, Field::name);
+      out << ": ";
+      refl::write_static(out, refl::type_name<typename Field::type>);
+      out << " = ";
 
       this->template visit_obj_field<T, Field>(obj);
     }
 
     template <typename T>
     void handle_obj(const T& obj) {
-      out << refl::type_name<T> << " {" << "\n";
+      refl::write_static(out, refl::type_name<T>);
+      out << " {" << "\n";
       this->visit_obj(obj);
       // for (std::size_t i = 0; i < indent; ++i) {
       //   for (std::size_t j = 0; j < args.indent; ++j) {
@@ -106,13 +115,234 @@ export namespace formats {
       out << "}";
     }
 
+    /// Values only known through their `type_info`, reported by the thunk `type_info::from<T>()`
+    /// captured for their type
+    void handle_dynamic(const refl::type_info& type, const void* value) {
+      dynamic_writer writer{*this};
+      type.visit_value(value, writer);
+      if (not writer.forwarded) {
+        out << ";";
+      }
+    }
+
+    void handle_dynamic_obj(const refl::type_info& type, const void* obj) {
+      refl::write(out, type.name());
+      out << " {" << "\n";
+      for (const auto& field: type.fields()) {
+        write_access(field.access_type);
+        refl::write(out, field.name);
+        out << ": ";
+        refl::write(out, field.type().name());
+        out << " = ";
+
+        const void* ptr = field.get_ptr(const_cast<void*>(obj));
+        if (field.is_reference) {
+          handle_dynamic(field.type(), *static_cast<const void* const*>(ptr));
+        } else {
+          handle_dynamic(field.type(), ptr);
+        }
+      }
+      out << "}";
+    }
+
+    void handle_archive(const refl::archive& archive) {
+      out << "refl::archive {" << "\n";
+      for (const auto& [path, value]: archive) {
+        write_access(refl::access_spec::PUBLIC);
+        refl::write(out, path);
+        out << ": ";
+        if (value.is_null()) {
+          out << "null";
+        } else {
+          refl::write(out, value.type().name());
+        }
+        out << " = ";
+        this->handle_value(value);
+      }
+      out << "}";
+    }
+
     template <refl::Reflected R>
     void serialize(const R& obj) {
       this->visit(obj);
       out << "\n";
     }
 
+    template <typename T>
+    void serialize(const refl::tracked<T>& obj) {
+      this->serialize(obj.value());
+    }
+
+    /// Writes `obj` with its fields taken from `fragments`, one cached field per index. Fields set
+    /// in `refresh` are re-serialized into their fragment first. With `only_refreshed`, clean
+    /// fields are left out entirely.
+    template <refl::Reflected T>
+    void serialize_fields(
+      const T&                                 obj,
+      std::span<refl::string_sink>             fragments,
+      const std::bitset<refl::field_count<T>>& refresh,
+      bool                                     only_refreshed = false
+    ) {
+      static constexpr auto fragment_writers = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<void (*)(default_fmt<refl::string_sink>&, const T&), sizeof...(I)>{
+          [](default_fmt<refl::string_sink>& fragment, const T& o) {
+            fragment.template handle_field<T, refl::field<T, I>>(o);
+          }...
+        };
+      }(std::make_index_sequence<refl::field_count<T>>{});
+
+      refl::write_static(out, refl::type_name<T>);
+      out << " {" << "\n";
+      for (std::size_t index = 0; index < refl::field_count<T>; ++index) {
+        if (refresh.test(index)) {
+          auto& sink = fragments[index];
+          sink.clear();
+          default_fmt<refl::string_sink> fragment{sink, args};
+          fragment_writers[index](fragment, obj);
+        } else if (only_refreshed) {
+          continue;
+        }
+        refl::write(out, fragments[index].view());
+      }
+      out << "}";
+      out << "\n";
+    }
+
+    void serialize(const refl::any& value) {
+      this->handle_value(value);
+      out << "\n";
+    }
+
+    void serialize(const refl::any_ref& value) {
+      this->handle_value(value);
+      out << "\n";
+    }
+
+    void serialize(const refl::archive& archive) {
+      this->handle_archive(archive);
+      out << "\n";
+    }
+
+    /// Output position reported to the instrumentation probes
+    std::size_t bytes_written() const {
+      return refl::bytes_written(out);
+    }
+
   private:
+    void write_access(refl::access_spec access) {
+      switch (access) {
+        case refl::access_spec::NONE:
+          out << " -";
+          break;
+        case refl::access_spec::PRIVATE:
+          // out << "🔒";
+          out << "🔒";
+          break;
+        // 🔓
+        case refl::access_spec::PROTECTED:
+          out << " \\";
+          break;
+        case refl::access_spec::PUBLIC:
+          out << "  ";
+          break;
+        default:
+          break;
+      }
+    }
+
+    /// Writes what a type's thunk reports the same way `handle_value` would
+    struct dynamic_writer final: refl::value_visitor {
+      explicit dynamic_writer(default_fmt& fmt_)
+          : fmt(fmt_) {}
+
+      void on_null() override {}
+      void on_bool(bool value) override {
+        refl::write_format(fmt.out, "{}", value);
+      }
+      void on_char(char value) override {
+        refl::write_format(fmt.out, "0x{:X} '{}'", (int)value, value);
+      }
+      void on_int(std::int64_t value) override {
+        refl::write_format(fmt.out, "{}", value);
+      }
+      void on_uint(std::uint64_t value) override {
+        refl::write_format(fmt.out, "{}", value);
+      }
+      void on_float(double value, bool single) override {
+        if (single) {
+          refl::write_format(fmt.out, "{}", static_cast<float>(value));
+        } else {
+          refl::write_format(fmt.out, "{}", value);
+        }
+      }
+      void on_string(std::string_view value) override {
+        refl::write_format(fmt.out, "{:?}", value);
+      }
+      void on_formatted(std::string_view value) override {
+        refl::write(fmt.out, value);
+      }
+
+      void on_pointer(
+        const refl::type_info* type, const void* target, refl::pointer_kind kind
+      ) override {
+        switch (kind) {
+          case refl::pointer_kind::unique:
+            fmt.out << " {";
+            refl::write_format(fmt.out, "0x{:X}", (std::size_t)target);
+            fmt.out << "} ";
+            break;
+          case refl::pointer_kind::shared:
+            fmt.out << "{";
+            refl::write_format(fmt.out, "0x{:X}", (std::size_t)target);
+            fmt.out << "} ";
+            break;
+          case refl::pointer_kind::weak:
+            fmt.out << " {";
+            refl::write_format(fmt.out, "0x{:X}", (std::size_t)target);
+            fmt.out << "}: ";
+            if (target != nullptr and type != nullptr) {
+              fmt.handle_dynamic(*type, target);
+            }
+            break;
+          case refl::pointer_kind::raw:
+          default:
+            // Like `visit_pointer`, the pointee is written in place of the pointer
+            forwarded = true;
+            if (target != nullptr and type != nullptr) {
+              fmt.handle_dynamic(*type, target);
+            }
+            break;
+        }
+      }
+
+      void begin_sequence(std::size_t) override {}
+      void on_element(const refl::type_info& type, const void* value) override {
+        fmt.handle_dynamic(type, value);
+      }
+      void end_sequence() override {}
+
+      void begin_mapping(std::size_t) override {}
+      void on_entry(std::string_view key, const refl::type_info& type, const void* value) override {
+        refl::write_format(fmt.out, "{:?};", key);
+        fmt.handle_dynamic(type, value);
+        fmt.out << ";";
+      }
+      void end_mapping() override {}
+
+      void on_object(const refl::type_info& type, const void* value) override {
+        if (fmt.visited_.contains((std::size_t)value)) {
+          fmt.out << "<circular reference>";
+          forwarded = true;
+          return;
+        }
+        fmt.visited_.emplace((std::size_t)value);
+        fmt.handle_dynamic_obj(type, value);
+      }
+
+      default_fmt& fmt;
+      bool         forwarded = false;
+    };
+
     std::unordered_set<std::size_t> visited_{};
     O&                              out;
     args_t args;
@@ -17,16 +17,32 @@ import packtl;
 import reflect;
 
 import reflect.marshal.formats.base;
-
-using JSON = nlohmann::json;
+import reflect.marshal.intern;
+import reflect.marshal.memo;
+import reflect.marshal.sink;
 
 export namespace formats {
+  struct json_fmt_args {
+    bool         pretty = false;
+    unsigned int indent = 2;
+    /// Interns strings and keys into this dictionary, which must outlive the writer and can be
+    /// shared by consecutive serializations of one stream. A repeated string is written as its id
+    /// in brackets, `[3]`, and a repeated key as `"^3"` (a key that starts with `^` the first time
+    /// gets one more). The output is still JSON, but only a reader keeping a dictionary with the
+    /// same options, such as `refl::read_json(json, out, dictionary)`, can make sense of it.
+    refl::string_dictionary* dictionary = nullptr;
+    /// Serves fields marked `serialize::immutable` from this cache, which must outlive the
+    /// writer. The output is the same with or without it. It is not used while interning strings,
+    /// nor for fields that are not `refl::is_content_hashable`.
+    refl::serialization_cache* cache = nullptr;
+  };
+
+  /// Streaming JSON writer. Output goes straight to the sink as the object is visited, so no
+  /// intermediate document is built. Object keys are emitted in sorted order, matching what a
+  /// `nlohmann::json` object would produce.
   template <typename O>
   struct json_fmt: refl::visitor<json_fmt<O>> {
-    struct args_t {
-      bool         pretty = false;
-      unsigned int indent = 2;
-    };
+    using args_t = json_fmt_args;
 
     explicit json_fmt(O& out_, args_t args_)
         : refl::visitor<json_fmt<O>>(),
@@ -40,216 +56,1121 @@ export namespace formats {
         return;
       }
 
-      current() = "reference";
-      // this->visit_pointer(it);
+      write_quoted("\"reference\"");
     }
 
     template <typename T>
     void handle_reference(const T& it) {
-      current() = "reference";
-      // this->visit_pointer(it);
+      write_quoted("\"reference\"");
     }
 
     template <typename T>
     void handle_value(const T& it) {
       if constexpr (std::is_same_v<T, std::atomic_flag>) {
-        current() = (it.test() ? "SET" : "CLEAR");
+        write_quoted(it.test() ? "\"SET\"" : "\"CLEAR\"");
+      } else if constexpr (std::same_as<T, refl::any> or std::same_as<T, refl::any_ref>) {
+        if (it.is_null()) {
+          write_static("null");
+        } else {
+          this->handle_dynamic(it.type(), it.data());
+        }
+      } else if constexpr (std::same_as<T, refl::archive>) {
+        this->handle_archive(it);
+      } else if constexpr (refl::is_tracked<T>::value) {
+        this->handle_value(it.value());
+      } else if constexpr (refl::is_soa_vector<T>::value) {
+        // Rows are materialized one at a time, the columns never have to be transposed as a whole
+        begin_scope('[');
+        for (std::size_t i = 0; i < it.size(); ++i) {
+          next_element();
+          this->handle_value(it.load(i));
+        }
+        end_scope(']');
       } else if constexpr (packtl::is_type<std::unique_ptr, T>::value) {
-        const auto* value = it.get();
-        this->handle_value(*value);
-        return;
+        if (it == nullptr) {
+          write_static("null");
+        } else {
+          this->handle_value(*it);
+        }
       } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
-        if (current_policy == serialize::policy::deep) {
-          const auto* value = it.get();
-          this->handle_value(*value);
-          return;
+        if (current_policy != serialize::policy::deep) {
+          write_quoted("\"reference\"");
+        } else if (it == nullptr) {
+          write_static("null");
         } else {
-          current() = "reference";
-          return;
+          this->handle_value(*it);
         }
       } else if constexpr (packtl::is_type<std::weak_ptr, T>::value) {
         if (it.expired()) {
-          current() = "null";
-          return;
+          write_static("null");
         } else if (current_policy == serialize::policy::deep) {
-          const auto* value = it.get();
-          this->handle_value(*value);
-          return;
+          this->handle_value(*it.lock());
         } else {
-          current() = "reference";
-          return;
+          write_quoted("\"reference\"");
         }
-      } else if constexpr (refl::Reflected<T>) {
-        if (visited_.contains((std::size_t)&it)) {
-          out << "<circular reference>";
-          return;
+      } else if constexpr (std::is_pointer_v<T>) {
+        if constexpr (std::same_as<T, char*> or std::same_as<T, const char*>) {
+          if (it == nullptr) {
+            write_static("null");
+          } else {
+            write_string(it);
+          }
+        } else {
+          this->handle_pointer(it);
         }
-        visited_.emplace((std::size_t)&it);
+      } else if constexpr (is_iterable<T>) {
+        this->handle_iterable(it);
+      } else if constexpr (packtl::is_type<std::pair, T>::value) {
+        this->handle_tuple(it);
+      } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+        write_string(std::string_view{it});
       } else if constexpr (std::is_convertible_v<T, std::string>) {
-        current() = std::format("{}", std::string{it});
-      } else if constexpr (std::same_as<T, char*>) {
-        current() = std::format("{}", std::string{it});
-        return;
-      } else if constexpr (std::same_as<T, const char*>) {
-        current() = std::format("{}", std::string{it});
-        return;
+        write_string(std::string{it});
       } else if constexpr (std::same_as<T, int> or std::same_as<T, unsigned int> or
                            std::same_as<T, short> or std::same_as<T, unsigned short> or
-                           std::same_as<T, long> or std::same_as<T, unsigned long> or
-                           std::same_as<T, float> or std::same_as<T, double>) {
-        current() = it;
+                           std::same_as<T, long> or std::same_as<T, unsigned long>) {
+        write_integer(it);
+      } else if constexpr (std::same_as<T, float> or std::same_as<T, double>) {
+        write_float(static_cast<double>(it));
       } else if constexpr (std::same_as<T, bool>) {
-        current() = std::format("{}", it ? "true" : "false");
+        write_quoted(it ? "\"true\"" : "\"false\"");
+      } else if constexpr (refl::Reflected<T>) {
+        this->handle_obj(it);
       } else if constexpr (std::formattable<T, char>) {
-        current() = std::format("{}", it);
+        write_string(std::format("{}", it));
+      } else {
+        write_static("null");
       }
-
-      this->visit_value(it);
     }
 
     template <typename T>
     void handle_iterable(const T& iterable) {
-      if constexpr (std::__is_std_pair<typename T::value_type>) {
-        using type = typename T::value_type;
-        if constexpr (std::same_as<typename type::first_type, std::string> or
-                      std::same_as<typename type::first_type, const std::string>) {
-          current() = JSON::object({});
+      if constexpr (is_string_keyed<T>) {
+        begin_scope('{');
+        if constexpr (is_sorted_by_key<T>) {
           for (const auto& [first, second]: iterable) {
-            current()[first] = JSON{};
-            push(current()[first]);
+            write_key(first);
             this->handle_value(second);
-            pop();
           }
-          return;
+        } else {
+          std::vector<const typename T::value_type*> entries{};
+          entries.reserve(iterable.size());
+          for (const auto& entry: iterable) {
+            entries.push_back(&entry);
+          }
+          std::ranges::sort(entries, std::less<>{}, [](const auto* entry) -> const std::string& {
+            return entry->first;
+          });
+          for (const auto* entry: entries) {
+            write_key(entry->first);
+            this->handle_value(entry->second);
+          }
         }
+        end_scope('}');
+        return;
       }
-      current() = JSON::array({});
-      push(current());
+      begin_scope('[');
       this->visit_iterable(iterable);
-      pop();
+      end_scope(']');
     }
 
     template <typename T>
     void handle_iterable_element(const T& element) {
-      current().push_back(JSON{});
-      push(current().back());
+      next_element();
       this->visit_iterable_element(element);
-      pop();
     }
 
     template <typename T>
     void handle_tuple(const T& tuple) {
       if constexpr (std::__is_std_pair<T> and std::same_as<typename T::first_type, std::string>) {
-        current()              = JSON::object({});
-        current()[tuple.first] = JSON{};
-        push(current()[tuple.first]);
+        begin_scope('{');
+        write_key(tuple.first);
         this->handle_value(tuple.second);
-        pop();
+        end_scope('}');
       } else {
-        current() = JSON::array({});
-        push(current());
+        begin_scope('[');
         this->visit_tuple(tuple);
-        pop();
+        end_scope(']');
       }
     }
 
     template <typename T>
     void handle_tuple_element(const T& element) {
-      current().push_back(JSON{});
-      push(current().back());
+      next_element();
       this->visit_tuple_element(element);
-      pop();
     }
 
     template <typename T, typename Field>
     void handle_field(const T& obj) {
-      std::string field_name = Field::name;
-      if constexpr (Field::template has_metadata<serialize::name>) {
-        field_name = Field::template get_metadata<serialize::name>.value;
+      if constexpr (not is_skipped<Field>) {
+        write_key(field_key<Field>());
+        this->template handle_field_value<T, Field>(obj);
       }
+    }
+
+    template <typename T, typename Field>
+    void handle_field_value(const T& obj) {
+      if constexpr (Field::template has_metadata<serialize::immutable> and
+                    refl::is_content_hashable<memoized_t<Field>>) {
+        if (args.cache != nullptr and args.dictionary == nullptr) {
+          write_memoized<T, Field>(obj);
+          return;
+        }
+      }
+      write_field_value<T, Field>(obj);
+    }
 
-      current_policy = serialize::policy::shallow;
+    template <typename T, typename Field>
+    void write_field_value(const T& obj) {
+      const auto parent_policy = current_policy;
+      current_policy           = serialize::policy::shallow;
       if constexpr (Field::template has_metadata<serialize::policy::policy_e>) {
         current_policy = Field::template get_metadata<serialize::policy::policy_e>;
         if constexpr (Field::template get_metadata<serialize::policy::policy_e> ==
                       serialize::policy::deep) {
-          current()[field_name] = JSON{};
-          push(current()[field_name]);
-
           if constexpr (Field::is_reference) {
             const auto& it = Field::from_instance(obj);
             this->handle_value(it);
           } else if constexpr (Field::is_pointer) {
             const auto* it = Field::from_instance(obj);
-            this->handle_value(*it);
+            if (it == nullptr) {
+              write_static("null");
+            } else {
+              this->handle_value(*it);
+            }
           } else {
             const auto& it = Field::from_instance(obj);
             this->handle_value(it);
           }
-
-          pop();
-        } else if constexpr (Field::template get_metadata<serialize::policy::policy_e> ==
-                             serialize::policy::shallow) {
-          current()[field_name] = JSON{};
-          push(current()[field_name]);
-
-          if constexpr (Field::is_reference) {
-            current() = "reference";
-          } else if constexpr (Field::is_pointer) {
-            current() = "reference";
+        } else {
+          if constexpr (Field::is_reference or Field::is_pointer) {
+            write_quoted("\"reference\"");
           } else {
             const auto& it = Field::from_instance(obj);
             this->handle_value(it);
           }
-
-          pop();
-        } else if constexpr (Field::template get_metadata<serialize::policy::policy_e> ==
-                             serialize::policy::skip) {
-          // do nothing
         }
       } else {
-        current()[field_name] = JSON{};
-        push(current()[field_name]);
-
         this->template visit_obj_field<T, Field>(obj);
-
-        pop();
       }
+      current_policy = parent_policy;
     }
 
     template <typename T>
     void handle_obj(const T& obj) {
-      // current()["__type"] = refl::type_name<T>;
-      this->visit_obj(obj);
+      constexpr std::size_t field_total = refl::field_count<T>;
+
+      if constexpr (emitted_fields<T> == 0) {
+        // An object that never receives a key is `null`, except at the top level
+        write_static(scopes_.empty() ? "{}" : "null");
+      } else {
+        if (std::ranges::contains(path_, static_cast<const void*>(&obj))) {
+          write_quoted("\"<circular reference>\"");
+          return;
+        }
+        path_.push_back(&obj);
+
+        static constexpr auto fields = []<std::size_t... I>(std::index_sequence<I...>) {
+          return std::array<void (*)(json_fmt&, const T&), field_total>{
+            [](json_fmt& self, const T& o) {
+              self.template instrumented<T, refl::field<T, I>>([&] {
+                self.template handle_field<T, refl::field<T, I>>(o);
+              });
+            }...
+          };
+        }(std::make_index_sequence<field_total>{});
+
+        this->template instrumented<T>([&] {
+          begin_scope('{');
+          for (const std::size_t index: sorted_fields<T>()) {
+            fields[index](*this, obj);
+          }
+          end_scope('}');
+        });
+
+        path_.pop_back();
+      }
+    }
+
+    /// Values only known through their `type_info`, reported by the thunk `type_info::from<T>()`
+    /// captured for their type
+    void handle_dynamic(const refl::type_info& type, const void* value) {
+      dynamic_writer writer{*this};
+      type.visit_value(value, writer);
+    }
+
+    void handle_dynamic_obj(const refl::type_info& type, const void* obj) {
+      const auto& fields = dynamic_fields(type);
+      if (fields.empty()) {
+        write_static(scopes_.empty() ? "{}" : "null");
+        return;
+      }
+      if (std::ranges::contains(path_, obj)) {
+        write_quoted("\"<circular reference>\"");
+        return;
+      }
+      path_.push_back(obj);
+
+      begin_scope('{');
+      for (const auto& field: fields) {
+        write_key(field.key);
+
+        const auto  parent_policy = current_policy;
+        const void* ptr           = field.info->get_ptr(const_cast<void*>(obj));
+        current_policy            = field.policy.value_or(serialize::policy::shallow);
+        if (field.policy == serialize::policy::deep and
+            (field.info->is_reference or field.info->is_pointer)) {
+          const void* target = *static_cast<const void* const*>(ptr);
+          if (target == nullptr) {
+            write_static("null");
+          } else if (field.info->is_pointer) {
+            handle_dynamic(field.info->type().indirect_type(), target);
+          } else {
+            handle_dynamic(field.info->type(), target);
+          }
+        } else if (field.info->is_reference or
+                   (field.policy.has_value() and field.info->is_pointer)) {
+          write_quoted("\"reference\"");
+        } else {
+          handle_dynamic(field.info->type(), ptr);
+        }
+        current_policy = parent_policy;
+      }
+      end_scope('}');
+
+      path_.pop_back();
+    }
+
+    void handle_archive(const refl::archive& archive) {
+      begin_scope('{');
+      for (const auto& [path, value]: archive) {
+        write_key(path);
+        this->handle_value(value);
+      }
+      end_scope('}');
     }
 
     template <refl::Reflected R>
     void serialize(const R& obj) {
-      json_ = JSON::object({});
-      push(json_);
       this->visit(obj);
-      out << json_.dump(args.pretty ? args.indent : -1);
+    }
+
+    template <typename T>
+    void serialize(const refl::tracked<T>& obj) {
+      this->visit(obj.value());
+    }
+
+    /// Writes `obj` as an object whose members come from `fragments`, one cached `"key":value`
+    /// per field index. Fields set in `refresh` are re-serialized into their fragment first, the
+    /// rest are copied as they are. With `only_refreshed`, clean fields are left out entirely.
+    template <refl::Reflected T>
+    void serialize_fields(
+      const T&                                      obj,
+      std::span<refl::string_sink>                  fragments,
+      const std::bitset<refl::field_count<T>>&      refresh,
+      bool                                          only_refreshed = false
+    ) {
+      if (args.dictionary != nullptr) {
+        // Cached fragments would replay back-references the dictionary no longer agrees with
+        throw std::invalid_argument("Incremental serialization does not support string interning");
+      }
+
+      static constexpr auto fragment_writers = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<void (*)(json_fmt<refl::string_sink>&, const T&), sizeof...(I)>{
+          [](json_fmt<refl::string_sink>& fragment, const T& o) {
+            using field = refl::field<T, I>;
+            if constexpr (not is_skipped<field>) {
+              fragment.write_string(field_key<field>());
+              fragment.out.put(':');
+              if (fragment.args.pretty) {
+                fragment.out.put(' ');
+              }
+              fragment.template handle_field_value<T, field>(o);
+            }
+          }...
+        };
+      }(std::make_index_sequence<refl::field_count<T>>{});
+
+      path_.push_back(&obj);
+      begin_scope('{');
+      for (const std::size_t index: sorted_fields<T>()) {
+        if (refresh.test(index)) {
+          auto& sink = fragments[index];
+          sink.clear();
+          json_fmt<refl::string_sink> fragment{sink, args};
+          fragment.scopes_ = scopes_;
+          fragment.path_   = path_;
+          fragment_writers[index](fragment, obj);
+        } else if (only_refreshed) {
+          continue;
+        }
+        if (fragments[index].size() > 0) {
+          next_element();
+          refl::write(out, fragments[index].view());
+        }
+      }
+      end_scope('}');
+      path_.pop_back();
+    }
+
+    void serialize(const refl::any& value) {
+      this->handle_value(value);
+    }
+
+    void serialize(const refl::any_ref& value) {
+      this->handle_value(value);
+    }
+
+    void serialize(const refl::archive& archive) {
+      this->handle_archive(archive);
+    }
+
+    /// Output position reported to the instrumentation probes
+    std::size_t bytes_written() const {
+      return refl::bytes_written(out);
+    }
+
+    /// Upper bound of the compact output of any `T`, empty if values of `T` can be arbitrarily
+    /// long (strings, containers) or are not written by value (pointers, references). Integer
+    /// members are bounded by their width in `static_type_info<T>::field_sizes`.
+    template <typename T>
+    static constexpr std::optional<std::size_t> max_size() {
+      return max_value_size<T>(sizeof(T) * std::numeric_limits<unsigned char>::digits);
+    }
+
+    /// Whether output written with `args` stays within `max_size`
+    static constexpr bool is_bounded(const args_t& args) {
+      return not args.pretty and args.dictionary == nullptr;
+    }
+
+    /// `Obj` written at compile time, the same bytes `serialize` writes for it at runtime, in an
+    /// array of exactly that size. Covers what a constant can hold: integers, `bool`, `char`,
+    /// strings held in arrays, `std::string_view` or `const char*`, `std::array`, pointers and
+    /// the reflected types made of those. Floating point members are rejected, their shortest
+    /// representation is not computed at compile time, and so are bit-fields and `deep`
+    /// references, which can't be read in constant expressions.
+    template <const auto& Obj, json_fmt_args Args = {}>
+      requires refl::Reflected<std::remove_cvref_t<decltype(Obj)>> and (Args.dictionary == nullptr)
+    static constexpr auto constant_output() {
+      std::array<char, constant_size<Obj, Args>()> output{};
+      constant_writer writer{.data = output.data(), .args = Args};
+      write_constant(writer, Obj);
+      return output;
     }
 
   private:
-    JSON& current() {
-      return *obj_stack.top();
+    template <typename>
+    friend struct json_fmt;
+
+    /// Forwards what a type's thunk reports to the writer
+    struct dynamic_writer final: refl::value_visitor {
+      explicit dynamic_writer(json_fmt& fmt_)
+          : fmt(fmt_) {}
+
+      void on_null() override {
+        fmt.write_static("null");
+      }
+      void on_bool(bool value) override {
+        fmt.write_quoted(value ? "\"true\"" : "\"false\"");
+      }
+      void on_char(char value) override {
+        fmt.write_string(std::string_view{&value, 1});
+      }
+      void on_int(std::int64_t value) override {
+        fmt.write_integer(value);
+      }
+      void on_uint(std::uint64_t value) override {
+        fmt.write_integer(value);
+      }
+      void on_float(double value, bool) override {
+        fmt.write_float(value);
+      }
+      void on_string(std::string_view value) override {
+        fmt.write_string(value);
+      }
+      void on_formatted(std::string_view value) override {
+        fmt.write_string(value);
+      }
+
+      void on_pointer(
+        const refl::type_info* type, const void* target, refl::pointer_kind kind
+      ) override {
+        const bool deep = fmt.current_policy == serialize::policy::deep;
+        switch (kind) {
+          case refl::pointer_kind::unique:
+            break;
+          case refl::pointer_kind::shared:
+            if (not deep) {
+              fmt.write_quoted("\"reference\"");
+              return;
+            }
+            break;
+          case refl::pointer_kind::weak:
+            if (target != nullptr and not deep) {
+              fmt.write_quoted("\"reference\"");
+              return;
+            }
+            break;
+          case refl::pointer_kind::raw:
+          default:
+            fmt.write_quoted("\"reference\"");
+            return;
+        }
+
+        if (target == nullptr or type == nullptr) {
+          fmt.write_static("null");
+        } else {
+          fmt.handle_dynamic(*type, target);
+        }
+      }
+
+      void begin_sequence(std::size_t) override {
+        fmt.begin_scope('[');
+      }
+      void on_element(const refl::type_info& type, const void* value) override {
+        fmt.next_element();
+        fmt.handle_dynamic(type, value);
+      }
+      void end_sequence() override {
+        fmt.end_scope(']');
+      }
+
+      // Entries are buffered so they can be written with sorted keys, like the static path does
+      void begin_mapping(std::size_t size) override {
+        entries.reserve(size);
+      }
+      void on_entry(std::string_view key, const refl::type_info& type, const void* value) override {
+        entries.push_back({key, &type, value});
+      }
+      void end_mapping() override {
+        std::ranges::sort(entries, std::less<>{}, &entry::key);
+        fmt.begin_scope('{');
+        for (const auto& [key, type, value]: entries) {
+          fmt.write_key(key);
+          fmt.handle_dynamic(*type, value);
+        }
+        fmt.end_scope('}');
+      }
+
+      void on_object(const refl::type_info& type, const void* value) override {
+        fmt.handle_dynamic_obj(type, value);
+      }
+
+      struct entry {
+        std::string_view       key;
+        const refl::type_info* type;
+        const void*            value;
+      };
+
+      json_fmt&          fmt;
+      std::vector<entry> entries{};
+    };
+
+    struct dynamic_field {
+      std::string                                key;
+      const refl::field_info*                    info;
+      std::optional<serialize::policy::policy_e> policy;
+    };
+
+    /// Runtime equivalent of `sorted_fields`, skipped fields are left out
+    static const std::vector<dynamic_field>& dynamic_fields(const refl::type_info& type) {
+      thread_local std::unordered_map<const refl::type_info*, std::vector<dynamic_field>> cache{};
+
+      auto [it, inserted] = cache.try_emplace(&type);
+      if (inserted) {
+        auto& fields = it->second;
+        for (const auto& field: type.fields()) {
+          std::optional<serialize::policy::policy_e> policy{};
+          if (field.has_metadata<serialize::policy::policy_e>()) {
+            policy = field.get_metadata<serialize::policy::policy_e>();
+          }
+          if (policy == serialize::policy::skip) {
+            continue;
+          }
+          fields.push_back({
+            .key    = field.has_metadata<serialize::name>()
+                        ? field.get_metadata<serialize::name>().value
+                        : field.name,
+            .info   = &field,
+            .policy = policy,
+          });
+        }
+        std::ranges::stable_sort(fields, std::less<>{}, &dynamic_field::key);
+      }
+      return it->second;
+    }
+
+    template <typename T>
+    static constexpr bool is_iterable =
+      packtl::is_type<std::vector, T>::value or refl::is_std_array<T>::value or
+      packtl::is_type<std::list, T>::value or packtl::is_type<std::deque, T>::value or
+      packtl::is_type<std::map, T>::value or packtl::is_type<std::unordered_map, T>::value or
+      packtl::is_type<std::set, T>::value or packtl::is_type<std::unordered_set, T>::value;
+
+    template <typename T>
+    static constexpr bool is_string_keyed = [] {
+      if constexpr (std::__is_std_pair<typename T::value_type>) {
+        using first_type = typename T::value_type::first_type;
+        return std::same_as<first_type, std::string> or std::same_as<first_type, const std::string>;
+      } else {
+        return false;
+      }
+    }();
+
+    template <typename T>
+    static constexpr bool is_sorted_by_key =
+      packtl::is_type<std::map, T>::value and
+      std::same_as<typename T::key_compare, std::less<std::string>>;
+
+    template <typename Field>
+    static constexpr bool is_skipped = [] {
+      if constexpr (Field::template has_metadata<serialize::policy::policy_e>) {
+        return Field::template get_metadata<serialize::policy::policy_e> ==
+               serialize::policy::skip;
+      } else {
+        return false;
+      }
+    }();
+
+    /// Fields of `T` that are written, an object with none is `null`
+    template <typename T>
+    static constexpr std::size_t emitted_fields = []<std::size_t... I>(std::index_sequence<I...>) {
+      return (std::size_t{0} + ... + (is_skipped<refl::field<T, I>> ? 0 : 1));
+    }(std::make_index_sequence<refl::field_count<T>>{});
+
+    template <typename Field>
+    static std::string field_key() {
+      if constexpr (Field::template has_metadata<serialize::name>) {
+        return Field::template get_metadata<serialize::name>.value;
+      } else {
+        return Field::name;
+      }
+    }
+
+    /// Field indices ordered by serialized key, computed once per type
+    template <typename T>
+    static const std::vector<std::size_t>& sorted_fields() {
+      static const std::vector<std::size_t> order = [] {
+        std::vector<std::pair<std::string, std::size_t>> keys{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (keys.emplace_back(field_key<refl::field<T, I>>(), I), ...);
+        }(std::make_index_sequence<refl::field_count<T>>{});
+        std::ranges::stable_sort(keys, std::less<>{}, [](const auto& key) -> const std::string& {
+          return key.first;
+        });
+
+        std::vector<std::size_t> indices{};
+        indices.reserve(keys.size());
+        for (const auto& [key, index]: keys) {
+          indices.push_back(index);
+        }
+        return indices;
+      }();
+      return order;
+    }
+
+    void write_static(std::string_view str) {
+      refl::write_static(out, str);
+    }
+
+    /// Characters in the longest decimal value of an integer `bits` wide, sign included
+    static constexpr std::size_t decimal_width(std::size_t bits, bool is_signed) {
+      std::uint64_t magnitude = ~std::uint64_t{0};
+      if (is_signed) {
+        magnitude = std::uint64_t{1} << (bits - 1);
+      } else if (bits < 64) {
+        magnitude = (std::uint64_t{1} << bits) - 1;
+      }
+      std::size_t width = is_signed ? 2 : 1;
+      for (; magnitude >= 10; magnitude /= 10) {
+        ++width;
+      }
+      return width;
+    }
+
+    /// Longest text `write_float` produces, e.g. `-2.2250738585072014e-308`, with some slack
+    static constexpr std::size_t max_float_width = 32;
+
+    static constexpr std::size_t quoted_size(std::string_view str) {
+      std::size_t size = 2;
+      for (const char c: str) {
+        switch (c) {
+          case '"':
+          case '\\':
+          case '\b':
+          case '\f':
+          case '\n':
+          case '\r':
+          case '\t':
+            size += 2;
+            break;
+          default:
+            size += static_cast<unsigned char>(c) < 0x20 ? 6 : 1;
+            break;
+        }
+      }
+      return size;
+    }
+
+    /// `bits` is the width of the value, smaller than its type for bit-fields
+    template <typename T>
+    static constexpr std::optional<std::size_t> max_value_size(std::size_t bits) {
+      if constexpr (std::same_as<T, bool>) {
+        return quoted_size("false");
+      } else if constexpr (std::same_as<T, char>) {
+        return quoted_size("\x01");
+      } else if constexpr (std::same_as<T, int> or std::same_as<T, unsigned int> or
+                           std::same_as<T, short> or std::same_as<T, unsigned short> or
+                           std::same_as<T, long> or std::same_as<T, unsigned long>) {
+        return decimal_width(bits, std::is_signed_v<T>);
+      } else if constexpr (std::same_as<T, float> or std::same_as<T, double>) {
+        return max_float_width;
+      } else if constexpr (refl::is_std_array<T>::value) {
+        using element_type            = typename T::value_type;
+        constexpr std::size_t count   = std::tuple_size_v<T>;
+        const auto            element = max_size<element_type>();
+        if (not element.has_value()) {
+          return std::nullopt;
+        }
+        return count == 0 ? 2 : 2 + count * *element + (count - 1);
+      } else if constexpr (refl::Reflected<T>) {
+        return max_object_size<T>();
+      } else {
+        return std::nullopt;
+      }
+    }
+
+    template <typename T>
+    static constexpr std::optional<std::size_t> max_object_size() {
+      std::size_t total   = 0;
+      std::size_t emitted = 0;
+      bool        bounded = true;
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+          [&] {
+            using field = refl::field<T, I>;
+            if constexpr (not is_skipped<field>) {
+              if constexpr (field::is_reference or field::is_pointer) {
+                bounded = false;
+              } else {
+                const auto value =
+                  max_value_size<std::remove_cvref_t<typename field::type>>(field::size);
+                if (value.has_value()) {
+                  total += quoted_size(constexpr_key<field>()) + 1 + *value;
+                  ++emitted;
+                } else {
+                  bounded = false;
+                }
+              }
+            }
+          }(),
+          ...
+        );
+      }(std::make_index_sequence<refl::field_count<T>>{});
+
+      if (not bounded) {
+        return std::nullopt;
+      }
+      // `null`, or `{}` at the top level
+      return emitted == 0 ? 4 : 2 + total + (emitted - 1);
+    }
+
+    template <typename Field>
+    static constexpr std::string_view constexpr_key() {
+      if constexpr (Field::template has_metadata<serialize::name>) {
+        return Field::template get_metadata<serialize::name>.value;
+      } else {
+        return Field::name;
+      }
+    }
+
+    /// Output of `constant_output`, produced twice: first with no `data` to measure it, then into
+    /// an array of that size
+    struct constant_writer {
+      char*                    data = nullptr;
+      std::size_t              size = 0;
+      json_fmt_args            args{};
+      std::vector<bool>        scopes{};
+      std::vector<const void*> path{};
+
+      constexpr void put(char c) {
+        if (data != nullptr) {
+          data[size] = c;
+        }
+        ++size;
+      }
+
+      constexpr void write(std::string_view str) {
+        for (const char c: str) {
+          put(c);
+        }
+      }
+
+      constexpr void begin_scope(char open) {
+        put(open);
+        scopes.push_back(true);
+      }
+
+      constexpr void end_scope(char close) {
+        const bool empty = scopes.back();
+        scopes.pop_back();
+        if (args.pretty and not empty) {
+          put('\n');
+          write_indent();
+        }
+        put(close);
+      }
+
+      constexpr void next_element() {
+        if (not scopes.back()) {
+          put(',');
+        }
+        scopes.back() = false;
+        if (args.pretty) {
+          put('\n');
+          write_indent();
+        }
+      }
+
+      constexpr void write_indent() {
+        for (std::size_t i = 0; i < scopes.size() * args.indent; ++i) {
+          put(' ');
+        }
+      }
+
+      constexpr void write_key(std::string_view key) {
+        next_element();
+        write_string(key);
+        put(':');
+        if (args.pretty) {
+          put(' ');
+        }
+      }
+
+      constexpr void write_string(std::string_view str) {
+        std::array<char, 6> unicode{};
+        put('"');
+        for (const char c: str) {
+          const std::string_view escape = escape_sequence(c, unicode);
+          if (escape.empty()) {
+            put(c);
+          } else {
+            write(escape);
+          }
+        }
+        put('"');
+      }
+
+      template <typename N>
+      constexpr void write_integer(N value) {
+        std::array<char, 24> buffer{};
+        auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        write(std::string_view{buffer.data(), end});
+      }
+    };
+
+    template <const auto& Obj, json_fmt_args Args>
+    static constexpr std::size_t constant_size() {
+      constant_writer writer{.args = Args};
+      write_constant(writer, Obj);
+      return writer.size;
+    }
+
+    /// `handle_value`, for the types a constant can hold
+    template <typename T>
+    static constexpr void write_constant(constant_writer& writer, const T& it) {
+      if constexpr (std::is_pointer_v<T>) {
+        if constexpr (std::same_as<T, char*> or std::same_as<T, const char*>) {
+          if (it == nullptr) {
+            writer.write("null");
+          } else {
+            writer.write_string(it);
+          }
+        } else {
+          writer.write("\"reference\"");
+        }
+      } else if constexpr (refl::is_std_array<T>::value) {
+        writer.begin_scope('[');
+        for (const auto& element: it) {
+          writer.next_element();
+          write_constant(writer, element);
+        }
+        writer.end_scope(']');
+      } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+        writer.write_string(std::string_view{it});
+      } else if constexpr (std::same_as<T, int> or std::same_as<T, unsigned int> or
+                           std::same_as<T, short> or std::same_as<T, unsigned short> or
+                           std::same_as<T, long> or std::same_as<T, unsigned long>) {
+        writer.write_integer(it);
+      } else if constexpr (std::same_as<T, bool>) {
+        writer.write(it ? "\"true\"" : "\"false\"");
+      } else if constexpr (refl::Reflected<T>) {
+        write_constant_obj(writer, it);
+      } else if constexpr (std::same_as<T, char>) {
+        writer.write_string(std::string_view{&it, 1});
+      } else if constexpr (std::integral<T> and std::formattable<T, char>) {
+        // Formatted, and therefore quoted, at runtime
+        using wide = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+        writer.put('"');
+        writer.write_integer(static_cast<wide>(it));
+        writer.put('"');
+      } else if constexpr (std::is_floating_point_v<T> or std::formattable<T, char>) {
+        static_assert(false, "type can't be serialized at compile time");
+      } else {
+        writer.write("null");
+      }
     }
 
-    void push(JSON& obj) {
-      obj_stack.push(&obj);
+    template <typename T>
+    static constexpr void write_constant_obj(constant_writer& writer, const T& obj) {
+      if constexpr (emitted_fields<T> == 0) {
+        writer.write(writer.scopes.empty() ? "{}" : "null");
+      } else {
+        if (std::ranges::contains(writer.path, static_cast<const void*>(&obj))) {
+          writer.write("\"<circular reference>\"");
+          return;
+        }
+        writer.path.push_back(&obj);
+
+        writer.begin_scope('{');
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (write_constant_field<T, refl::field<T, constant_field_order<T>[I]>>(writer, obj), ...);
+        }(std::make_index_sequence<refl::field_count<T>>{});
+        writer.end_scope('}');
+
+        writer.path.pop_back();
+      }
     }
 
-    void pop() {
-      obj_stack.pop();
+    /// `handle_field`, following the same pointer and reference policies
+    template <typename T, typename Field>
+    static constexpr void write_constant_field(constant_writer& writer, const T& obj) {
+      if constexpr (not is_skipped<Field>) {
+        writer.write_key(constexpr_key<Field>());
+        if constexpr (Field::template has_metadata<serialize::policy::policy_e>) {
+          if constexpr (Field::template get_metadata<serialize::policy::policy_e> ==
+                        serialize::policy::deep) {
+            if constexpr (Field::is_pointer) {
+              const auto* it = Field::from_instance(obj);
+              if (it == nullptr) {
+                writer.write("null");
+              } else {
+                write_constant(writer, *it);
+              }
+            } else {
+              write_constant(writer, Field::from_instance(obj));
+            }
+          } else if constexpr (Field::is_reference or Field::is_pointer) {
+            writer.write("\"reference\"");
+          } else {
+            write_constant(writer, Field::from_instance(obj));
+          }
+        } else if constexpr (Field::is_reference) {
+          writer.write("\"reference\"");
+        } else {
+          write_constant(writer, Field::from_instance(obj));
+        }
+      }
+    }
+
+    /// `sorted_fields` at compile time, ties keep declaration order
+    template <typename T>
+    static constexpr auto constant_field_order = [] {
+      constexpr std::size_t count = refl::field_count<T>;
+      const auto            keys  = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<std::string_view, count>{constexpr_key<refl::field<T, I>>()...};
+      }(std::make_index_sequence<count>{});
+
+      std::array<std::size_t, count> order{};
+      for (std::size_t i = 0; i < count; ++i) {
+        order[i] = i;
+        for (std::size_t j = i; j > 0 and keys[order[j]] < keys[order[j - 1]]; --j) {
+          std::swap(order[j], order[j - 1]);
+        }
+      }
+      return order;
+    }();
+
+    /// A string literal that needs no escaping, quotes included, e.g. `"\"reference\""`
+    void write_quoted(std::string_view quoted) {
+      if (args.dictionary == nullptr) {
+        write_static(quoted);
+      } else {
+        write_string(quoted.substr(1, quoted.size() - 2));
+      }
+    }
+
+    /// What `write_memoized` hashes for `Field`, its target when it is a pointer
+    template <typename Field>
+    using memoized_t = std::remove_cvref_t<std::remove_pointer_t<typename Field::type>>;
+
+    /// Value of an immutable field, copied from `args.cache` when the same content was written
+    /// before. Only used for fields that are `refl::is_content_hashable`, other values that differ
+    /// could share a `deep_hash` and then their output.
+    template <typename T, typename Field>
+    void write_memoized(const T& obj) {
+      // The value hashed, or null for a null pointer
+      const auto* value = [&] {
+        if constexpr (Field::is_pointer) {
+          return Field::from_instance(obj);
+        } else {
+          return &Field::from_instance(obj);
+        }
+      }();
+      const refl::serialization_cache_key key{
+        .type       = refl::type_id<T> ^ (Field::index * 0x9e3779b97f4a7c15),
+        .content    = value == nullptr ? 0 : refl::deep_hash(*value),
+        .zero_signs = value == nullptr ? 0 : refl::zero_signs_hash(*value),
+        .format     = refl::type_id<args_t>,
+        // Pretty output is indented by how deep the field is
+        .args       = args.pretty ? (std::uint64_t{args.indent} << 32 | scopes_.size()) + 1 : 0,
+      };
+
+      if (const auto bytes = args.cache->find(key)) {
+        refl::write(out, *bytes);
+        return;
+      }
+
+      refl::string_sink           sink{};
+      json_fmt<refl::string_sink> fragment{sink, args};
+      fragment.scopes_ = scopes_;
+      fragment.path_   = path_;
+      fragment.template write_field_value<T, Field>(obj);
+      refl::write(out, sink.view());
+      args.cache->insert(key, sink.str());
+    }
+
+    void begin_scope(char open) {
+      out.put(open);
+      scopes_.push_back(true);
+    }
+
+    void end_scope(char close) {
+      const bool empty = scopes_.back();
+      scopes_.pop_back();
+      if (args.pretty and not empty) {
+        out.put('\n');
+        refl::write_indent(out, scopes_.size() * args.indent);
+      }
+      out.put(close);
+    }
+
+    void next_element() {
+      if (not scopes_.back()) {
+        out.put(',');
+      }
+      scopes_.back() = false;
+      if (args.pretty) {
+        out.put('\n');
+        refl::write_indent(out, scopes_.size() * args.indent);
+      }
+    }
+
+    void write_key(std::string_view key) {
+      next_element();
+      if (args.dictionary == nullptr) {
+        write_string(key);
+      } else if (const auto id = args.dictionary->intern(key)) {
+        out.put('"');
+        out.put('^');
+        write_integer(*id);
+        out.put('"');
+      } else {
+        out.put('"');
+        if (key.starts_with('^')) {
+          out.put('^');
+        }
+        write_escaped(key);
+        out.put('"');
+      }
+      out.put(':');
+      if (args.pretty) {
+        out.put(' ');
+      }
+    }
+
+    void write_string(std::string_view str) {
+      if (args.dictionary != nullptr) {
+        if (const auto id = args.dictionary->intern(str)) {
+          out.put('[');
+          write_integer(*id);
+          out.put(']');
+          return;
+        }
+      }
+      out.put('"');
+      write_escaped(str);
+      out.put('"');
+    }
+
+    /// The contents of a JSON string, without the quotes
+    void write_escaped(std::string_view str) {
+      std::array<char, 6> unicode{};
+      std::size_t         run_start = 0;
+      for (std::size_t i = 0; i < str.size(); ++i) {
+        const std::string_view escape = escape_sequence(str[i], unicode);
+        if (not escape.empty()) {
+          refl::write(out, str.substr(run_start, i - run_start));
+          refl::write(out, escape);
+          run_start = i + 1;
+        }
+      }
+      refl::write(out, str.substr(run_start));
+    }
+
+    /// How `c` is written inside a JSON string, empty if it needs no escaping. `\u00XX` sequences
+    /// are built in `unicode`.
+    static constexpr std::string_view escape_sequence(char c, std::array<char, 6>& unicode) {
+      constexpr std::string_view hex = "0123456789abcdef";
+      switch (c) {
+        case '"':
+          return "\\\"";
+        case '\\':
+          return "\\\\";
+        case '\b':
+          return "\\b";
+        case '\f':
+          return "\\f";
+        case '\n':
+          return "\\n";
+        case '\r':
+          return "\\r";
+        case '\t':
+          return "\\t";
+        default:
+          break;
+      }
+      const auto code = static_cast<unsigned char>(c);
+      if (code >= 0x20) {
+        return {};
+      }
+      unicode = {'\\', 'u', '0', '0', hex[code >> 4], hex[code & 0xF]};
+      return {unicode.data(), unicode.size()};
+    }
+
+    template <typename N>
+    void write_integer(N value) {
+      std::array<char, 24> buffer{};
+      auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+      refl::write(out, std::string_view{buffer.data(), end});
+    }
+
+    void write_float(double value) {
+      if (not std::isfinite(value)) {
+        write_static("null");
+        return;
+      }
+      // Same shortest round-trip formatting nlohmann::json uses when dumping
+      std::array<char, 64> buffer{};
+      char* end = nlohmann::detail::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+      refl::write(out, std::string_view{buffer.data(), end});
     }
 
   private:
-    std::unordered_set<std::size_t> visited_{};
-    O&                              out;
-    args_t                          args;
-    JSON                            json_;
-    std::stack<JSON*>               obj_stack;
+    O&                        out;
+    args_t                    args;
+    std::vector<bool>         scopes_{};
+    std::vector<const void*>  path_{};
 
     serialize::policy::policy_e current_policy{serialize::policy::shallow};
   };
@@ -0,0 +1,260 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  msgpack.cppm
+ *! \brief MessagePack writer and reader.
+ *!
+ */
+
+export module reflect.marshal.formats.msgpack;
+
+import std;
+
+import reflect;
+
+import reflect.marshal.formats.binary;
+
+export namespace formats {
+  /// Headers of MessagePack (https://github.com/msgpack/msgpack/blob/master/spec.md), always
+  /// written in their shortest form. Binary and extension values are read as bytes.
+  struct msgpack_encoding {
+    static constexpr std::string_view name = "MessagePack";
+
+    template <typename O>
+    static void write_nil(O& out) {
+      out.put('\xC0');
+    }
+
+    template <typename O>
+    static void write_bool(O& out, bool value) {
+      out.put(value ? '\xC3' : '\xC2');
+    }
+
+    template <typename O>
+    static void write_uint(O& out, std::uint64_t value) {
+      if (value < 0x80) {
+        out.put(static_cast<char>(value));
+      } else if (value <= 0xFF) {
+        detail::write_big_endian(out, 0xCC, value, 1);
+      } else if (value <= 0xFFFF) {
+        detail::write_big_endian(out, 0xCD, value, 2);
+      } else if (value <= 0xFFFF'FFFF) {
+        detail::write_big_endian(out, 0xCE, value, 4);
+      } else {
+        detail::write_big_endian(out, 0xCF, value, 8);
+      }
+    }
+
+    template <typename O>
+    static void write_int(O& out, std::int64_t value) {
+      const auto bits = static_cast<std::uint64_t>(value);
+      if (value >= 0) {
+        write_uint(out, bits);
+      } else if (value >= -32) {
+        out.put(static_cast<char>(value));
+      } else if (value >= std::numeric_limits<std::int8_t>::min()) {
+        detail::write_big_endian(out, 0xD0, bits, 1);
+      } else if (value >= std::numeric_limits<std::int16_t>::min()) {
+        detail::write_big_endian(out, 0xD1, bits, 2);
+      } else if (value >= std::numeric_limits<std::int32_t>::min()) {
+        detail::write_big_endian(out, 0xD2, bits, 4);
+      } else {
+        detail::write_big_endian(out, 0xD3, bits, 8);
+      }
+    }
+
+    template <typename O>
+    static void write_float(O& out, float value) {
+      detail::write_big_endian(out, 0xCA, std::bit_cast<std::uint32_t>(value), 4);
+    }
+
+    template <typename O>
+    static void write_double(O& out, double value) {
+      detail::write_big_endian(out, 0xCB, std::bit_cast<std::uint64_t>(value), 8);
+    }
+
+    template <typename O>
+    static void write_text_header(O& out, std::size_t size) {
+      if (size < 32) {
+        out.put(static_cast<char>(0xA0 | size));
+      } else if (size <= 0xFF) {
+        detail::write_big_endian(out, 0xD9, size, 1);
+      } else if (size <= 0xFFFF) {
+        detail::write_big_endian(out, 0xDA, size, 2);
+      } else {
+        detail::write_big_endian(out, 0xDB, size, 4);
+      }
+    }
+
+    template <typename O>
+    static void write_array_header(O& out, std::size_t size) {
+      if (size < 16) {
+        out.put(static_cast<char>(0x90 | size));
+      } else if (size <= 0xFFFF) {
+        detail::write_big_endian(out, 0xDC, size, 2);
+      } else {
+        detail::write_big_endian(out, 0xDD, size, 4);
+      }
+    }
+
+    template <typename O>
+    static void write_map_header(O& out, std::size_t size) {
+      if (size < 16) {
+        out.put(static_cast<char>(0x80 | size));
+      } else if (size <= 0xFFFF) {
+        detail::write_big_endian(out, 0xDE, size, 2);
+      } else {
+        detail::write_big_endian(out, 0xDF, size, 4);
+      }
+    }
+
+    /// Header at `pos`, moving `pos` past it. False if it is invalid or truncated.
+    static bool decode(std::string_view input, std::size_t& pos, binary_token& token) {
+      if (pos >= input.size()) {
+        return false;
+      }
+      const auto lead = static_cast<std::uint8_t>(input[pos++]);
+      // Length, or value, of `bytes` bytes following the lead byte
+      const auto sized = [&](binary_kind kind, std::size_t bytes) {
+        token = {.kind = kind};
+        return detail::read_big_endian(input, pos, bytes, token.value);
+      };
+      // Extension types are skipped as bytes, after their type byte
+      const auto extension = [&](std::uint64_t size) {
+        token = {.kind = binary_kind::bytes, .value = size};
+        return pos++ < input.size();
+      };
+      // Signed integer of `bytes` bytes, sign extended
+      const auto integer = [&](std::size_t bytes) {
+        std::uint64_t bits = 0;
+        if (not detail::read_big_endian(input, pos, bytes, bits)) {
+          return false;
+        }
+        const std::size_t  unused = 64 - 8 * bytes;
+        const std::int64_t value  = static_cast<std::int64_t>(bits << unused) >> unused;
+        if (value >= 0) {
+          token = {.kind = binary_kind::uint, .value = static_cast<std::uint64_t>(value)};
+        } else {
+          token = {.kind = binary_kind::nint, .value = static_cast<std::uint64_t>(-1 - value)};
+        }
+        return true;
+      };
+
+      if (lead < 0x80) {
+        token = {.kind = binary_kind::uint, .value = lead};
+        return true;
+      }
+      if (lead >= 0xE0) {
+        token = {.kind = binary_kind::nint, .value = static_cast<std::uint64_t>(0xFF - lead)};
+        return true;
+      }
+      switch (lead & 0xF0) {
+        case 0x80:
+          token = {.kind = binary_kind::map, .value = lead & 0x0Fu};
+          return true;
+        case 0x90:
+          token = {.kind = binary_kind::array, .value = lead & 0x0Fu};
+          return true;
+        case 0xA0:
+        case 0xB0:
+          token = {.kind = binary_kind::text, .value = lead & 0x1Fu};
+          return true;
+        default:
+          break;
+      }
+      switch (lead) {
+        case 0xC0:
+          token = {.kind = binary_kind::nil};
+          return true;
+        case 0xC2:
+        case 0xC3:
+          token = {.kind = binary_kind::boolean, .value = lead & 1u};
+          return true;
+        case 0xC4:
+          return sized(binary_kind::bytes, 1);
+        case 0xC5:
+          return sized(binary_kind::bytes, 2);
+        case 0xC6:
+          return sized(binary_kind::bytes, 4);
+        case 0xC7:
+          return sized(binary_kind::bytes, 1) and extension(token.value);
+        case 0xC8:
+          return sized(binary_kind::bytes, 2) and extension(token.value);
+        case 0xC9:
+          return sized(binary_kind::bytes, 4) and extension(token.value);
+        case 0xCA: {
+          std::uint64_t bits = 0;
+          if (not detail::read_big_endian(input, pos, 4, bits)) {
+            return false;
+          }
+          const auto value = std::bit_cast<float>(static_cast<std::uint32_t>(bits));
+          token            = {.kind = binary_kind::floating, .real = value};
+          return true;
+        }
+        case 0xCB: {
+          std::uint64_t bits = 0;
+          if (not detail::read_big_endian(input, pos, 8, bits)) {
+            return false;
+          }
+          token = {.kind = binary_kind::floating, .real = std::bit_cast<double>(bits)};
+          return true;
+        }
+        case 0xCC:
+          return sized(binary_kind::uint, 1);
+        case 0xCD:
+          return sized(binary_kind::uint, 2);
+        case 0xCE:
+          return sized(binary_kind::uint, 4);
+        case 0xCF:
+          return sized(binary_kind::uint, 8);
+        case 0xD0:
+          return integer(1);
+        case 0xD1:
+          return integer(2);
+        case 0xD2:
+          return integer(4);
+        case 0xD3:
+          return integer(8);
+        case 0xD4:
+        case 0xD5:
+        case 0xD6:
+        case 0xD7:
+        case 0xD8:
+          return extension(std::uint64_t{1} << (lead - 0xD4));
+        case 0xD9:
+          return sized(binary_kind::text, 1);
+        case 0xDA:
+          return sized(binary_kind::text, 2);
+        case 0xDB:
+          return sized(binary_kind::text, 4);
+        case 0xDC:
+          return sized(binary_kind::array, 2);
+        case 0xDD:
+          return sized(binary_kind::array, 4);
+        case 0xDE:
+          return sized(binary_kind::map, 2);
+        case 0xDF:
+          return sized(binary_kind::map, 4);
+        default:
+          // 0xC1 is never used
+          return false;
+      }
+    }
+  };
+
+  /// MessagePack writer, e.g. `refl::to_string<formats::msgpack_fmt>(obj)`
+  template <typename O>
+  using msgpack_fmt = binary_fmt<O, msgpack_encoding>;
+} // namespace formats
+
+export namespace refl {
+  /// Decodes the MessagePack map `bytes` into `out`, see `binary_reader`. Members missing from the
+  /// input keep their value and unknown keys are skipped. `std::string_view` members point into
+  /// `bytes`.
+  template <Reflected T>
+  void read_msgpack(std::string_view bytes, T& out) {
+    binary_reader<formats::msgpack_encoding> reader{bytes};
+    reader.read_value(out);
+    reader.finish();
+  }
+} // namespace refl
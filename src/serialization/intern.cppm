@@ -0,0 +1,117 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  intern.cppm
+ *! \brief Dictionary of repeated strings shared by the serializations of one stream.
+ *!
+ */
+
+export module reflect.marshal.intern;
+
+import std;
+
+export namespace refl {
+  struct string_dictionary_options {
+    /// Shorter strings are always written out, a back-reference would not be much smaller
+    std::size_t min_length = 4;
+    /// Once full, new strings are written out without being remembered
+    std::size_t max_entries = std::size_t{1} << 16;
+  };
+
+  /// Ids of the strings written into one stream. The writer and the reader of a stream each keep
+  /// their own dictionary built with the same options: both remember every eligible string the
+  /// first time it goes by, so ids never have to be transmitted and only repeats are replaced by
+  /// back-references.
+  ///
+  /// Every remembered string is copied into a few large blocks owned by the dictionary, views
+  /// handed out by it stay valid until it is cleared or destroyed.
+  class string_dictionary {
+  public:
+    explicit string_dictionary(string_dictionary_options opts = {})
+        : opts_(opts) {}
+
+    string_dictionary(const string_dictionary&)            = delete;
+    string_dictionary& operator=(const string_dictionary&) = delete;
+
+    /// Writer side: the id of `str` if it was seen before, otherwise remembers it if eligible
+    std::optional<std::uint32_t> intern(std::string_view str) {
+      if (str.size() < opts_.min_length) {
+        return std::nullopt;
+      }
+      if (const auto it = ids_.find(str); it != ids_.end()) {
+        return it->second;
+      }
+      if (entries_.size() < opts_.max_entries) {
+        const std::string_view stored = store(str);
+        ids_.emplace(stored, static_cast<std::uint32_t>(entries_.size()));
+        entries_.push_back(stored);
+      }
+      return std::nullopt;
+    }
+
+    /// Reader side: remembers `str` if eligible, mirroring `intern`. Returns the remembered copy,
+    /// or `str` itself when it was not eligible.
+    std::string_view add(std::string_view str) {
+      if (str.size() < opts_.min_length or entries_.size() >= opts_.max_entries) {
+        return str;
+      }
+      return entries_.emplace_back(store(str));
+    }
+
+    /// Throws `std::out_of_range` for ids that were never assigned
+    std::string_view at(std::uint32_t id) const {
+      if (id >= entries_.size()) {
+        throw std::out_of_range(std::format("Unknown string id {}", id));
+      }
+      return entries_[id];
+    }
+
+    /// Copies `str` into the dictionary's buffer without giving it an id
+    std::string_view store(std::string_view str) {
+      if (str.empty()) {
+        return {};
+      }
+      if (str.size() > block_size - std::min(used_, block_size)) {
+        if (str.size() > block_size / 4) {
+          // Large strings get a block of their own, the current one keeps being filled
+          auto& block = oversized_.emplace_back(std::make_unique<char[]>(str.size()));
+          std::ranges::copy(str, block.get());
+          return {block.get(), str.size()};
+        }
+        blocks_.push_back(std::make_unique<char[]>(block_size));
+        used_ = 0;
+      }
+      char* dest = blocks_.back().get() + used_;
+      std::ranges::copy(str, dest);
+      used_ += str.size();
+      return {dest, str.size()};
+    }
+
+    std::size_t size() const {
+      return entries_.size();
+    }
+
+    const string_dictionary_options& options() const {
+      return opts_;
+    }
+
+    /// Forgets every string and releases the buffer, e.g. between two streams
+    void clear() {
+      ids_.clear();
+      entries_.clear();
+      blocks_.clear();
+      oversized_.clear();
+      used_ = block_size;
+    }
+
+  private:
+    static constexpr std::size_t block_size = std::size_t{64} << 10;
+
+    string_dictionary_options                              opts_;
+    std::unordered_map<std::string_view, std::uint32_t>    ids_{};
+    std::vector<std::string_view>                          entries_{};
+    std::vector<std::unique_ptr<char[]>>                   blocks_{};
+    std::vector<std::unique_ptr<char[]>>                   oversized_{};
+    std::size_t                                            used_ = block_size;
+  };
+} // namespace refl
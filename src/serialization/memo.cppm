@@ -0,0 +1,158 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  memo.cppm
+ *! \brief Cache of the serialized bytes of immutable subtrees, addressed by their content.
+ *!
+ */
+
+export module reflect.marshal.memo;
+
+import std;
+
+export namespace refl {
+  /// Identifies the output of one subtree: what it is, what it contains and how it is written
+  struct serialization_cache_key {
+    /// Type the subtree belongs to and its place in it
+    std::uint64_t type;
+    /// `deep_hash` of the subtree
+    std::uint64_t content;
+    /// `zero_signs_hash` of the subtree, `deep_hash` does not tell `0.0` from `-0.0`
+    std::uint64_t zero_signs;
+    /// Format writing it
+    std::uint64_t format;
+    /// Format arguments that change the output, and nesting depth when they make it matter
+    std::uint64_t args;
+
+    bool operator==(const serialization_cache_key&) const = default;
+  };
+
+  struct serialization_cache_options {
+    /// Least recently used entries are evicted beyond this many
+    std::size_t max_entries = 1024;
+    /// ... or beyond this many bytes in total. Larger outputs are never cached.
+    std::size_t max_bytes = std::size_t{64} << 20;
+  };
+
+  /// Bounded LRU of serialized subtrees, for `formats::json_fmt_args::cache`. Formats look up the
+  /// fields marked `serialize::immutable` here and splice the cached bytes into the output on a
+  /// hit. It can be shared by any number of serializations, across threads.
+  class serialization_cache {
+  public:
+    using key_type = serialization_cache_key;
+    using value    = std::shared_ptr<const std::string>;
+
+    explicit serialization_cache(serialization_cache_options opts = {})
+        : opts_(opts) {}
+
+    serialization_cache(const serialization_cache&)            = delete;
+    serialization_cache& operator=(const serialization_cache&) = delete;
+
+    /// Cached output for `key`, counted as a hit, or null, counted as a miss
+    value find(const key_type& key) {
+      std::lock_guard lock{mutex_};
+      const auto      it = index_.find(key);
+      if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+      }
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->bytes;
+    }
+
+    /// Caches `bytes` as the output for `key`, evicting the least recently used entries as needed
+    void insert(const key_type& key, std::string bytes) {
+      if (bytes.size() > opts_.max_bytes or opts_.max_entries == 0) {
+        return;
+      }
+
+      std::lock_guard lock{mutex_};
+      if (const auto it = index_.find(key); it != index_.end()) {
+        // Serialized by another thread in the meantime, both outputs are the same
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+      }
+      bytes_ += bytes.size();
+      entries_.push_front({key, std::make_shared<const std::string>(std::move(bytes))});
+      index_.emplace(key, entries_.begin());
+
+      while (index_.size() > opts_.max_entries or bytes_ > opts_.max_bytes) {
+        bytes_ -= entries_.back().bytes->size();
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+        ++evictions_;
+      }
+    }
+
+    void clear() {
+      std::lock_guard lock{mutex_};
+      index_.clear();
+      entries_.clear();
+      bytes_ = 0;
+    }
+
+    std::size_t hits() const {
+      std::lock_guard lock{mutex_};
+      return hits_;
+    }
+
+    std::size_t misses() const {
+      std::lock_guard lock{mutex_};
+      return misses_;
+    }
+
+    std::size_t evictions() const {
+      std::lock_guard lock{mutex_};
+      return evictions_;
+    }
+
+    void reset_counters() {
+      std::lock_guard lock{mutex_};
+      hits_      = 0;
+      misses_    = 0;
+      evictions_ = 0;
+    }
+
+    /// Number of cached outputs
+    std::size_t size() const {
+      std::lock_guard lock{mutex_};
+      return index_.size();
+    }
+
+    /// Total size of the cached outputs
+    std::size_t bytes() const {
+      std::lock_guard lock{mutex_};
+      return bytes_;
+    }
+
+    const serialization_cache_options& options() const {
+      return opts_;
+    }
+
+  private:
+    struct entry {
+      key_type key;
+      value    bytes;
+    };
+
+    struct key_hash {
+      std::size_t operator()(const key_type& key) const {
+        std::uint64_t hash = key.content;
+        for (const std::uint64_t part: {key.zero_signs, key.type, key.format, key.args}) {
+          hash ^= part + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+      }
+    };
+
+    serialization_cache_options                                        opts_;
+    mutable std::mutex                                                 mutex_{};
+    std::list<entry>                                                   entries_{};
+    std::unordered_map<key_type, std::list<entry>::iterator, key_hash> index_{};
+    std::size_t                                                        bytes_     = 0;
+    std::size_t                                                        hits_      = 0;
+    std::size_t                                                        misses_    = 0;
+    std::size_t                                                        evictions_ = 0;
+  };
+} // namespace refl
@@ -0,0 +1,251 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  ndjson.cppm
+ *! \brief Parallel newline-delimited JSON batches of reflected records.
+ *!
+ */
+
+module;
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module reflect.marshal.ndjson;
+
+import std;
+
+import reflect;
+
+import reflect.marshal.sink;
+import reflect.marshal.formats.json;
+import reflect.marshal.projection;
+
+export namespace refl::ndjson {
+  struct options {
+    /// `0` uses every hardware thread
+    std::size_t threads = 0;
+    /// Smallest slice of input a reading thread is handed, cut at the next newline
+    std::size_t chunk_bytes = std::size_t{1} << 20;
+    /// Smallest number of records a writing thread is handed
+    std::size_t chunk_records = 4096;
+  };
+
+  /// Read-only mapping of a whole file, unmapped on destruction
+  class mapped_file {
+  public:
+    explicit mapped_file(const std::filesystem::path& path) {
+      const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), path.string());
+      }
+      struct stat info{};
+      if (::fstat(fd, &info) < 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), path.string());
+      }
+      size_ = static_cast<std::size_t>(info.st_size);
+      if (size_ > 0) {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+          const int error = errno;
+          ::close(fd);
+          throw std::system_error(error, std::generic_category(), path.string());
+        }
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+      }
+      ::close(fd);
+    }
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+      if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+      }
+    }
+
+    std::string_view view() const {
+      return {data_, size_};
+    }
+
+  private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+} // namespace refl::ndjson
+
+namespace refl::ndjson::detail {
+  inline std::size_t thread_count(const options& opts) {
+    const std::size_t threads =
+      opts.threads != 0 ? opts.threads : std::thread::hardware_concurrency();
+    return std::max<std::size_t>(threads, 1);
+  }
+
+  /// Cuts `input` into at most `count` slices, each ending right after a newline (or at the end)
+  inline std::vector<std::string_view> split_lines(std::string_view input, std::size_t count) {
+    std::vector<std::string_view> chunks{};
+    chunks.reserve(count);
+    std::size_t begin = 0;
+    for (std::size_t k = 1; k <= count and begin < input.size(); ++k) {
+      const std::size_t target = input.size() / count * k;
+      if (k < count and target <= begin) {
+        continue;
+      }
+      const std::size_t newline = k == count ? std::string_view::npos : input.find('\n', target);
+      const std::size_t end     = newline == std::string_view::npos ? input.size() : newline + 1;
+      chunks.push_back(input.substr(begin, end - begin));
+      begin = end;
+    }
+    return chunks;
+  }
+
+  template <Reflected T>
+  void decode_chunk(std::string_view chunk, std::size_t chunk_offset, std::vector<T>& shard) {
+    shard.reserve(static_cast<std::size_t>(std::ranges::count(chunk, '\n')) + 1);
+    std::size_t begin = 0;
+    while (begin < chunk.size()) {
+      std::size_t end = chunk.find('\n', begin);
+      if (end == std::string_view::npos) {
+        end = chunk.size();
+      }
+      const std::string_view line = chunk.substr(begin, end - begin);
+      if (line.find_first_not_of(" \t\r") != std::string_view::npos) {
+        try {
+          read_json(line, shard.emplace_back());
+        } catch (const std::invalid_argument& error) {
+          throw std::invalid_argument(
+            std::format("Record at byte {}: {}", chunk_offset + begin, error.what())
+          );
+        }
+      }
+      begin = end + 1;
+    }
+  }
+
+  /// Each chunk of `records` serialized into its own buffer, one record per line
+  template <typename R>
+  std::vector<string_sink> encode_chunks(const R& range, const options& opts) {
+    using T = std::ranges::range_value_t<R>;
+    const std::span<const T> records{range};
+
+    const std::size_t threads = thread_count(opts);
+    const std::size_t count   = std::clamp<std::size_t>(
+      records.size() / std::max<std::size_t>(opts.chunk_records, 1), 1, threads * 4
+    );
+    const std::size_t per_chunk = (records.size() + count - 1) / count;
+
+    std::vector<string_sink> chunks(count);
+    parallel_for(parallel_policy{.threads = threads}, count, [&](std::size_t i) {
+      const std::size_t begin = std::min(i * per_chunk, records.size());
+      const std::size_t end   = std::min(begin + per_chunk, records.size());
+
+      string_sink&                   sink = chunks[i];
+      formats::json_fmt<string_sink> format{sink, {}};
+      for (const T& record: records.subspan(begin, end - begin)) {
+        format.serialize(record);
+        sink.put('\n');
+      }
+    });
+    return chunks;
+  }
+} // namespace refl::ndjson::detail
+
+export namespace refl::ndjson {
+  /// Decodes one record per line of `input`, blank lines are ignored. The input is cut at newline
+  /// boundaries into chunks that threads decode into their own shards, which are then joined in
+  /// input order. Throws `std::invalid_argument` naming the byte offset of the first bad record.
+  template <Reflected T>
+    requires std::default_initializable<T>
+  std::vector<T> read(std::string_view input, const options& opts = {}) {
+    const std::size_t threads = detail::thread_count(opts);
+    const std::size_t count   = std::clamp<std::size_t>(
+      input.size() / std::max<std::size_t>(opts.chunk_bytes, 1), 1, threads * 4
+    );
+    const auto chunks = detail::split_lines(input, count);
+
+    std::vector<std::vector<T>> shards(chunks.size());
+    parallel_for(parallel_policy{.threads = threads}, chunks.size(), [&](std::size_t i) {
+      detail::decode_chunk(
+        chunks[i], static_cast<std::size_t>(chunks[i].data() - input.data()), shards[i]
+      );
+    });
+
+    if (shards.size() == 1) {
+      return std::move(shards.front());
+    }
+    std::size_t total = 0;
+    for (const auto& shard: shards) {
+      total += shard.size();
+    }
+    std::vector<T> records{};
+    records.reserve(total);
+    for (auto& shard: shards) {
+      std::ranges::move(shard, std::back_inserter(records));
+      shard = {};
+    }
+    return records;
+  }
+
+  /// `read` over a memory mapping of the file at `path`
+  template <Reflected T>
+    requires std::default_initializable<T>
+  std::vector<T> read_file(const std::filesystem::path& path, const options& opts = {}) {
+    const mapped_file file{path};
+    return read<T>(file.view(), opts);
+  }
+
+  template <typename R>
+  concept record_range =
+    std::ranges::contiguous_range<R> and Reflected<std::ranges::range_value_t<R>>;
+
+  /// Encodes `records` one per line, chunks of them in parallel, concatenated in order
+  template <record_range R>
+  std::string write(const R& records, const options& opts = {}) {
+    const auto  chunks = detail::encode_chunks(records, opts);
+    std::size_t total  = 0;
+    for (const auto& chunk: chunks) {
+      total += chunk.size();
+    }
+    std::string out{};
+    out.reserve(total);
+    for (const auto& chunk: chunks) {
+      out += chunk.view();
+    }
+    return out;
+  }
+
+  /// Like `write`, handing every chunk to the kernel in place with a single gathered write
+  template <record_range R>
+  void write(int fd, const R& records, const options& opts = {}) {
+    const auto chunks = detail::encode_chunks(records, opts);
+    fd_sink    sink{fd};
+    for (const auto& chunk: chunks) {
+      sink.write_static(chunk.view());
+    }
+    sink.flush();
+  }
+
+  /// Creates or truncates the file at `path` and writes `records` into it
+  template <record_range R>
+  void write_file(const std::filesystem::path& path, const R& records, const options& opts = {}) {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), path.string());
+    }
+    try {
+      write(fd, records, opts);
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    if (::close(fd) < 0) {
+      throw std::system_error(errno, std::generic_category(), path.string());
+    }
+  }
+} // namespace refl::ndjson
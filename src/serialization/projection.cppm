@@ -0,0 +1,831 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  projection.cppm
+ *! \brief Partial JSON decoding of selected member paths, skipping everything else.
+ *!
+ */
+
+export module reflect.marshal.projection;
+
+import std;
+
+import packtl;
+import reflect;
+
+import reflect.marshal.formats.base;
+import reflect.marshal.intern;
+
+export namespace refl {
+  /// One selected member. A node without children selects the whole value.
+  struct projection_node {
+    /// Key the member is written under by `formats::json_fmt`
+    std::string key{};
+    /// Index as in `refl::field<T, I>`
+    std::size_t                  index = 0;
+    std::vector<projection_node> children{};
+  };
+} // namespace refl
+
+namespace refl::projection_impl {
+  using selection = std::vector<projection_node>;
+
+  template <typename Field>
+  constexpr bool is_skipped = [] {
+    if constexpr (Field::template has_metadata<serialize::policy::policy_e>) {
+      return Field::template get_metadata<serialize::policy::policy_e> == serialize::policy::skip;
+    } else {
+      return false;
+    }
+  }();
+
+  template <typename Field>
+  std::string serialized_key() {
+    if constexpr (Field::template has_metadata<serialize::name>) {
+      return Field::template get_metadata<serialize::name>.value;
+    } else {
+      return Field::name;
+    }
+  }
+
+  /// Fields a member path can continue into, and write their value into
+  template <typename Field>
+  constexpr bool is_writable =
+    not Field::is_reference and not Field::is_pointer and
+    not std::is_const_v<std::remove_reference_t<typename Field::type>>;
+
+  /// Serialized keys of `R` and their field indices, sorted by key
+  template <Reflected R>
+  const std::vector<std::pair<std::string, std::size_t>>& sorted_keys() {
+    static const std::vector<std::pair<std::string, std::size_t>> keys = [] {
+      std::vector<std::pair<std::string, std::size_t>> result{};
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+          [&] {
+            if constexpr (not is_skipped<field<R, I>>) {
+              result.emplace_back(serialized_key<field<R, I>>(), I);
+            }
+          }(),
+          ...
+        );
+      }(std::make_index_sequence<field_count<R>>{});
+      std::ranges::sort(result);
+      return result;
+    }();
+    return keys;
+  }
+
+  template <Reflected R>
+  std::size_t index_of(std::string_view name) {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      std::size_t index = sizeof...(I);
+      (void)((std::string_view{field<R, I>::name} == name ? (index = I, true) : false) or ...);
+      return index;
+    }(std::make_index_sequence<field_count<R>>{});
+  }
+
+  template <Reflected R>
+  void insert(selection& nodes, std::span<const std::string_view> names);
+
+  /// Adds `names` below field `Field` of `R`, which must be a reflected value
+  template <Reflected R, typename Field>
+  void insert_below(selection& nodes, std::span<const std::string_view> names) {
+    using value_type = std::remove_cvref_t<typename Field::type>;
+    if constexpr (is_writable<Field> and Reflected<value_type>) {
+      insert<value_type>(nodes, names);
+    } else {
+      throw std::invalid_argument(
+        std::format("Cannot select '{}' inside '{}::{}'", names.front(), type_name<R>, Field::name)
+      );
+    }
+  }
+
+  template <Reflected R>
+  void insert(selection& nodes, std::span<const std::string_view> names) {
+    if (names.empty()) {
+      throw std::invalid_argument("Empty member path");
+    }
+
+    static constexpr auto inserters = []<std::size_t... I>(std::index_sequence<I...>) {
+      return std::array<void (*)(selection&, std::span<const std::string_view>), sizeof...(I)>{
+        &insert_below<R, field<R, I>>...
+      };
+    }(std::make_index_sequence<field_count<R>>{});
+    static constexpr auto writable = []<std::size_t... I>(std::index_sequence<I...>) {
+      return std::array<bool, sizeof...(I)>{is_writable<field<R, I>>...};
+    }(std::make_index_sequence<field_count<R>>{});
+    static const auto keys = []<std::size_t... I>(std::index_sequence<I...>) {
+      return std::array<std::string, sizeof...(I)>{serialized_key<field<R, I>>()...};
+    }(std::make_index_sequence<field_count<R>>{});
+
+    const std::size_t index = index_of<R>(names.front());
+    if (index == field_count<R>) {
+      throw std::invalid_argument(
+        std::format("'{}' has no member named '{}'", type_name<R>, names.front())
+      );
+    }
+    if (not writable[index]) {
+      throw std::invalid_argument(std::format(
+        "Cannot read into '{}::{}', references, pointers and const members are not supported",
+        type_name<R>,
+        names.front()
+      ));
+    }
+
+    auto it = std::ranges::find(nodes, index, &projection_node::index);
+    if (it == nodes.end()) {
+      nodes.push_back({.key = keys[index], .index = index});
+      it = std::prev(nodes.end());
+    } else if (it->children.empty()) {
+      // Already selected as a whole
+      return;
+    }
+    if (names.size() == 1) {
+      it->children.clear();
+    } else {
+      inserters[index](it->children, names.subspan(1));
+    }
+  }
+
+  /// Pull reader over a JSON document, decoding only what it is asked to. Keys without escapes
+  /// and skipped values are never copied.
+  ///
+  /// With a dictionary, the input is read as written by `formats::json_fmt` interning into a
+  /// dictionary with the same options: back-references are resolved, and every string has to go
+  /// through the dictionary in order, skipped ones included, to keep the ids in step.
+  class json_reader {
+  public:
+    explicit json_reader(std::string_view input, string_dictionary* dictionary = nullptr)
+        : input_(input),
+          dictionary_(dictionary) {}
+
+    /// Reads the members of `nodes` into `obj`, or every member if `nodes` is null. Returns as
+    /// soon as the last selected member was read, skipping the rest of the object unparsed.
+    template <Reflected R>
+    void read_object(R& obj, const selection* nodes) {
+      static constexpr auto readers = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<void (*)(json_reader&, R&, const selection*), sizeof...(I)>{
+          &read_field<R, field<R, I>>...
+        };
+      }(std::make_index_sequence<field_count<R>>{});
+
+      if (consume_null()) {
+        return;
+      }
+      if (nodes != nullptr and nodes->empty()) {
+        skip_value();
+        return;
+      }
+      expect('{');
+      if (consume('}')) {
+        return;
+      }
+
+      std::size_t pending = nodes == nullptr ? 0 : nodes->size();
+      while (true) {
+        const std::string_view key = read_key();
+        expect(':');
+        if (nodes == nullptr) {
+          const auto& keys = sorted_keys<R>();
+          const auto  it   = std::ranges::lower_bound(keys, key, std::less<>{}, [](const auto& k) {
+            return std::string_view{k.first};
+          });
+          if (it != keys.end() and it->first == key) {
+            readers[it->second](*this, obj, nullptr);
+          } else {
+            skip_value();
+          }
+        } else {
+          const auto it = std::ranges::find(*nodes, key, &projection_node::key);
+          if (it == nodes->end()) {
+            skip_value();
+          } else {
+            readers[it->index](*this, obj, it->children.empty() ? nullptr : &it->children);
+            if (--pending == 0) {
+              skip_remaining_members();
+              return;
+            }
+          }
+        }
+        if (consume(',')) {
+          continue;
+        }
+        expect('}');
+        return;
+      }
+    }
+
+    /// Decodes a value written by `formats::json_fmt`. `null` leaves `value` as it was, except
+    /// for smart pointers which are reset. A `std::string_view` is only read with a dictionary,
+    /// and then points into the dictionary's buffer.
+    template <typename V>
+    void read_value(V& value) {
+      if constexpr (packtl::is_type<std::unique_ptr, V>::value) {
+        if (consume_null()) {
+          value.reset();
+        } else {
+          auto pointee = std::make_unique<typename V::element_type>();
+          read_value(*pointee);
+          value = std::move(pointee);
+        }
+      } else if (consume_null()) {
+        return;
+      } else if constexpr (std::same_as<V, bool>) {
+        value = read_bool();
+      } else if constexpr (std::same_as<V, char>) {
+        const std::string_view text = read_text();
+        if (text.size() != 1) {
+          fail("expected a single character");
+        }
+        value = text.front();
+      } else if constexpr (std::is_arithmetic_v<V>) {
+        value = read_number<V>();
+      } else if constexpr (std::same_as<V, std::string>) {
+        value.assign(read_text());
+      } else if constexpr (std::same_as<V, std::string_view>) {
+        if (dictionary_ == nullptr) {
+          skip_value();
+        } else {
+          value = read_text(true);
+        }
+      } else if constexpr (packtl::is_type<std::vector, V>::value or
+                           packtl::is_type<std::list, V>::value or
+                           packtl::is_type<std::deque, V>::value or
+                           packtl::is_type<std::set, V>::value or
+                           packtl::is_type<std::unordered_set, V>::value) {
+        value.clear();
+        read_array([&] {
+          typename V::value_type item{};
+          read_value(item);
+          if constexpr (requires { value.push_back(std::move(item)); }) {
+            value.push_back(std::move(item));
+          } else {
+            value.insert(std::move(item));
+          }
+        });
+      } else if constexpr (is_std_array<V>::value) {
+        std::size_t index = 0;
+        read_array([&] {
+          if (index < value.size()) {
+            read_value(value[index++]);
+          } else {
+            skip_value();
+          }
+        });
+      } else if constexpr (packtl::is_type<std::map, V>::value or
+                           packtl::is_type<std::unordered_map, V>::value) {
+        value.clear();
+        read_map(value);
+      } else if constexpr (packtl::is_type<std::pair, V>::value) {
+        read_pair(value);
+      } else if constexpr (Reflected<V>) {
+        read_object(value, nullptr);
+      } else {
+        skip_value();
+      }
+    }
+
+    /// Skips one value of any kind. Only strings are scanned character by character, containers
+    /// are skipped by counting brackets, unless there is a dictionary to keep up to date.
+    void skip_value() {
+      skip_whitespace();
+      if (at_end()) {
+        fail("expected a value");
+      }
+      switch (input_[pos_]) {
+        case '"':
+          if (dictionary_ == nullptr) {
+            skip_string();
+          } else {
+            read_text();
+          }
+          break;
+        case '{':
+          ++pos_;
+          if (dictionary_ == nullptr) {
+            skip_to_close();
+          } else if (not consume('}')) {
+            skip_remaining_members(true);
+          }
+          break;
+        case '[':
+          ++pos_;
+          if (dictionary_ == nullptr) {
+            skip_to_close();
+          } else if (not consume(']')) {
+            do {
+              skip_value();
+            } while (consume(','));
+            expect(']');
+          }
+          break;
+        default: {
+          const std::size_t start = pos_;
+          while (not at_end() and not is_delimiter(input_[pos_])) {
+            ++pos_;
+          }
+          if (pos_ == start) {
+            fail("expected a value");
+          }
+          break;
+        }
+      }
+    }
+
+    /// Fails unless only whitespace is left
+    void finish() {
+      skip_whitespace();
+      if (not at_end()) {
+        fail("unexpected trailing characters");
+      }
+    }
+
+  private:
+    template <Reflected R, typename Field>
+    static void read_field(json_reader& reader, R& obj, const selection* nodes) {
+      using value_type = std::remove_cvref_t<typename Field::type>;
+      if constexpr (not is_writable<Field>) {
+        reader.skip_value();
+      } else if constexpr (Reflected<value_type>) {
+        reader.read_object(Field::from_instance(obj), nodes);
+      } else {
+        reader.read_value(Field::from_instance(obj));
+      }
+    }
+
+    [[noreturn]] void fail(std::string_view what) const {
+      throw std::invalid_argument(std::format("Malformed JSON at offset {}: {}", pos_, what));
+    }
+
+    bool at_end() const {
+      return pos_ >= input_.size();
+    }
+
+    static bool is_delimiter(char c) {
+      return c == ',' or c == '}' or c == ']' or c == ' ' or c == '\n' or c == '\r' or c == '\t';
+    }
+
+    void skip_whitespace() {
+      while (not at_end() and
+             (input_[pos_] == ' ' or input_[pos_] == '\n' or input_[pos_] == '\r' or
+              input_[pos_] == '\t')) {
+        ++pos_;
+      }
+    }
+
+    bool consume(char c) {
+      skip_whitespace();
+      if (not at_end() and input_[pos_] == c) {
+        ++pos_;
+        return true;
+      }
+      return false;
+    }
+
+    void expect(char c) {
+      if (not consume(c)) {
+        fail(std::format("expected '{}'", c));
+      }
+    }
+
+    bool consume_literal(std::string_view literal) {
+      skip_whitespace();
+      if (input_.substr(pos_, literal.size()) == literal) {
+        pos_ += literal.size();
+        return true;
+      }
+      return false;
+    }
+
+    bool consume_null() {
+      return consume_literal("null");
+    }
+
+    /// Past the bracket or brace closing the container the reader is in
+    void skip_to_close() {
+      std::size_t depth = 1;
+      while (depth > 0) {
+        const std::size_t next = input_.find_first_of("\"{}[]", pos_);
+        if (next == std::string_view::npos) {
+          pos_ = input_.size();
+          fail("unterminated object or array");
+        }
+        pos_ = next;
+        switch (input_[pos_]) {
+          case '"':
+            skip_string();
+            break;
+          case '{':
+          case '[':
+            ++depth;
+            ++pos_;
+            break;
+          default:
+            --depth;
+            ++pos_;
+            break;
+        }
+      }
+    }
+
+    /// Past the brace closing the object the reader is in, after one of its values. With `first`,
+    /// right after the opening brace of a non-empty object instead.
+    void skip_remaining_members(bool first = false) {
+      if (dictionary_ == nullptr) {
+        skip_to_close();
+        return;
+      }
+      if (first or consume(',')) {
+        do {
+          read_key();
+          expect(':');
+          skip_value();
+        } while (consume(','));
+      }
+      expect('}');
+    }
+
+    void skip_string() {
+      ++pos_;
+      while (true) {
+        const std::size_t next = input_.find_first_of("\"\\", pos_);
+        if (next == std::string_view::npos) {
+          pos_ = input_.size();
+          fail("unterminated string");
+        }
+        pos_ = next + 1;
+        if (input_[next] == '"') {
+          return;
+        }
+        ++pos_;
+      }
+    }
+
+    /// A view into the input, the scratch buffer or the dictionary, valid until the next read
+    std::string_view read_key() {
+      skip_whitespace();
+      if (at_end() or input_[pos_] != '"') {
+        fail("expected a key");
+      }
+      std::string_view key = read_string();
+      if (dictionary_ == nullptr) {
+        return key;
+      }
+      if (key.starts_with('^')) {
+        key.remove_prefix(1);
+        if (not key.starts_with('^')) {
+          return lookup(key);
+        }
+      }
+      return dictionary_->add(key);
+    }
+
+    /// A string value, resolving back-references and remembering first occurrences when there is
+    /// a dictionary. The view is only valid until the next read, unless `keep` is set, which
+    /// copies it into the dictionary's buffer if it is not already there.
+    std::string_view read_text(bool keep = false) {
+      if (dictionary_ == nullptr) {
+        return read_string();
+      }
+      skip_whitespace();
+      if (not at_end() and input_[pos_] == '[') {
+        const std::size_t close = input_.find(']', pos_);
+        if (close == std::string_view::npos) {
+          fail("unterminated string reference");
+        }
+        const std::string_view id   = input_.substr(pos_ + 1, close - pos_ - 1);
+        const std::string_view text = lookup(id);
+        pos_ = close + 1;
+        return text;
+      }
+      const std::string_view text   = read_string();
+      const std::string_view stored = dictionary_->add(text);
+      if (keep and stored.data() == text.data()) {
+        return dictionary_->store(text);
+      }
+      return stored;
+    }
+
+    std::string_view lookup(std::string_view id_text) {
+      std::uint32_t id = 0;
+      const auto [end, ec] = std::from_chars(id_text.data(), id_text.data() + id_text.size(), id);
+      if (ec != std::errc{} or end != id_text.data() + id_text.size() or
+          id >= dictionary_->size()) {
+        fail("invalid string reference");
+      }
+      return dictionary_->at(id);
+    }
+
+    /// A view into the input, or into the scratch buffer when the string has escapes
+    std::string_view read_string() {
+      expect('"');
+      const std::size_t start = pos_;
+      const std::size_t first = input_.find_first_of("\"\\", start);
+      if (first != std::string_view::npos and input_[first] == '"') {
+        pos_ = first + 1;
+        return input_.substr(start, first - start);
+      }
+      std::string& out = scratch_;
+      out.clear();
+      while (true) {
+        const std::size_t next = input_.find_first_of("\"\\", pos_);
+        if (next == std::string_view::npos) {
+          pos_ = input_.size();
+          fail("unterminated string");
+        }
+        out.append(input_.substr(pos_, next - pos_));
+        pos_ = next + 1;
+        if (input_[next] == '"') {
+          return out;
+        }
+        read_escape(out);
+      }
+    }
+
+    void read_escape(std::string& out) {
+      if (at_end()) {
+        fail("unterminated escape sequence");
+      }
+      const char c = input_[pos_++];
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          out += c;
+          break;
+        case 'b':
+          out += '\b';
+          break;
+        case 'f':
+          out += '\f';
+          break;
+        case 'n':
+          out += '\n';
+          break;
+        case 'r':
+          out += '\r';
+          break;
+        case 't':
+          out += '\t';
+          break;
+        case 'u': {
+          std::uint32_t code = read_hex4();
+          if (code >= 0xD800 and code < 0xDC00 and consume_literal("\\u")) {
+            const std::uint32_t low = read_hex4();
+            code                    = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          append_utf8(out, code);
+          break;
+        }
+        default:
+          fail("invalid escape sequence");
+      }
+    }
+
+    std::uint32_t read_hex4() {
+      std::uint32_t code = 0;
+      const auto    hex  = input_.substr(pos_, 4);
+      const auto [end, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), code, 16);
+      if (hex.size() != 4 or ec != std::errc{} or end != hex.data() + 4) {
+        fail("invalid unicode escape");
+      }
+      pos_ += 4;
+      return code;
+    }
+
+    static void append_utf8(std::string& out, std::uint32_t code) {
+      if (code < 0x80) {
+        out += static_cast<char>(code);
+      } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+      } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+      } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+      }
+    }
+
+    /// `json_fmt` writes booleans as the strings `"true"` and `"false"`, plain literals are
+    /// accepted too
+    bool read_bool() {
+      if (consume_literal("true")) {
+        return true;
+      }
+      if (consume_literal("false")) {
+        return false;
+      }
+      if (not at_end() and (input_[pos_] == '"' or input_[pos_] == '[')) {
+        const std::string_view text = read_text();
+        if (text == "true") {
+          return true;
+        }
+        if (text == "false") {
+          return false;
+        }
+      }
+      fail("expected a boolean");
+    }
+
+    /// Types `json_fmt` has no number form for, such as `long long`, are written as strings
+    template <typename N>
+    N read_number() {
+      skip_whitespace();
+      const std::size_t start = pos_;
+      std::string_view  text{};
+      if (not at_end() and
+          (input_[pos_] == '"' or (dictionary_ != nullptr and input_[pos_] == '['))) {
+        text = read_text();
+      } else {
+        while (not at_end() and not is_delimiter(input_[pos_])) {
+          ++pos_;
+        }
+        text = input_.substr(start, pos_ - start);
+      }
+      N value{};
+      const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (ec != std::errc{} or end != text.data() + text.size()) {
+        pos_ = start;
+        fail("expected a number");
+      }
+      return value;
+    }
+
+    /// Calls `element()` once per element of an array
+    template <typename F>
+    void read_array(F&& element) {
+      expect('[');
+      if (consume(']')) {
+        return;
+      }
+      do {
+        element();
+      } while (consume(','));
+      expect(']');
+    }
+
+    /// String keyed maps are objects, other maps arrays of `[key, value]` pairs
+    template <typename M>
+    void read_map(M& map) {
+      using key_type    = typename M::key_type;
+      using mapped_type = typename M::mapped_type;
+      if constexpr (std::same_as<key_type, std::string>) {
+        expect('{');
+        if (consume('}')) {
+          return;
+        }
+        do {
+          std::string key{read_key()};
+          expect(':');
+          mapped_type mapped{};
+          read_value(mapped);
+          map.insert_or_assign(std::move(key), std::move(mapped));
+        } while (consume(','));
+        expect('}');
+      } else {
+        read_array([&] {
+          std::pair<key_type, mapped_type> entry{};
+          read_pair(entry);
+          map.insert_or_assign(std::move(entry.first), std::move(entry.second));
+        });
+      }
+    }
+
+    /// Pairs with a string first are single member objects, other pairs two element arrays
+    template <typename P>
+    void read_pair(P& pair) {
+      if constexpr (std::same_as<typename P::first_type, std::string>) {
+        expect('{');
+        pair.first = std::string{read_key()};
+        expect(':');
+        read_value(pair.second);
+        expect('}');
+      } else {
+        expect('[');
+        read_value(pair.first);
+        expect(',');
+        read_value(pair.second);
+        expect(']');
+      }
+    }
+
+  private:
+    std::string_view   input_;
+    std::size_t        pos_        = 0;
+    std::string        scratch_{};
+    string_dictionary* dictionary_ = nullptr;
+  };
+} // namespace refl::projection_impl
+
+export namespace refl {
+  /// A set of member paths to read out of serialized `T`s. Only the selected members are
+  /// decoded, every other subtree of the input is skipped without being parsed or copied, and
+  /// reading stops as soon as the last selected member was found.
+  ///
+  ///   static const refl::projection<order> ids{"id", "customer.id"};
+  ///   order partial{};
+  ///   ids.read_json(json, partial);
+  ///
+  /// Paths name members as in C++, like `compile_path`, and the input keys are matched the way
+  /// `formats::json_fmt` writes them.
+  template <Reflected T>
+  class projection {
+  public:
+    projection() = default;
+
+    projection(std::initializer_list<std::string_view> paths)
+        : projection(std::span{paths.begin(), paths.size()}) {}
+
+    /// Throws `std::invalid_argument` for unknown members and for paths through members that are
+    /// not reflected values, such as references, pointers and containers
+    explicit projection(std::span<const std::string_view> paths) {
+      std::vector<std::string_view> names{};
+      for (std::string_view path: paths) {
+        names.clear();
+        for (const auto name: std::views::split(path, '.')) {
+          names.emplace_back(name.begin(), name.end());
+        }
+        projection_impl::insert<T>(nodes_, names);
+      }
+    }
+
+    explicit projection(std::span<const field_path> paths) {
+      std::vector<std::string_view> names{};
+      for (const auto& path: paths) {
+        names.clear();
+        for (const field_info* field: path.fields()) {
+          names.emplace_back(field->name);
+        }
+        projection_impl::insert<T>(nodes_, names);
+      }
+    }
+
+    /// Reads the selected members of the JSON object `json` into `out`, leaving the rest of `out`
+    /// untouched. Throws `std::invalid_argument` if the parts that are read are malformed.
+    void read_json(std::string_view json, T& out) const {
+      projection_impl::json_reader reader{json};
+      reader.read_object(out, &nodes_);
+      reader.finish();
+    }
+
+    /// Reads from a stream written with `json_fmt_args::dictionary`. Skipped subtrees still have
+    /// their strings scanned into `dictionary`, so it stays in step for the next record.
+    void read_json(std::string_view json, T& out, string_dictionary& dictionary) const {
+      projection_impl::json_reader reader{json, &dictionary};
+      reader.read_object(out, &nodes_);
+      reader.finish();
+    }
+
+    const std::vector<projection_node>& nodes() const {
+      return nodes_;
+    }
+
+  private:
+    std::vector<projection_node> nodes_{};
+  };
+
+  /// Decodes every member of the JSON object `json` into `out`, the full counterpart of
+  /// `projection<T>::read_json`
+  template <Reflected T>
+  void read_json(std::string_view json, T& out) {
+    projection_impl::json_reader reader{json};
+    reader.read_object(out, nullptr);
+    reader.finish();
+  }
+
+  /// Decodes a record of a stream written with `json_fmt_args::dictionary`, `dictionary` having
+  /// the same options and having read the stream's previous records. `std::string_view` members
+  /// point into the dictionary's buffer.
+  template <Reflected T>
+  void read_json(std::string_view json, T& out, string_dictionary& dictionary) {
+    projection_impl::json_reader reader{json, &dictionary};
+    reader.read_object(out, nullptr);
+    reader.finish();
+  }
+
+  /// The projection of `Paths`, built once
+  template <Reflected T, field_name... Paths>
+  const projection<T>& projection_of() {
+    static const projection<T> instance{Paths.view()...};
+    return instance;
+  }
+
+  template <Reflected T, field_name... Paths>
+  void project_json(std::string_view json, T& out) {
+    projection_of<T, Paths...>().read_json(json, out);
+  }
+
+  /// The selected members only, e.g. `auto [id, name] = project_json<user, "id", "name">(json)`
+  template <Reflected T, field_name... Paths>
+    requires(sizeof...(Paths) > 0 and std::default_initializable<T>)
+  std::tuple<path_type<T, Paths>...> project_json(std::string_view json) {
+    T obj{};
+    projection_of<T, Paths...>().read_json(json, obj);
+    return {std::move(compile_path<T, Paths>().template get_ref<path_type<T, Paths>>(&obj))...};
+  }
+} // namespace refl
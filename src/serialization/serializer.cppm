@@ -13,32 +13,237 @@ import std;
 import packtl;
 
 export import reflect;
+export import reflect.marshal.sink;
 export import reflect.marshal.formats.base;
+export import reflect.marshal.intern;
+export import reflect.marshal.memo;
 export import reflect.marshal.formats.default_fmt;
 export import reflect.marshal.formats.json;
+export import reflect.marshal.formats.binary;
+export import reflect.marshal.formats.msgpack;
+export import reflect.marshal.formats.cbor;
+export import reflect.marshal.chunked;
+export import reflect.marshal.projection;
+export import reflect.marshal.ndjson;
 
 export namespace refl {
+  /// Keeps an output buffer alive between serializations so steady-state calls don't allocate.
+  /// Views returned by `serialize` stay valid until the next call on the same context. A call
+  /// made while another one is still writing, e.g. from a `std::formatter` that serializes,
+  /// writes into a buffer of its own and leaves the outer output alone.
+  class serialization_context {
+  public:
+    serialization_context() = default;
+
+    explicit serialization_context(std::size_t capacity)
+        : sink_(capacity) {}
+
+    static serialization_context& local() {
+      thread_local serialization_context context{};
+      return context;
+    }
+
+    template <template <typename> typename Format, typename T>
+    std::string_view
+    serialize(const T& obj, const typename Format<string_sink>::args_t& args = {}) {
+      string_sink& sink = depth_ == 0 ? sink_ : nested_sink();
+      ++depth_;
+      struct guard {
+        std::size_t& depth;
+
+        ~guard() {
+          --depth;
+        }
+      } leave{depth_};
+
+      sink.clear();
+      auto format = Format<string_sink>{sink, args};
+      format.serialize(obj);
+      return sink.view();
+    }
+
+    string_sink& sink() {
+      return sink_;
+    }
+
+  private:
+    /// Buffer of the call nested `depth_` deep, kept for the next call as deep
+    string_sink& nested_sink() {
+      while (nested_.size() < depth_) {
+        nested_.emplace_back();
+      }
+      return nested_[depth_ - 1];
+    }
+
+    string_sink sink_{};
+    // A deque so outer buffers stay in place while nested ones are added
+    std::deque<string_sink> nested_{};
+    std::size_t             depth_ = 0;
+  };
+
+  /// Upper bound of the size of any `T` serialized by `Format`, known at compile time. Empty
+  /// unless the format can bound every value in `T`, and only valid for arguments for which
+  /// `Format::is_bounded(args)` holds.
+  template <template <typename> typename Format, typename T>
+  inline constexpr std::optional<std::size_t> serialized_size_bound = [] {
+    if constexpr (requires { Format<counting_sink>::template max_size<T>(); }) {
+      return Format<counting_sink>::template max_size<T>();
+    } else {
+      return std::optional<std::size_t>{};
+    }
+  }();
+
+  namespace detail {
+    template <const auto& Obj, formats::json_fmt_args Args>
+    inline constexpr auto static_json_bytes =
+      formats::json_fmt<counting_sink>::template constant_output<Obj, Args>();
+  } // namespace detail
+
+  /// JSON of the constant `Obj`, written while compiling: the same bytes
+  /// `to_string<formats::json_fmt>(Obj, Args)` returns, kept in a static array, e.g.
+  ///
+  ///   static constexpr config defaults{...};
+  ///   constexpr std::string_view defaults_json = refl::static_json<defaults>;
+  ///
+  /// See `json_fmt::constant_output` for the types it supports.
+  template <const auto& Obj, formats::json_fmt_args Args = {}>
+  inline constexpr std::string_view static_json{
+    detail::static_json_bytes<Obj, Args>.data(),
+    detail::static_json_bytes<Obj, Args>.size(),
+  };
+
+  /// Exact size of `obj` serialized by `Format`, measured by a pass that only counts the output
+  template <template <typename> typename Format = formats::default_fmt, typename T>
+  std::size_t
+  serialized_size(const T& obj, const typename Format<counting_sink>::args_t& args = {}) {
+    counting_sink sink{};
+    auto          format = Format<counting_sink>{sink, args};
+    format.serialize(obj);
+    return sink.size();
+  }
+
   template <template <typename> typename Format = formats::default_fmt>
   struct serializer {
-    template <typename O>
+    template <typename O = string_sink>
     using args_t = typename Format<O>::args_t;
 
-    static std::string to_string(const auto& obj, const args_t<std::stringstream>& args = {}) {
-      std::stringstream str{};
-      auto              format = Format<std::stringstream>{str, args};
-      format.serialize(obj);
-      return str.str();
+    static std::string to_string(const auto& obj, const args_t<>& args = {}) {
+      return std::string{to_string_view(obj, args)};
+    }
+
+    /// Serializes into the calling thread's reusable buffer, the view is only valid until the
+    /// next serialization on this thread.
+    static std::string_view to_string_view(const auto& obj, const args_t<>& args = {}) {
+      return serialization_context::local().serialize<Format>(obj, args);
+    }
+
+    /// Like `to_string`, allocating the result once and at its final size: `serialized_size_bound`
+    /// when there is one, the size `serialized_size` measures otherwise. The format then writes
+    /// into it without any bounds checks.
+    template <typename T>
+    static std::string to_string_exact(const T& obj, const args_t<>& args = {}) {
+      const std::size_t capacity = [&] {
+        if constexpr (serialized_size_bound<Format, T>.has_value()) {
+          if (Format<buffer_sink>::is_bounded(args)) {
+            return *serialized_size_bound<Format, T>;
+          }
+        }
+        return serialized_size<Format>(obj, args);
+      }();
+
+      std::string out{};
+      out.resize_and_overwrite(capacity, [&](char* data, std::size_t) {
+        buffer_sink sink{data};
+        auto        format = Format<buffer_sink>{sink, args};
+        format.serialize(obj);
+        return sink.size();
+      });
+      return out;
     }
 
     template <typename O>
-    static void to_stream(O& out, const auto& obj, const args_t<O>& args = {}) {
-      auto format = Format<O>{out, args};
-      format.serialize(obj);
+    static void to_stream(O& out, const auto& obj, const args_t<>& args = {}) {
+      if constexpr (output_sink<O>) {
+        auto format = Format<O>{out, args};
+        format.serialize(obj);
+      } else {
+        refl::write(out, to_string_view(obj, args));
+      }
+    }
+
+    static void to_fd(int fd, const auto& obj, const args_t<>& args = {}) {
+      fd_sink sink{fd};
+      to_stream(sink, obj, args);
+      sink.flush();
     }
   };
 
   template <template <typename> typename Format = formats::default_fmt>
-  std::string to_string(const auto& obj, const typename Format<std::stringstream>::args_t& args = {}) {
+  std::string to_string(
+    const auto& obj, const typename serializer<Format>::template args_t<>& args = {}
+  ) {
     return serializer<Format>::to_string(obj, args);
   }
+
+  template <template <typename> typename Format = formats::default_fmt>
+  std::string to_string_exact(
+    const auto& obj, const typename serializer<Format>::template args_t<>& args = {}
+  ) {
+    return serializer<Format>::to_string_exact(obj, args);
+  }
+
+  /// Re-serializes a `tracked<T>` every tick while only paying for the fields that changed. Each
+  /// field's output is cached and clean fields are copied from the cache. Views stay valid until
+  /// the next call on the same serializer.
+  template <template <typename> typename Format, Reflected T>
+  class incremental_serializer {
+  public:
+    using args_t = typename Format<string_sink>::args_t;
+
+    explicit incremental_serializer(const args_t& args = {})
+        : args_(args) {}
+
+    /// Whole document, refreshing dirty fields. Clears `state`'s dirty set. The cache belongs to
+    /// one `tracked<T>` at a time, passing another one writes every field again.
+    std::string_view serialize(tracked<T>& state) {
+      auto refresh = state.dirty();
+      if (bound_ != &state) {
+        refresh.set();
+        bound_ = &state;
+      }
+      write(state, refresh, false);
+      state.clear_dirty();
+      return output_.view();
+    }
+
+    /// Only the fields that changed since the last call, as a partial object. Clears `state`'s
+    /// dirty set.
+    std::string_view serialize_dirty(tracked<T>& state) {
+      write(state, state.dirty(), true);
+      if (bound_ != &state) {
+        // Only some fields were refreshed from `state`, the rest are not its own
+        bound_ = nullptr;
+      }
+      state.clear_dirty();
+      return output_.view();
+    }
+
+    /// Forgets every cached field, the next `serialize` starts from scratch
+    void invalidate() {
+      bound_ = nullptr;
+    }
+
+  private:
+    void write(const tracked<T>& state, const typename tracked<T>::dirty_set& refresh, bool only) {
+      output_.clear();
+      auto format = Format<string_sink>{output_, args_};
+      format.serialize_fields(state.value(), std::span{fragments_}, refresh, only);
+    }
+
+  private:
+    args_t                                  args_;
+    std::array<string_sink, field_count<T>> fragments_{};
+    string_sink                             output_{};
+    const tracked<T>*                       bound_ = nullptr;
+  };
 } // namespace refl
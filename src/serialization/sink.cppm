@@ -0,0 +1,387 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  sink.cppm
+ *! \brief Output sinks the formats write into.
+ *!
+ */
+
+module;
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+export module reflect.marshal.sink;
+
+import std;
+
+export namespace refl {
+  template <typename S>
+  concept output_sink = requires(S& sink, std::string_view str, char c) {
+    sink.write(str);
+    sink.put(c);
+  };
+
+  namespace detail {
+    inline constexpr std::size_t indent_block_size = 128;
+
+    inline constexpr std::array<char, indent_block_size> indent_block = [] {
+      std::array<char, indent_block_size> block{};
+      block.fill(' ');
+      return block;
+    }();
+  } // namespace detail
+
+  /// Output iterator adaptor so `std::format_to` can write straight into a sink.
+  template <typename S>
+  struct sink_iterator {
+    using iterator_category = std::output_iterator_tag;
+    using value_type        = void;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = void;
+
+    S* sink;
+
+    sink_iterator& operator=(char c) {
+      sink->put(c);
+      return *this;
+    }
+    sink_iterator& operator*() {
+      return *this;
+    }
+    sink_iterator& operator++() {
+      return *this;
+    }
+    sink_iterator operator++(int) {
+      return *this;
+    }
+  };
+
+  /// Contiguous, growable output buffer. `clear()` keeps the allocation around so the same sink
+  /// can be reused across serializations without reallocating.
+  class string_sink {
+  public:
+    string_sink() = default;
+
+    explicit string_sink(std::size_t capacity) {
+      buffer_.reserve(capacity);
+    }
+
+    void write(std::string_view str) {
+      buffer_.append(str);
+    }
+
+    void put(char c) {
+      buffer_.push_back(c);
+    }
+
+    auto inserter() {
+      return std::back_inserter(buffer_);
+    }
+
+    void clear() {
+      buffer_.clear();
+    }
+
+    void reserve(std::size_t capacity) {
+      buffer_.reserve(capacity);
+    }
+
+    std::string_view view() const {
+      return buffer_;
+    }
+
+    std::string str() const {
+      return buffer_;
+    }
+
+    std::size_t size() const {
+      return buffer_.size();
+    }
+
+    std::size_t capacity() const {
+      return buffer_.capacity();
+    }
+
+    string_sink& operator<<(std::string_view str) {
+      write(str);
+      return *this;
+    }
+
+    string_sink& operator<<(char c) {
+      put(c);
+      return *this;
+    }
+
+  private:
+    std::string buffer_{};
+  };
+
+  /// Discards the output and only counts it, for measuring passes
+  class counting_sink {
+  public:
+    void write(std::string_view str) {
+      size_ += str.size();
+    }
+
+    void put(char) {
+      ++size_;
+    }
+
+    auto inserter() {
+      return sink_iterator<counting_sink>{this};
+    }
+
+    std::size_t size() const {
+      return size_;
+    }
+
+    counting_sink& operator<<(std::string_view str) {
+      write(str);
+      return *this;
+    }
+
+    counting_sink& operator<<(char c) {
+      put(c);
+      return *this;
+    }
+
+  private:
+    std::size_t size_ = 0;
+  };
+
+  /// Writes into storage the caller sized in advance, e.g. with `serialized_size`. There are no
+  /// bounds checks, writing past the end of the storage is undefined behavior.
+  class buffer_sink {
+  public:
+    explicit buffer_sink(char* data)
+        : begin_(data),
+          pos_(data) {}
+
+    void write(std::string_view str) {
+      pos_ = std::ranges::copy(str, pos_).out;
+    }
+
+    void put(char c) {
+      *pos_++ = c;
+    }
+
+    auto inserter() {
+      return sink_iterator<buffer_sink>{this};
+    }
+
+    std::size_t size() const {
+      return static_cast<std::size_t>(pos_ - begin_);
+    }
+
+    buffer_sink& operator<<(std::string_view str) {
+      write(str);
+      return *this;
+    }
+
+    buffer_sink& operator<<(char c) {
+      put(c);
+      return *this;
+    }
+
+  private:
+    char* begin_;
+    char* pos_;
+  };
+
+  /// Scatter sink for file descriptors. Copied output is packed into retained fixed-size blocks,
+  /// data passed to `write_static` is referenced in place, and everything is handed to the kernel
+  /// with a single `writev` per flush.
+  class fd_sink {
+  public:
+    explicit fd_sink(int fd, std::size_t block_size = 4096, std::size_t max_blocks = 16)
+        : fd_(fd),
+          block_size_(block_size),
+          max_blocks_(max_blocks) {}
+
+    fd_sink(const fd_sink&)            = delete;
+    fd_sink& operator=(const fd_sink&) = delete;
+
+    ~fd_sink() {
+      try {
+        flush();
+      } catch (...) {
+      }
+    }
+
+    void write(std::string_view str) {
+      while (not str.empty()) {
+        // Flush before copying so the pending iovecs never alias the blocks being refilled
+        if (iov_.size() == iov_max) {
+          flush();
+        }
+        if (block_used_ == block_size_ or blocks_.empty()) {
+          next_block();
+        }
+        char*       block = blocks_[block_index_].get();
+        std::size_t count = std::min(block_size_ - block_used_, str.size());
+        std::memcpy(block + block_used_, str.data(), count);
+        push_iov(block + block_used_, count);
+        block_used_ += count;
+        str.remove_prefix(count);
+      }
+    }
+
+    /// Writes `str` without copying it, so it must stay alive until the next `flush()`.
+    void write_static(std::string_view str) {
+      if (not str.empty()) {
+        push_iov(const_cast<char*>(str.data()), str.size());
+      }
+    }
+
+    void put(char c) {
+      write(std::string_view{&c, 1});
+    }
+
+    auto inserter() {
+      return sink_iterator<fd_sink>{this};
+    }
+
+    void flush() {
+      std::size_t first = 0;
+      while (first < iov_.size()) {
+        const int count = static_cast<int>(std::min<std::size_t>(iov_.size() - first, iov_max));
+        ssize_t   written = ::writev(fd_, iov_.data() + first, count);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw std::system_error(errno, std::generic_category(), "writev");
+        }
+
+        auto remaining = static_cast<std::size_t>(written);
+        while (first < iov_.size() and remaining >= iov_[first].iov_len) {
+          remaining -= iov_[first].iov_len;
+          ++first;
+        }
+        if (remaining > 0) {
+          iov_[first].iov_base = static_cast<char*>(iov_[first].iov_base) + remaining;
+          iov_[first].iov_len -= remaining;
+        }
+      }
+
+      iov_.clear();
+      block_index_ = 0;
+      block_used_  = blocks_.empty() ? block_size_ : 0;
+    }
+
+    std::size_t pending() const {
+      std::size_t total = 0;
+      for (const auto& iov: iov_) {
+        total += iov.iov_len;
+      }
+      return total;
+    }
+
+    fd_sink& operator<<(std::string_view str) {
+      write(str);
+      return *this;
+    }
+
+    fd_sink& operator<<(char c) {
+      put(c);
+      return *this;
+    }
+
+  private:
+    static constexpr std::size_t iov_max = IOV_MAX < 1024 ? IOV_MAX : 1024;
+
+    void next_block() {
+      if (not blocks_.empty()) {
+        ++block_index_;
+      }
+      if (block_index_ == max_blocks_) {
+        flush();
+        return;
+      }
+      if (block_index_ == blocks_.size()) {
+        blocks_.push_back(std::make_unique_for_overwrite<char[]>(block_size_));
+      }
+      block_used_ = 0;
+    }
+
+    void push_iov(char* data, std::size_t size) {
+      if (not iov_.empty()) {
+        auto& last = iov_.back();
+        if (static_cast<char*>(last.iov_base) + last.iov_len == data) {
+          last.iov_len += size;
+          return;
+        }
+      }
+      if (iov_.size() == iov_max) {
+        flush();
+      }
+      iov_.push_back({.iov_base = data, .iov_len = size});
+    }
+
+  private:
+    int                                  fd_;
+    std::size_t                          block_size_;
+    std::size_t                          max_blocks_;
+    std::vector<std::unique_ptr<char[]>> blocks_{};
+    std::size_t                          block_index_ = 0;
+    std::size_t                          block_used_  = 0;
+    std::vector<iovec>                   iov_{};
+  };
+
+  //! Helpers formats use to write to either a sink or a `std::ostream`
+
+  template <typename O>
+  void write(O& out, std::string_view str) {
+    if constexpr (output_sink<O>) {
+      out.write(str);
+    } else {
+      out.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+  }
+
+  /// Like `write`, for data with static storage duration (names, literals, indentation) that a
+  /// sink may reference instead of copying.
+  template <typename O>
+  void write_static(O& out, std::string_view str) {
+    if constexpr (requires { out.write_static(str); }) {
+      out.write_static(str);
+    } else {
+      write(out, str);
+    }
+  }
+
+  /// Bytes written to `out` so far, for sinks that keep count, `0` for the others
+  template <typename O>
+  std::size_t bytes_written(const O& out) {
+    if constexpr (requires { { out.size() } -> std::convertible_to<std::size_t>; }) {
+      return out.size();
+    } else {
+      return 0;
+    }
+  }
+
+  template <typename O>
+  void write_indent(O& out, std::size_t count) {
+    while (count > 0) {
+      const std::size_t chunk = std::min(count, detail::indent_block_size);
+      write_static(out, std::string_view{detail::indent_block.data(), chunk});
+      count -= chunk;
+    }
+  }
+
+  template <typename O, typename... Args>
+  void write_format(O& out, std::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (requires { out.inserter(); }) {
+      std::format_to(out.inserter(), fmt, std::forward<Args>(args)...);
+    } else {
+      std::format_to(std::ostreambuf_iterator<char>(out), fmt, std::forward<Args>(args)...);
+    }
+  }
+} // namespace refl
@@ -0,0 +1,636 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  soa_vector.cppm
+ *! \brief Struct-of-arrays container generated from a reflected type's fields.
+ *!
+ */
+
+export module reflect:soa_vector;
+
+import std;
+
+import :types;
+import :accessors;
+import :equality;
+
+namespace refl::detail {
+  /// Contiguous growable storage for a single column. Unlike `std::vector` it stays contiguous
+  /// for `bool` too, so every column can be handed out as a `std::span`.
+  template <typename F>
+  class column_buffer {
+  public:
+    column_buffer() = default;
+
+    // Delegates so the destructor releases the storage if copying an element throws
+    column_buffer(const column_buffer& rhs)
+        : column_buffer() {
+      reserve(rhs.size_);
+      std::uninitialized_copy_n(rhs.data_, rhs.size_, data_);
+      size_ = rhs.size_;
+    }
+
+    column_buffer(column_buffer&& rhs) noexcept
+        : data_(std::exchange(rhs.data_, nullptr)),
+          size_(std::exchange(rhs.size_, 0)),
+          capacity_(std::exchange(rhs.capacity_, 0)) {}
+
+    column_buffer& operator=(column_buffer rhs) noexcept {
+      std::swap(data_, rhs.data_);
+      std::swap(size_, rhs.size_);
+      std::swap(capacity_, rhs.capacity_);
+      return *this;
+    }
+
+    ~column_buffer() {
+      clear();
+      if (data_ != nullptr) {
+        std::allocator<F>{}.deallocate(data_, capacity_);
+      }
+    }
+
+    F* data() {
+      return data_;
+    }
+    const F* data() const {
+      return data_;
+    }
+    std::size_t size() const {
+      return size_;
+    }
+    std::size_t capacity() const {
+      return capacity_;
+    }
+
+    F& operator[](std::size_t index) {
+      return data_[index];
+    }
+    const F& operator[](std::size_t index) const {
+      return data_[index];
+    }
+
+    void reserve(std::size_t capacity) {
+      if (capacity > capacity_) {
+        relocate(capacity, [](F*) {}, false);
+      }
+    }
+
+    template <typename... Args>
+    F& emplace_back(Args&&... args) {
+      if (size_ == capacity_) {
+        // Build the new element before moving the old ones, `args` may refer into this column
+        relocate(
+          capacity_ == 0 ? 8 : capacity_ * 2,
+          [&](F* fresh) { std::construct_at(fresh + size_, std::forward<Args>(args)...); },
+          true
+        );
+      } else {
+        std::construct_at(data_ + size_, std::forward<Args>(args)...);
+      }
+      return data_[size_++];
+    }
+
+    void pop_back() {
+      std::destroy_at(data_ + --size_);
+    }
+
+    void clear() {
+      std::destroy_n(data_, size_);
+      size_ = 0;
+    }
+
+  private:
+    template <typename Construct>
+    void relocate(std::size_t capacity, Construct&& construct, bool constructs_back) {
+      F* fresh = std::allocator<F>{}.allocate(capacity);
+      try {
+        construct(fresh);
+      } catch (...) {
+        std::allocator<F>{}.deallocate(fresh, capacity);
+        throw;
+      }
+      if constexpr (std::is_nothrow_move_constructible_v<F> or
+                    not std::is_copy_constructible_v<F>) {
+        std::uninitialized_move_n(data_, size_, fresh);
+      } else {
+        try {
+          std::uninitialized_copy_n(data_, size_, fresh);
+        } catch (...) {
+          if (constructs_back) {
+            std::destroy_at(fresh + size_);
+          }
+          std::allocator<F>{}.deallocate(fresh, capacity);
+          throw;
+        }
+      }
+      std::destroy_n(data_, size_);
+      if (data_ != nullptr) {
+        std::allocator<F>{}.deallocate(data_, capacity_);
+      }
+      data_     = fresh;
+      capacity_ = capacity;
+    }
+
+  private:
+    F*          data_     = nullptr;
+    std::size_t size_     = 0;
+    std::size_t capacity_ = 0;
+  };
+
+  template <typename T, typename Indices>
+  struct soa_columns;
+
+  template <typename T, std::size_t... I>
+  struct soa_columns<T, std::index_sequence<I...>> {
+    using type = std::tuple<column_buffer<std::remove_cv_t<typename field<T, I>::type>>...>;
+  };
+} // namespace refl::detail
+
+export namespace refl {
+  template <Reflected T>
+  class soa_vector;
+
+  /// Behaves like a `T&` to one row of a `soa_vector<T>`: `get<I>()` reaches the field, assigning
+  /// a `T` stores it and converting to `T` loads a copy. Its common reference with `T` is `T`, so
+  /// the iterators are random access iterators for the `std::ranges` algorithms too.
+  template <typename T, bool Const>
+  class soa_reference {
+    using owner_type = std::conditional_t<Const, const soa_vector<T>, soa_vector<T>>;
+
+  public:
+    soa_reference(owner_type& owner, std::size_t index)
+        : owner_(&owner),
+          index_(index) {}
+
+    soa_reference(const soa_reference&) = default;
+
+    operator soa_reference<T, true>() const
+      requires(not Const)
+    {
+      return {*owner_, index_};
+    }
+
+    template <std::size_t I>
+    decltype(auto) get() const {
+      return owner_->template column<I>()[index_];
+    }
+
+    T load() const {
+      return owner_->load(index_);
+    }
+
+    operator T() const {
+      return load();
+    }
+
+    const soa_reference& operator=(const T& value) const
+      requires(not Const)
+    {
+      owner_->store(index_, value);
+      return *this;
+    }
+
+    const soa_reference& operator=(const soa_reference& rhs) const
+      requires(not Const)
+    {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((get<I>() = rhs.template get<I>()), ...);
+      }(std::make_index_sequence<field_count<T>>{});
+      return *this;
+    }
+
+    friend void swap(const soa_reference& lhs, const soa_reference& rhs)
+      requires(not Const)
+    {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        using std::swap;
+        (swap(lhs.template get<I>(), rhs.template get<I>()), ...);
+      }(std::make_index_sequence<field_count<T>>{});
+    }
+
+    std::size_t index() const {
+      return index_;
+    }
+
+  private:
+    owner_type* owner_;
+    std::size_t index_;
+  };
+
+  /// Stores a sequence of `T` as one contiguous column per field (see `refl::field<T, I>`).
+  /// Elements are accessed through proxies that read and write straight into the columns, and
+  /// whole columns can be scanned as spans.
+  template <Reflected T>
+  class soa_vector {
+  public:
+    static constexpr std::size_t field_count = refl::field_count<T>;
+
+    template <std::size_t I>
+    using field_type = std::remove_cv_t<typename field<T, I>::type>;
+
+    static_assert(
+      []<std::size_t... I>(std::index_sequence<I...>) {
+        return (not std::is_reference_v<typename field<T, I>::type> and ...);
+      }(std::make_index_sequence<field_count>{}),
+      "soa_vector does not support reference fields"
+    );
+
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    template <bool Const>
+    using basic_reference = soa_reference<T, Const>;
+
+    using reference       = basic_reference<false>;
+    using const_reference = basic_reference<true>;
+
+    template <bool Const>
+    class basic_iterator {
+      using owner_type = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+    public:
+      using iterator_concept  = std::random_access_iterator_tag;
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using reference         = basic_reference<Const>;
+
+      basic_iterator() = default;
+
+      basic_iterator(owner_type& owner, std::size_t index)
+          : owner_(&owner),
+            index_(index) {}
+
+      operator basic_iterator<true>() const
+        requires(not Const)
+      {
+        return {*owner_, index_};
+      }
+
+      reference operator*() const {
+        return {*owner_, index_};
+      }
+      reference operator[](difference_type offset) const {
+        return {*owner_, index_ + offset};
+      }
+
+      basic_iterator& operator++() {
+        ++index_;
+        return *this;
+      }
+      basic_iterator operator++(int) {
+        auto it = *this;
+        ++index_;
+        return it;
+      }
+      basic_iterator& operator--() {
+        --index_;
+        return *this;
+      }
+      basic_iterator operator--(int) {
+        auto it = *this;
+        --index_;
+        return it;
+      }
+      basic_iterator& operator+=(difference_type offset) {
+        index_ += offset;
+        return *this;
+      }
+      basic_iterator& operator-=(difference_type offset) {
+        index_ -= offset;
+        return *this;
+      }
+
+      friend basic_iterator operator+(basic_iterator it, difference_type offset) {
+        return it += offset;
+      }
+      friend basic_iterator operator+(difference_type offset, basic_iterator it) {
+        return it += offset;
+      }
+      friend basic_iterator operator-(basic_iterator it, difference_type offset) {
+        return it -= offset;
+      }
+      friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+      }
+
+      friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) {
+        return lhs.index_ == rhs.index_;
+      }
+      friend auto operator<=>(const basic_iterator& lhs, const basic_iterator& rhs) {
+        return lhs.index_ <=> rhs.index_;
+      }
+
+    private:
+      owner_type* owner_ = nullptr;
+      std::size_t index_ = 0;
+    };
+
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    soa_vector() = default;
+
+    explicit soa_vector(const std::vector<T>& rows) {
+      assign(rows);
+    }
+
+    soa_vector(std::initializer_list<T> rows) {
+      assign(std::span{rows.begin(), rows.size()});
+    }
+
+    static soa_vector from_vector(const std::vector<T>& rows) {
+      return soa_vector{rows};
+    }
+
+    /// Replaces the contents with `rows`, filling one column at a time
+    void assign(std::span<const T> rows) {
+      clear();
+      reserve(rows.size());
+      try {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (fill_column<I>(rows), ...);
+        }(std::make_index_sequence<field_count>{});
+      } catch (...) {
+        clear_columns();
+        throw;
+      }
+      size_ = rows.size();
+    }
+
+    /// Copies every row out, one column at a time
+    std::vector<T> to_vector() const {
+      static_assert(std::default_initializable<T>, "to_vector needs a default constructible T");
+      std::vector<T> rows(size_);
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (drain_column<I>(rows), ...);
+      }(std::make_index_sequence<field_count>{});
+      return rows;
+    }
+
+    std::size_t size() const {
+      return size_;
+    }
+
+    bool empty() const {
+      return size_ == 0;
+    }
+
+    void reserve(std::size_t capacity) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (std::get<I>(columns_).reserve(capacity), ...);
+      }(std::make_index_sequence<field_count>{});
+    }
+
+    void clear() {
+      clear_columns();
+    }
+
+    void push_back(const T& value) {
+      push_row(value);
+    }
+
+    void push_back(T&& value) {
+      push_row(std::move(value));
+    }
+
+    void pop_back() {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (std::get<I>(columns_).pop_back(), ...);
+      }(std::make_index_sequence<field_count>{});
+      --size_;
+    }
+
+    /// Grows with default constructed `T`s, so default member initializers apply
+    void resize(std::size_t count)
+      requires std::default_initializable<T>
+    {
+      while (size_ > count) {
+        pop_back();
+      }
+      reserve(count);
+      while (size_ < count) {
+        push_back(T{});
+      }
+    }
+
+    reference operator[](std::size_t index) {
+      return {*this, index};
+    }
+
+    const_reference operator[](std::size_t index) const {
+      return {*this, index};
+    }
+
+    reference at(std::size_t index) {
+      check_index(index);
+      return {*this, index};
+    }
+
+    const_reference at(std::size_t index) const {
+      check_index(index);
+      return {*this, index};
+    }
+
+    reference front() {
+      return {*this, 0};
+    }
+    const_reference front() const {
+      return {*this, 0};
+    }
+    reference back() {
+      return {*this, size_ - 1};
+    }
+    const_reference back() const {
+      return {*this, size_ - 1};
+    }
+
+    iterator begin() {
+      return {*this, 0};
+    }
+    iterator end() {
+      return {*this, size_};
+    }
+    const_iterator begin() const {
+      return {*this, 0};
+    }
+    const_iterator end() const {
+      return {*this, size_};
+    }
+    const_iterator cbegin() const {
+      return begin();
+    }
+    const_iterator cend() const {
+      return end();
+    }
+
+    /// The contiguous storage of field `I`, one element per row
+    template <std::size_t I>
+    std::span<field_type<I>> column() {
+      auto& buffer = std::get<I>(columns_);
+      return {buffer.data(), size_};
+    }
+
+    template <std::size_t I>
+    std::span<const field_type<I>> column() const {
+      const auto& buffer = std::get<I>(columns_);
+      return {buffer.data(), size_};
+    }
+
+    template <std::size_t I>
+    field_type<I>& get(std::size_t index) {
+      return std::get<I>(columns_)[index];
+    }
+
+    template <std::size_t I>
+    const field_type<I>& get(std::size_t index) const {
+      return std::get<I>(columns_)[index];
+    }
+
+    T load(std::size_t index) const {
+      static_assert(std::default_initializable<T>, "load needs a default constructible T");
+      T row{};
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((field<T, I>::from_instance(row) = std::get<I>(columns_)[index]), ...);
+      }(std::make_index_sequence<field_count>{});
+      return row;
+    }
+
+    void store(std::size_t index, const T& row) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((std::get<I>(columns_)[index] = field<T, I>::from_instance(row)), ...);
+      }(std::make_index_sequence<field_count>{});
+    }
+
+  private:
+    template <typename Row>
+    void push_row(Row&& row) {
+      std::size_t pushed = 0;
+      try {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          ((static_cast<void>(std::get<I>(columns_).emplace_back(forward_field<I, Row>(row))),
+            ++pushed),
+           ...);
+        }(std::make_index_sequence<field_count>{});
+      } catch (...) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          ((I < pushed ? std::get<I>(columns_).pop_back() : void()), ...);
+        }(std::make_index_sequence<field_count>{});
+        throw;
+      }
+      ++size_;
+    }
+
+    template <std::size_t I, typename Row>
+    static decltype(auto) forward_field(Row& row) {
+      if constexpr (std::is_rvalue_reference_v<Row&&> and not std::is_const_v<Row>) {
+        return std::move(field<T, I>::from_instance(row));
+      } else {
+        return field<T, I>::from_instance(std::as_const(row));
+      }
+    }
+
+    template <std::size_t I>
+    void fill_column(std::span<const T> rows) {
+      auto& buffer = std::get<I>(columns_);
+      for (const T& row: rows) {
+        buffer.emplace_back(field<T, I>::from_instance(row));
+      }
+    }
+
+    template <std::size_t I>
+    void drain_column(std::vector<T>& rows) const {
+      const auto& buffer = std::get<I>(columns_);
+      for (std::size_t i = 0; i < size_; ++i) {
+        field<T, I>::from_instance(rows[i]) = buffer[i];
+      }
+    }
+
+    void clear_columns() {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (std::get<I>(columns_).clear(), ...);
+      }(std::make_index_sequence<field_count>{});
+      size_ = 0;
+    }
+
+    void check_index(std::size_t index) const {
+      if (index >= size_) {
+        throw std::out_of_range("soa_vector index out of range");
+      }
+    }
+
+  private:
+    typename detail::soa_columns<T, std::make_index_sequence<field_count>>::type columns_{};
+    std::size_t                                                                 size_ = 0;
+  };
+
+  template <typename T>
+  struct is_soa_vector<soa_vector<T>>: std::true_type {};
+
+  /// Column by column comparison, honoring each field's `eq_policy` like `deep_eq` on `T` does
+  template <typename T>
+  bool deep_eq(const soa_vector<T>& lhs, const soa_vector<T>& rhs) {
+    if (lhs.size() != rhs.size()) {
+      return false;
+    }
+
+    auto column_eq = [&]<std::size_t I>() {
+      using field_data = field<T, I>;
+      using field_type = typename soa_vector<T>::template field_type<I>;
+
+      eq_policy::policy_e policy{eq_policy::deep};
+      if constexpr (field_data::template has_metadata<eq_policy::policy_e>) {
+        policy = field_data::template get_metadata<eq_policy::policy_e>;
+      }
+      if (policy == eq_policy::skip) {
+        return true;
+      }
+
+      const auto l = lhs.template column<I>();
+      const auto r = rhs.template column<I>();
+      for (std::size_t i = 0; i < l.size(); ++i) {
+        if constexpr (std::is_pointer_v<field_type>) {
+          if (l[i] == r[i]) {
+            continue;
+          }
+          using pointee = std::remove_pointer_t<field_type>;
+          if constexpr (std::is_void_v<pointee>) {
+            return false;
+          } else {
+            if (policy == eq_policy::shallow or l[i] == nullptr or r[i] == nullptr or
+                not deep_eq_impl::ref_eq<std::remove_cv_t<pointee>>(*l[i], *r[i])) {
+              return false;
+            }
+          }
+        } else if (not deep_eq_impl::ref_eq<field_type>(l[i], r[i])) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      return (column_eq.template operator()<I>() and ...);
+    }(std::make_index_sequence<soa_vector<T>::field_count>{});
+  }
+} // namespace refl
+
+/// A row proxy and the row type meet at a copy of the row, which makes the proxy a valid
+/// reference type for `std::indirectly_readable`
+template <
+  typename T,
+  bool Const,
+  template <typename> typename TQual,
+  template <typename> typename UQual>
+struct std::basic_common_reference<refl::soa_reference<T, Const>, T, TQual, UQual> {
+  using type = T;
+};
+
+template <
+  typename T,
+  bool Const,
+  template <typename> typename TQual,
+  template <typename> typename UQual>
+struct std::basic_common_reference<T, refl::soa_reference<T, Const>, TQual, UQual> {
+  using type = T;
+};
@@ -0,0 +1,328 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  sort.cppm
+ *! \brief Radix sorting of reflected types by normalized, byte comparable field keys.
+ *!
+ */
+
+export module reflect:sort;
+
+import std;
+
+import :types;
+import :accessors;
+import :parallel;
+
+namespace refl::detail {
+  /// How a field type is written into a normalized key. Keys compare as unsigned bytes in the
+  /// same order as the values compare with `operator<`. `exact` is false when different values
+  /// may share a key, and ties then have to be settled by comparing the values themselves.
+  template <typename F>
+  struct sort_key {
+    static constexpr bool        supported = false;
+    static constexpr std::size_t width     = 0;
+    static constexpr bool        exact     = true;
+  };
+
+  template <std::unsigned_integral U>
+  void write_big_endian(U value, std::uint8_t* out) {
+    for (std::size_t i = 0; i < sizeof(U); ++i) {
+      out[i] = static_cast<std::uint8_t>(value >> ((sizeof(U) - 1 - i) * 8));
+    }
+  }
+
+  template <typename F>
+    requires std::integral<F>
+  struct sort_key<F> {
+    static constexpr bool        supported = true;
+    static constexpr std::size_t width     = sizeof(F);
+    static constexpr bool        exact     = true;
+
+    static void encode(const F& value, std::uint8_t* out) {
+      using U = std::make_unsigned_t<std::conditional_t<std::same_as<F, bool>, unsigned char, F>>;
+      auto bits = static_cast<U>(value);
+      if constexpr (std::is_signed_v<F>) {
+        // Flip the sign bit so negative values sort below positive ones
+        bits ^= U{1} << (sizeof(U) * 8 - 1);
+      }
+      write_big_endian(bits, out);
+    }
+  };
+
+  template <typename F>
+    requires std::is_enum_v<F>
+  struct sort_key<F>: sort_key<std::underlying_type_t<F>> {
+    static void encode(const F& value, std::uint8_t* out) {
+      sort_key<std::underlying_type_t<F>>::encode(std::to_underlying(value), out);
+    }
+  };
+
+  template <typename F>
+    requires(std::same_as<F, float> or std::same_as<F, double>)
+  struct sort_key<F> {
+    using bits_t = std::conditional_t<std::same_as<F, float>, std::uint32_t, std::uint64_t>;
+
+    static constexpr bool        supported = true;
+    static constexpr std::size_t width     = sizeof(F);
+    static constexpr bool        exact     = true;
+
+    static void encode(const F& value, std::uint8_t* out) {
+      // Every NaN shares the largest key, above +infinity
+      if (std::isnan(value)) {
+        write_big_endian(~bits_t{0}, out);
+        return;
+      }
+      constexpr bits_t sign = bits_t{1} << (sizeof(bits_t) * 8 - 1);
+      // -0.0 and 0.0 compare equal, give them the same key
+      auto bits = value == F{0} ? bits_t{0} : std::bit_cast<bits_t>(value);
+      // Negative values: reverse their order by flipping every bit. Positive: move above them.
+      bits = (bits & sign) != 0 ? ~bits : bits | sign;
+      write_big_endian(bits, out);
+    }
+  };
+
+  /// Strings only contribute a fixed length prefix
+  template <typename F>
+    requires(std::is_convertible_v<const F&, std::string_view> and not std::is_pointer_v<F>)
+  struct sort_key<F> {
+    static constexpr bool        supported = true;
+    static constexpr std::size_t width     = 8;
+    static constexpr bool        exact     = false;
+
+    static void encode(const F& value, std::uint8_t* out) {
+      const std::string_view str{value};
+      const std::size_t      count = std::min(width, str.size());
+      std::memcpy(out, str.data(), count);
+      std::memset(out + count, 0, width - count);
+    }
+  };
+
+  /// `operator<`, except that NaN compares above every other value and equal to any other NaN,
+  /// the same order the keys have
+  template <typename F>
+  bool key_less(const F& lhs, const F& rhs) {
+    if constexpr (std::floating_point<F>) {
+      if (std::isnan(lhs) or std::isnan(rhs)) {
+        return not std::isnan(lhs);
+      }
+    }
+    return lhs < rhs;
+  }
+
+  template <typename T, std::size_t... I>
+  struct sort_fields {
+    template <std::size_t J>
+    using field_type = std::remove_cvref_t<typename field<T, J>::type>;
+
+    static constexpr bool supported = (sort_key<field_type<I>>::supported and ...);
+    static constexpr bool exact     = (sort_key<field_type<I>>::exact and ...);
+
+    /// Fields after an inexact one can not be part of the key, rows sharing its prefix would be
+    /// ordered by them first. They are left to the tie break.
+    static constexpr std::size_t key_fields = [] {
+      constexpr bool field_exact[] = {sort_key<field_type<I>>::exact...};
+      std::size_t    count         = 0;
+      while (count < sizeof...(I) and field_exact[count++]) {}
+      return count;
+    }();
+
+    static constexpr std::size_t width = [] {
+      constexpr std::size_t field_width[] = {sort_key<field_type<I>>::width...};
+      return std::accumulate(field_width, field_width + key_fields, std::size_t{0});
+    }();
+
+    static void encode(const T& value, std::uint8_t* out) {
+      std::size_t position = 0;
+      auto        write    = [&]<std::size_t J>(std::integral_constant<std::size_t, J>) {
+        if (position++ < key_fields) {
+          sort_key<field_type<J>>::encode(field<T, J>::from_instance(value), out);
+          out += sort_key<field_type<J>>::width;
+        }
+      };
+      (write(std::integral_constant<std::size_t, I>{}), ...);
+    }
+
+    static bool less(const T& lhs, const T& rhs) {
+      bool result  = false;
+      auto compare = [&]<std::size_t J>(std::integral_constant<std::size_t, J>) {
+        const auto& a = field<T, J>::from_instance(lhs);
+        const auto& b = field<T, J>::from_instance(rhs);
+        if (key_less(a, b)) {
+          result = true;
+          return true;
+        }
+        return key_less(b, a);
+      };
+      (void)(compare(std::integral_constant<std::size_t, I>{}) or ...);
+      return result;
+    }
+  };
+
+  /// Runs `body(worker, first, last)` over `[0, size)` split into `threads` contiguous chunks
+  template <typename F>
+  void parallel_chunks(std::size_t threads, std::size_t size, F&& body) {
+    const std::size_t per_worker = (size + threads - 1) / threads;
+    parallel_for(parallel_policy{.threads = threads}, threads, [&](std::size_t worker) {
+      const std::size_t first = std::min(size, worker * per_worker);
+      body(worker, first, std::min(size, first + per_worker));
+    });
+  }
+
+  template <std::size_t Width, typename Index>
+  struct sort_entry {
+    std::array<std::uint8_t, Width> key;
+    Index                           index;
+  };
+
+  /// Below this many rows building keys costs more than it saves
+  inline constexpr std::size_t radix_sort_threshold = 256;
+
+  template <typename Fields, typename Index, typename T>
+  void radix_sort_entries(std::vector<T>& rows, std::size_t threads) {
+    constexpr std::size_t width = Fields::width;
+    using entry_t               = sort_entry<width, Index>;
+    using histogram_t           = std::array<std::array<std::size_t, 256>, width>;
+
+    const std::size_t    size = rows.size();
+    std::vector<entry_t> entries(size);
+    std::vector<entry_t> scratch(size);
+
+    // Build the keys and the histograms of every byte in a single read of the rows
+    std::vector<histogram_t> counts(threads);
+    parallel_chunks(threads, size, [&](std::size_t worker, std::size_t first, std::size_t last) {
+      auto& histogram = counts[worker];
+      for (auto& count: histogram) {
+        count.fill(0);
+      }
+      for (std::size_t i = first; i < last; ++i) {
+        Fields::encode(rows[i], entries[i].key.data());
+        entries[i].index = static_cast<Index>(i);
+        for (std::size_t byte = 0; byte < width; ++byte) {
+          ++histogram[byte][entries[i].key[byte]];
+        }
+      }
+    });
+
+    // LSD: one stable counting sort per key byte, least significant first. Histograms describe
+    // the multiset of bytes, so they stay valid while the entries move around.
+    for (std::size_t byte = width; byte-- > 0;) {
+      // Every row has the same byte here, the pass would not move anything
+      bool skip = false;
+      for (std::size_t bucket = 0; bucket < 256 and not skip; ++bucket) {
+        std::size_t total = 0;
+        for (const auto& histogram: counts) {
+          total += histogram[byte][bucket];
+        }
+        skip = total == size;
+      }
+      if (skip) {
+        continue;
+      }
+
+      // Exclusive prefix sums, bucket major then worker, keeps the pass stable
+      std::vector<std::array<std::size_t, 256>> next(threads);
+      std::size_t                               offset = 0;
+      for (std::size_t bucket = 0; bucket < 256; ++bucket) {
+        for (std::size_t worker = 0; worker < threads; ++worker) {
+          next[worker][bucket] = offset;
+          offset += counts[worker][byte][bucket];
+        }
+      }
+
+      parallel_chunks(threads, size, [&](std::size_t worker, std::size_t first, std::size_t last) {
+        auto& position = next[worker];
+        for (std::size_t i = first; i < last; ++i) {
+          scratch[position[entries[i].key[byte]]++] = entries[i];
+        }
+      });
+      entries.swap(scratch);
+
+      // Workers now own different entries, their histograms have to follow
+      if (threads > 1) {
+        auto recount = [&](std::size_t worker, std::size_t first, std::size_t last) {
+          auto& histogram = counts[worker];
+          for (auto& count: histogram) {
+            count.fill(0);
+          }
+          for (std::size_t i = first; i < last; ++i) {
+            for (std::size_t b = 0; b < byte; ++b) {
+              ++histogram[b][entries[i].key[b]];
+            }
+          }
+        };
+        parallel_chunks(threads, size, recount);
+      }
+    }
+
+    std::vector<T> sorted{};
+    sorted.reserve(size);
+    for (const auto& entry: entries) {
+      sorted.push_back(std::move(rows[entry.index]));
+    }
+
+    if constexpr (not Fields::exact) {
+      // Equal keys only mean equal prefixes, settle those runs on the full values
+      for (std::size_t first = 0; first < size;) {
+        std::size_t last = first + 1;
+        while (last < size and entries[last].key == entries[first].key) {
+          ++last;
+        }
+        if (last - first > 1) {
+          std::stable_sort(
+            sorted.begin() + static_cast<std::ptrdiff_t>(first),
+            sorted.begin() + static_cast<std::ptrdiff_t>(last),
+            &Fields::less
+          );
+        }
+        first = last;
+      }
+    }
+
+    rows.swap(sorted);
+  }
+
+  template <typename Fields, typename T>
+  void radix_sort_by(std::vector<T>& rows, std::size_t threads) {
+    static_assert(
+      Fields::supported, "sort_by only supports integral, enum, floating point and string fields"
+    );
+
+    const std::size_t size = rows.size();
+    if (size < radix_sort_threshold) {
+      std::ranges::stable_sort(rows, &Fields::less);
+      return;
+    }
+    // Workers each need a reasonable share of the rows
+    threads = std::clamp<std::size_t>(threads, 1, size / (64 * 1024) + 1);
+
+    // Narrow row indexes keep the entries, and so every pass, smaller
+    if (size <= std::numeric_limits<std::uint32_t>::max()) {
+      radix_sort_entries<Fields, std::uint32_t>(rows, threads);
+    } else {
+      radix_sort_entries<Fields, std::size_t>(rows, threads);
+    }
+  }
+} // namespace refl::detail
+
+export namespace refl {
+  /// Stable sort of `rows` by the fields `Names...`, in order, each ascending by `operator<`.
+  /// Integral, enum, floating point and string fields are written into one byte comparable key
+  /// per row, sorted with an LSD radix sort. Strings only contribute an 8 byte prefix and end the
+  /// key, rows whose keys tie are compared field by field afterwards. NaN sorts after every other
+  /// value of its field, and all NaNs tie whatever their sign or payload.
+  template <Reflected T, field_name... Names>
+  void sort_by(std::vector<T>& rows) {
+    static_assert(((field_index<T, Names> < field_count<T>) and ...), "no field with that name");
+    detail::radix_sort_by<detail::sort_fields<T, field_index<T, Names>...>>(rows, 1);
+  }
+
+  /// Same as `sort_by`, building keys and running the radix passes on `threads` workers
+  template <Reflected T, field_name... Names>
+  void parallel_sort_by(
+    std::vector<T>& rows, std::size_t threads = std::thread::hardware_concurrency()
+  ) {
+    static_assert(((field_index<T, Names> < field_count<T>) and ...), "no field with that name");
+    detail::radix_sort_by<detail::sort_fields<T, field_index<T, Names>...>>(rows, threads);
+  }
+} // namespace refl
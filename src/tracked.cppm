@@ -0,0 +1,162 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  tracked.cppm
+ *! \brief Field level dirty tracking for reflected types.
+ *!
+ */
+
+export module reflect:tracked;
+
+import std;
+
+import :types;
+import :accessors;
+
+export namespace refl {
+  /// Owns a `T` and remembers which of its fields changed since the last `clear_dirty()`. Bits are
+  /// indexed by `refl::field<T, I>::index`. Mutation goes through the accessors below, direct
+  /// access is read-only.
+  template <Reflected T>
+  class tracked {
+  public:
+    static constexpr std::size_t field_count = refl::field_count<T>;
+    using value_type                         = T;
+    using dirty_set                          = std::bitset<field_count>;
+
+    template <std::size_t I>
+    using field_type = std::remove_reference_t<typename field<T, I>::type>;
+
+    /// Proxy for a single field, every write through it marks the field dirty
+    template <std::size_t I>
+    class field_proxy {
+    public:
+      explicit field_proxy(tracked& owner)
+          : owner_(owner) {}
+
+      const field_type<I>& get() const {
+        return owner_.template get<I>();
+      }
+
+      operator const field_type<I>&() const {
+        return get();
+      }
+
+      template <typename V>
+      field_proxy& operator=(V&& value) {
+        owner_.template set<I>(std::forward<V>(value));
+        return *this;
+      }
+
+      template <typename F>
+      decltype(auto) modify(F&& func) {
+        return std::forward<F>(func)(owner_.template edit<I>());
+      }
+
+    private:
+      tracked& owner_;
+    };
+
+    /// Everything starts dirty, nothing has been observed yet
+    tracked() {
+      dirty_.set();
+    }
+
+    explicit tracked(T value)
+        : value_(std::move(value)) {
+      dirty_.set();
+    }
+
+    const T& value() const {
+      return value_;
+    }
+
+    const T& operator*() const {
+      return value_;
+    }
+
+    const T* operator->() const {
+      return &value_;
+    }
+
+    template <std::size_t I>
+    const field_type<I>& get() const {
+      return field<T, I>::from_instance(value_);
+    }
+
+    template <std::size_t I>
+    field_proxy<I> at() {
+      return field_proxy<I>{*this};
+    }
+
+    /// Assigns field `I`, it is only marked dirty if the value actually changes
+    template <std::size_t I, typename V>
+    void set(V&& value) {
+      auto& current = field<T, I>::from_instance(value_);
+      if constexpr (std::equality_comparable_with<const field_type<I>&, const V&>) {
+        if (current == value) {
+          return;
+        }
+      }
+      current = std::forward<V>(value);
+      dirty_.set(I);
+    }
+
+    /// Marks field `I` dirty and hands out a mutable reference to it
+    template <std::size_t I>
+    field_type<I>& edit() {
+      dirty_.set(I);
+      return field<T, I>::from_instance(value_);
+    }
+
+    /// Arbitrary mutation of the whole value, every field is marked dirty
+    template <typename F>
+    decltype(auto) modify(F&& func) {
+      dirty_.set();
+      return std::forward<F>(func)(value_);
+    }
+
+    void mark_dirty(std::size_t index) {
+      dirty_.set(index);
+    }
+
+    void mark_all_dirty() {
+      dirty_.set();
+    }
+
+    void clear_dirty() {
+      dirty_.reset();
+    }
+
+    template <std::size_t I>
+    bool is_dirty() const {
+      return dirty_.test(I);
+    }
+
+    bool is_dirty(std::size_t index) const {
+      return dirty_.test(index);
+    }
+
+    bool any_dirty() const {
+      return dirty_.any();
+    }
+
+    std::size_t dirty_count() const {
+      return dirty_.count();
+    }
+
+    const dirty_set& dirty() const {
+      return dirty_;
+    }
+
+  private:
+    T         value_{};
+    dirty_set dirty_{};
+  };
+
+  template <typename T>
+  struct is_tracked: std::false_type {};
+
+  template <typename T>
+  struct is_tracked<tracked<T>>: std::true_type {};
+} // namespace refl
@@ -10,23 +10,42 @@ export module reflect:type_info;
 
 export import std;
 
+import packtl;
+
 export import :types;
 export import :type_name;
 export import :accessors;
 export import :equality;
+export import :value_visitor;
 
 namespace refl {
   export class type_info;
+  export class any;
+  export class any_ref;
   std::map<type_id_t, type_info> type_registry {};
 
   type_id_t get_id_from_info_getter(const type_info& (*tif)());
 
+  /// Whether `T` is complete here, e.g. not the implementation of a pimpl outside its own source
+  template <typename T>
+  concept is_complete = requires { sizeof(T); };
+
+  /// Whether deleting a `T` compiles here. A `std::unique_ptr` with the default deleter can only
+  /// be destroyed where its pointee is complete.
+  template <typename T>
+  constexpr bool is_destroyable = std::is_destructible_v<T> and not std::is_function_v<T>;
+
+  template <typename U>
+  constexpr bool is_destroyable<std::unique_ptr<U>> = is_complete<std::remove_extent_t<U>>;
+
   export struct field_info {
     std::size_t index;
     std::string name;
     std::size_t size;
     std::size_t offset;
     access_spec access_type;
+    bool is_reference;
+    bool is_pointer;
     type_id_t type_id;
     [[refl::ignore]]
     const type_info& (*type)();
@@ -75,6 +94,10 @@ namespace refl {
       return fields_.back()->type();
     }
 
+    const std::vector<const field_info*>& fields() const {
+      return fields_;
+    }
+
     void* get_ptr(void* obj) const {
       void* ptr = obj;
 
@@ -98,9 +121,36 @@ namespace refl {
   };
 
   export struct method_info {
+    /// Type-erased call thunk: `self` is ignored for static methods, `args` holds one pointer per
+    /// parameter (to an object of the parameter's decayed type). The return value is constructed
+    /// in `result`, uninitialized storage of `result_size` bytes aligned to `result_alignment`
+    /// provided by the caller, which `void` methods ignore.
+    using invoker_t = void (*)(void* self, void* const* args, void* result);
+
     std::size_t index;
     std::string name;
+    std::uint64_t name_hash;
     access_spec access_type;
+    bool is_static;
+    std::vector<type_id_t> param_type_ids;
+    [[refl::ignore]]
+    const type_info& (*return_type)();
+    std::size_t result_size;
+    std::size_t result_alignment;
+    [[refl::ignore]]
+    invoker_t invoker;
+
+    bool is_invocable() const {
+      return invoker != nullptr;
+    }
+
+    std::size_t arity() const {
+      return param_type_ids.size();
+    }
+
+    // Checked invocation, defined in the `any` partition
+    any invoke(any_ref self, const any_ref* args, std::size_t count) const;
+    any invoke(any_ref self, std::initializer_list<any_ref> args) const;
   };
 
   export template <typename T>
@@ -133,6 +183,8 @@ namespace refl {
         .size = Field::size,
         .offset = Field::offset,
         .access_type = Field::access,
+        .is_reference = Field::is_reference,
+        .is_pointer = Field::is_pointer,
         .type_id = Field::type_id,
         .type = &type_getter<typename Field::type>,
       };
@@ -156,17 +208,220 @@ namespace refl {
       fields_by_offset_[field.offset] = &field;
     }
 
+    template <typename Arg>
+    static decltype(auto) unpack_arg(void* ptr) {
+      using value_type = std::remove_cvref_t<Arg>;
+      auto& value = *static_cast<value_type*>(ptr);
+      if constexpr (std::is_lvalue_reference_v<Arg>) {
+        return static_cast<Arg>(value);
+      } else if constexpr (std::is_rvalue_reference_v<Arg>) {
+        return std::move(value);
+      } else if constexpr (std::is_copy_constructible_v<value_type>) {
+        return static_cast<const value_type&>(value);
+      } else {
+        return std::move(value);
+      }
+    }
+
+    template <typename Method>
+    static constexpr bool is_invocable_method = [] {
+      if constexpr (not Method::is_addressable) {
+        return false;
+      } else {
+        using R = typename Method::signature::return_type;
+        return std::is_void_v<R> or
+               (not std::is_abstract_v<std::remove_cvref_t<R>> and
+                std::is_constructible_v<std::remove_cvref_t<R>, R>);
+      }
+    }();
+
+    template <typename Method>
+    static void invoke_method(void* self, void* const* args, void* result) {
+      using signature = typename Method::signature;
+      using args_t    = typename signature::arg_types;
+      using R         = typename signature::return_type;
+
+      auto call = [&]<std::size_t... I>(std::index_sequence<I...>) -> R {
+        if constexpr (Method::is_static) {
+          return Method::pointer(unpack_arg<std::tuple_element_t<I, args_t>>(args[I])...);
+        } else {
+          using object_ref = typename signature::object_ref;
+          using object_type = std::remove_cvref_t<object_ref>;
+          return (static_cast<object_ref>(*static_cast<object_type*>(self)).*Method::pointer)(
+            unpack_arg<std::tuple_element_t<I, args_t>>(args[I])...
+          );
+        }
+      };
+
+      if constexpr (std::is_void_v<R>) {
+        call(std::make_index_sequence<signature::arity>{});
+      } else {
+        ::new (result) std::remove_cvref_t<R>(call(std::make_index_sequence<signature::arity>{}));
+      }
+    }
+
+    template <typename T>
+    static void visit_elements(const T& range, value_visitor& visitor) {
+      using element_type = std::remove_cvref_t<typename T::value_type>;
+      static const type_info& element = from<element_type>();
+
+      visitor.begin_sequence(std::ranges::size(range));
+      for (const auto& item: range) {
+        if constexpr (std::same_as<std::remove_cvref_t<decltype(item)>, element_type>) {
+          visitor.on_element(element, &item);
+        } else {
+          // Proxy references (`std::vector<bool>`) don't point at an element_type object
+          const element_type copy = item;
+          visitor.on_element(element, &copy);
+        }
+      }
+      visitor.end_sequence();
+    }
+
+    template <typename Pointee>
+    static const type_info* pointee_type() {
+      if constexpr (std::is_object_v<Pointee> and is_complete<Pointee>) {
+        return &from<std::remove_cv_t<Pointee>>();
+      } else {
+        return nullptr;
+      }
+    }
+
+    /// Classifies `T` the same way the formats' static dispatch does and reports the value to a
+    /// runtime visitor
+    template <typename T>
+    static void visit_value_thunk(const void* ptr, value_visitor& visitor) {
+      const T& value = *static_cast<const T*>(ptr);
+
+      if constexpr (std::same_as<T, std::atomic_flag>) {
+        visitor.on_formatted(value.test() ? "SET" : "CLEAR");
+      } else if constexpr (packtl::is_type<std::unique_ptr, T>::value) {
+        visitor.on_pointer(
+          pointee_type<typename T::element_type>(), value.get(), pointer_kind::unique
+        );
+      } else if constexpr (packtl::is_type<std::shared_ptr, T>::value) {
+        visitor.on_pointer(
+          pointee_type<typename T::element_type>(), value.get(), pointer_kind::shared
+        );
+      } else if constexpr (packtl::is_type<std::weak_ptr, T>::value) {
+        const auto locked = value.lock();
+        visitor.on_pointer(
+          pointee_type<typename T::element_type>(), locked.get(), pointer_kind::weak
+        );
+      } else if constexpr (std::same_as<T, char*> or std::same_as<T, const char*>) {
+        if (value == nullptr) {
+          visitor.on_null();
+        } else {
+          visitor.on_string(value);
+        }
+      } else if constexpr (std::is_pointer_v<T>) {
+        visitor.on_pointer(
+          pointee_type<std::remove_pointer_t<T>>(), value, pointer_kind::raw
+        );
+      } else if constexpr (is_soa_vector<T>::value) {
+        static const type_info& row_type = from<typename T::value_type>();
+        visitor.begin_sequence(value.size());
+        for (std::size_t i = 0; i < value.size(); ++i) {
+          const auto row = value.load(i);
+          visitor.on_element(row_type, &row);
+        }
+        visitor.end_sequence();
+      } else if constexpr (packtl::is_type<std::map, T>::value or
+                           packtl::is_type<std::unordered_map, T>::value) {
+        if constexpr (std::same_as<typename T::key_type, std::string>) {
+          static const type_info& mapped = from<typename T::mapped_type>();
+          visitor.begin_mapping(value.size());
+          for (const auto& [key, item]: value) {
+            visitor.on_entry(key, mapped, &item);
+          }
+          visitor.end_mapping();
+        } else {
+          visit_elements(value, visitor);
+        }
+      } else if constexpr (packtl::is_type<std::vector, T>::value or is_std_array<T>::value or
+                           packtl::is_type<std::list, T>::value or
+                           packtl::is_type<std::deque, T>::value or
+                           packtl::is_type<std::set, T>::value or
+                           packtl::is_type<std::unordered_set, T>::value) {
+        visit_elements(value, visitor);
+      } else if constexpr (packtl::is_type<std::pair, T>::value) {
+        static const type_info& second = from<typename T::second_type>();
+        if constexpr (std::same_as<std::remove_const_t<typename T::first_type>, std::string>) {
+          visitor.begin_mapping(1);
+          visitor.on_entry(value.first, second, &value.second);
+          visitor.end_mapping();
+        } else {
+          static const type_info& first = from<typename T::first_type>();
+          visitor.begin_sequence(2);
+          visitor.on_element(first, &value.first);
+          visitor.on_element(second, &value.second);
+          visitor.end_sequence();
+        }
+      } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+        visitor.on_string(std::string_view{value});
+      } else if constexpr (std::is_convertible_v<T, std::string>) {
+        visitor.on_string(std::string{value});
+      } else if constexpr (std::same_as<T, bool>) {
+        visitor.on_bool(value);
+      } else if constexpr (std::same_as<T, char>) {
+        visitor.on_char(value);
+      } else if constexpr (std::same_as<T, short> or std::same_as<T, int> or
+                           std::same_as<T, long>) {
+        visitor.on_int(static_cast<std::int64_t>(value));
+      } else if constexpr (std::same_as<T, unsigned short> or std::same_as<T, unsigned int> or
+                           std::same_as<T, unsigned long>) {
+        visitor.on_uint(static_cast<std::uint64_t>(value));
+      } else if constexpr (std::same_as<T, float> or std::same_as<T, double>) {
+        // Other arithmetic types (`long long`, `unsigned char`, `long double`...) are formatted,
+        // as the formats write them
+        visitor.on_float(static_cast<double>(value), std::same_as<T, float>);
+      } else if constexpr (Reflected<T>) {
+        static const type_info& self = from<T>();
+        visitor.on_object(self, ptr);
+      } else if constexpr (std::formattable<T, char>) {
+        visitor.on_formatted(std::format("{}", value));
+      } else {
+        visitor.on_null();
+      }
+    }
+
     template <typename Method>
     void push_method() {
-      methods_.push_back({
-        // .type        = []() -> type_info { return from<typename field<T, I>::type>(); },
+      method_info info {
         .index = Method::index,
         .name = Method::name,
+        .name_hash = Method::name_hash,
         .access_type = Method::access,
-      });
+        .is_static = Method::is_static,
+        .param_type_ids = {},
+        .return_type = nullptr,
+        .result_size = 0,
+        .result_alignment = 0,
+        .invoker = nullptr,
+      };
+
+      if constexpr (is_invocable_method<Method>) {
+        using signature = typename Method::signature;
+        using R         = typename signature::return_type;
+        if constexpr (not std::is_void_v<R>) {
+          info.return_type      = &type_getter<std::remove_cvref_t<R>>;
+          info.result_size      = sizeof(std::remove_cvref_t<R>);
+          info.result_alignment = alignof(std::remove_cvref_t<R>);
+        }
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          info.param_type_ids = {
+            type_id<std::remove_cvref_t<std::tuple_element_t<I, typename signature::arg_types>>>...
+          };
+        }(std::make_index_sequence<signature::arity>{});
+        info.invoker = &invoke_method<Method>;
+      }
+
+      methods_.push_back(std::move(info));
       const auto& method = methods_.back();
 
-      methods_by_name_[method.name] = &method;
+      // Overloads share a name, both lookups resolve to the first one declared
+      methods_by_name_.try_emplace(method.name, &method);
+      methods_by_hash_.try_emplace(method.name_hash, methods_.size() - 1);
     }
   public:
 
@@ -190,6 +445,8 @@ namespace refl {
           (ti.push_field<field<type, I>>(), ...);
         }(std::make_index_sequence<f_count>{});
 
+        // method_info pointers are handed out, so the table must never reallocate
+        ti.methods_.reserve(m_count);
         [&]<std::size_t... I>(std::index_sequence<I...>) {
           (ti.push_method<method<type, I>>(), ...);
         }(std::make_index_sequence<m_count>{});
@@ -235,6 +492,17 @@ namespace refl {
           dest_ref = src_ref;
         };
       }
+      if constexpr(is_destroyable<type>) {
+        ti.destroy_function_ = [](void* ptr) {
+          delete static_cast<type*>(ptr);
+        };
+        ti.destroy_at_function_ = [](void* ptr) {
+          std::destroy_at(static_cast<type*>(ptr));
+        };
+      }
+      if constexpr (std::is_object_v<type> and not std::is_array_v<type>) {
+        ti.visit_value_function_ = &visit_value_thunk<type>;
+      }
       if constexpr(Reflected<type>) {
         ti.equality_function_ = [](const void* lhs, const void* rhs) {
           const type& LHS = *static_cast<const type*>(lhs);
@@ -273,6 +541,35 @@ namespace refl {
       return std::nullopt;
     }
 
+    const auto& methods() const {
+      return methods_;
+    }
+
+    std::optional<const method_info*> method_by_index(std::size_t index) const {
+      if (index < methods_.size()) {
+        return &methods_[index];
+      }
+      return std::nullopt;
+    }
+
+    /// For overloaded names the first declared overload is returned, the others are only found
+    /// through `methods()` or `method_by_index`.
+    std::optional<const method_info*> method_by_name(const std::string& name) const {
+      if (methods_by_name_.contains(name)) {
+        return methods_by_name_.at(name);
+      }
+      return std::nullopt;
+    }
+
+    /// Looks a method up by the FNV-1a hash of its name (see `refl::method<T, I>::name_hash`).
+    /// For overloaded names the first declared overload is returned.
+    std::optional<const method_info*> method_by_hash(std::uint64_t name_hash) const {
+      if (auto it = methods_by_hash_.find(name_hash); it != methods_by_hash_.end()) {
+        return &methods_[it->second];
+      }
+      return std::nullopt;
+    }
+
     std::size_t hash_code() const {
       return type_id_;
     }
@@ -344,6 +641,29 @@ namespace refl {
       }
     }
 
+    void destroy(void* ptr) const {
+      if (destroy_function_.has_value()) {
+        destroy_function_.value()(ptr);
+      }
+    }
+
+    /// Ends the lifetime of the object at `ptr` without freeing its storage
+    void destroy_at(void* ptr) const {
+      if (destroy_at_function_ != nullptr) {
+        destroy_at_function_(ptr);
+      }
+    }
+
+    /// Reports the value at `ptr` to `visitor` through the thunk captured by `from<T>()`, a single
+    /// indirect call. Types that can't be described are reported as null.
+    void visit_value(const void* ptr, value_visitor& visitor) const {
+      if (visit_value_function_ == nullptr or ptr == nullptr) {
+        visitor.on_null();
+        return;
+      }
+      visit_value_function_(ptr, visitor);
+    }
+
     bool equality(const void* lhs, const void* rhs) const {
       if (equality_function_.has_value()) {
         return equality_function_.value()(lhs, rhs);
@@ -356,8 +676,9 @@ namespace refl {
     std::list<field_info> fields_{};
     std::unordered_map<std::string, const field_info*> fields_by_name_{};
     std::unordered_map<std::size_t, const field_info*> fields_by_offset_{};
-    std::list<method_info> methods_{};
+    std::vector<method_info> methods_{};
     std::unordered_map<std::string, const method_info*> methods_by_name_{};
+    std::unordered_map<std::uint64_t, std::size_t> methods_by_hash_{};
 
     bool is_const_ = false;
     bool is_lval_ref_ = false;
@@ -374,7 +695,13 @@ namespace refl {
     [[refl::ignore]]
     std::optional<std::function<void(void*,const void*)>> copy_assign_function_{std::nullopt};
     [[refl::ignore]]
+    std::optional<std::function<void(void*)>> destroy_function_{std::nullopt};
+    [[refl::ignore]]
+    void (*destroy_at_function_)(void*) = nullptr;
+    [[refl::ignore]]
     std::optional<std::function<bool(const void*,const void*)>> equality_function_{std::nullopt};
+    [[refl::ignore]]
+    void (*visit_value_function_)(const void*, value_visitor&) = nullptr;
   };
 
 
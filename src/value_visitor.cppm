@@ -0,0 +1,59 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  value_visitor.cppm
+ *! \brief Runtime counterpart of `refl::visitor`, for values whose type is only known through
+ *!        their `type_info`.
+ *!
+ */
+
+export module reflect:value_visitor;
+
+import std;
+
+namespace refl {
+  export class type_info;
+
+  export enum class pointer_kind {
+    raw,
+    unique,
+    shared,
+    weak,
+  };
+
+  /// Receives the shape of a type-erased value. Every `type_info` captures a thunk that classifies
+  /// its type once, at compile time, and calls back into one of these (see
+  /// `type_info::visit_value`). Nested values are handed over as a `type_info` and a pointer so the
+  /// visitor decides whether and how to descend into them.
+  export struct value_visitor {
+    virtual ~value_visitor() = default;
+
+    virtual void on_null()                                = 0;
+    virtual void on_bool(bool value)                      = 0;
+    virtual void on_char(char value)                      = 0;
+    virtual void on_int(std::int64_t value)               = 0;
+    virtual void on_uint(std::uint64_t value)             = 0;
+    virtual void on_float(double value, bool single)      = 0;
+    virtual void on_string(std::string_view value)        = 0;
+    /// Any other `std::formattable` type, already formatted with `"{}"`
+    virtual void on_formatted(std::string_view value)     = 0;
+
+    /// Raw and smart pointers, never followed by the thunk. `target_type` is null when the
+    /// pointee is not an object type, `target` is null for null and expired pointers.
+    virtual void
+    on_pointer(const type_info* target_type, const void* target, pointer_kind kind) = 0;
+
+    /// Ranges, and pairs not keyed by a string
+    virtual void begin_sequence(std::size_t size)                         = 0;
+    virtual void on_element(const type_info& type, const void* value)     = 0;
+    virtual void end_sequence()                                           = 0;
+
+    /// String keyed maps and pairs, entries come in iteration order
+    virtual void begin_mapping(std::size_t size)                                         = 0;
+    virtual void on_entry(std::string_view key, const type_info& type, const void* value) = 0;
+    virtual void end_mapping()                                                           = 0;
+
+    /// Reflected types, walk `type.fields()` to descend
+    virtual void on_object(const type_info& type, const void* value) = 0;
+  };
+} // namespace refl
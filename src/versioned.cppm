@@ -0,0 +1,304 @@
+// Copyright (c) 2025, Víctor Castillo Agüero.
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*! \file  versioned.cppm
+ *! \brief Read-copy-update snapshots of reflected values, reclaimed by epochs.
+ *!
+ */
+
+export module reflect:versioned;
+
+import std;
+
+import :types;
+import :type_name;
+import :accessors;
+import :type_info;
+
+namespace refl::versioned_impl {
+  inline constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+  /// Epoch a reader thread announced when it pinned its first snapshot, `idle` outside of reads.
+  /// Records are never freed, a thread that exits hands its record to the next new thread.
+  struct reader_record {
+    std::atomic<std::uint64_t> epoch{idle};
+    std::atomic<bool>          in_use{true};
+    reader_record*             next  = nullptr;
+    std::size_t                depth = 0;
+  };
+
+  /// Global epoch shared by every `versioned`, and the records of the threads reading them
+  class epoch_domain {
+  public:
+    reader_record* acquire() {
+      for (reader_record* record = head_.load(std::memory_order_acquire); record != nullptr;
+           record                = record->next) {
+        bool expected = false;
+        if (not record->in_use.load(std::memory_order_relaxed) and
+            record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+          return record;
+        }
+      }
+
+      auto* record = new reader_record{};
+      record->next = head_.load(std::memory_order_relaxed);
+      while (not head_.compare_exchange_weak(record->next, record, std::memory_order_release)) {
+      }
+      return record;
+    }
+
+    void release(reader_record* record) {
+      record->in_use.store(false, std::memory_order_release);
+    }
+
+    std::uint64_t current() const {
+      return epoch_.load();
+    }
+
+    /// Moves to the next epoch, returning the one that just ended
+    std::uint64_t advance() {
+      return epoch_.fetch_add(1);
+    }
+
+    /// Oldest epoch a reader is still inside of, `idle` if there is no reader
+    std::uint64_t oldest_reader() const {
+      std::uint64_t oldest = idle;
+      for (reader_record* record = head_.load(std::memory_order_acquire); record != nullptr;
+           record                = record->next) {
+        oldest = std::min(oldest, record->epoch.load());
+      }
+      return oldest;
+    }
+
+  private:
+    std::atomic<std::uint64_t>  epoch_{1};
+    std::atomic<reader_record*> head_{nullptr};
+  };
+
+  inline epoch_domain& domain() {
+    // Leaked on purpose, threads still running at exit may be reading through it
+    static epoch_domain* instance = new epoch_domain{};
+    return *instance;
+  }
+
+  struct thread_reader {
+    reader_record* record = domain().acquire();
+
+    ~thread_reader() {
+      domain().release(record);
+    }
+  };
+
+  inline reader_record& this_reader() {
+    thread_local thread_reader reader{};
+    return *reader.record;
+  }
+
+  /// Enters a read section, nested sections keep the epoch of the outermost one
+  inline reader_record* pin() {
+    reader_record& record = this_reader();
+    if (record.depth++ == 0) {
+      // The epoch is announced before the snapshot pointer is loaded, so a writer that sees this
+      // reader idle has already swapped in a snapshot the reader will get instead
+      record.epoch.store(domain().current());
+    }
+    return &record;
+  }
+
+  inline void unpin(reader_record* record) {
+    if (--record->depth == 0) {
+      record->epoch.store(idle, std::memory_order_release);
+    }
+  }
+} // namespace refl::versioned_impl
+
+export namespace refl {
+  /// Value for one field of a `versioned::patch`, `value` points to an object of the field's type
+  struct field_patch {
+    field_path  path;
+    const void* value;
+  };
+
+  /// Holds immutable versions of a `T`. Readers pin the current version without locking or
+  /// waiting on writers, writers copy it, change the copy and publish it in a single atomic swap.
+  /// Replaced versions are destroyed once every reader that could still see them is done.
+  ///
+  /// Writers are serialized with each other. No `snapshot` may outlive its `versioned`.
+  template <Reflected T>
+  class versioned {
+    struct node {
+      T             value;
+      std::uint64_t version;
+    };
+
+  public:
+    using value_type = T;
+
+    /// Pinned version of the value, it stays alive and unchanged for as long as the snapshot
+    /// exists. Snapshots are meant to be short lived and stay on the thread that took them, a
+    /// long lived one holds back the reclamation of every newer version.
+    class snapshot {
+    public:
+      snapshot(const snapshot&)            = delete;
+      snapshot& operator=(const snapshot&) = delete;
+
+      snapshot(snapshot&& other) noexcept
+          : record_(std::exchange(other.record_, nullptr)),
+            node_(other.node_) {}
+
+      snapshot& operator=(snapshot&& other) noexcept {
+        if (this != &other) {
+          release();
+          record_ = std::exchange(other.record_, nullptr);
+          node_   = other.node_;
+        }
+        return *this;
+      }
+
+      ~snapshot() {
+        release();
+      }
+
+      const T& value() const {
+        return node_->value;
+      }
+
+      const T& operator*() const {
+        return node_->value;
+      }
+
+      const T* operator->() const {
+        return &node_->value;
+      }
+
+      /// Number of the version, the initial value is version `0`
+      std::uint64_t version() const {
+        return node_->version;
+      }
+
+    private:
+      friend class versioned;
+
+      snapshot(versioned_impl::reader_record* record, const node* pinned)
+          : record_(record),
+            node_(pinned) {}
+
+      void release() {
+        if (record_ != nullptr) {
+          versioned_impl::unpin(record_);
+          record_ = nullptr;
+        }
+      }
+
+      versioned_impl::reader_record* record_;
+      const node*                    node_;
+    };
+
+    versioned()
+        : versioned(T{}) {}
+
+    explicit versioned(T value)
+        : current_(new node{std::move(value), 0}) {}
+
+    versioned(const versioned&)            = delete;
+    versioned& operator=(const versioned&) = delete;
+
+    ~versioned() {
+      delete current_.load(std::memory_order_relaxed);
+      for (const auto& [epoch, old]: retired_) {
+        delete old;
+      }
+    }
+
+    /// Pins the current version, never blocks
+    snapshot read() const {
+      versioned_impl::reader_record* record = versioned_impl::pin();
+      return snapshot{record, current_.load()};
+    }
+
+    /// Copy of the current value
+    T get() const {
+      return read().value();
+    }
+
+    /// Number of the current version
+    std::uint64_t version() const {
+      return read().version();
+    }
+
+    /// Replaces the whole value
+    void publish(T value) {
+      std::lock_guard lock{writer_};
+      swap_in(std::move(value));
+    }
+
+    /// Copies the current value, hands the copy to `func` and publishes whatever it left there
+    template <typename F>
+    void update(F&& func) {
+      std::lock_guard lock{writer_};
+      T draft = current_.load(std::memory_order_relaxed)->value;
+      std::forward<F>(func)(draft);
+      swap_in(std::move(draft));
+    }
+
+    /// Publishes a copy of the current value with the fields at `patches` overwritten through
+    /// `type_info::assign_copy_of`, so they can be chosen at runtime
+    void patch(std::span<const field_patch> patches) {
+      update([&](T& draft) {
+        for (const auto& [path, value]: patches) {
+          path.type().assign_copy_of(value, path.get_ptr(&draft));
+        }
+      });
+    }
+
+    /// Publishes a copy of the current value with the field at `path` set to `value`. Throws
+    /// `std::invalid_argument` when `V` is not the type of the field.
+    template <typename V>
+    void patch(const field_path& path, const V& value) {
+      if (path.type().id() != type_id<V>) {
+        throw std::invalid_argument(
+          std::format("Field is a '{}', not a '{}'", path.type().name(), type_name<V>)
+        );
+      }
+      const field_patch patches[]{{path, &value}};
+      patch(patches);
+    }
+
+    /// Destroys the replaced versions no reader can see anymore, writers already call it on every
+    /// publish
+    void reclaim() {
+      std::lock_guard lock{writer_};
+      collect();
+    }
+
+    /// Replaced versions still waiting for their readers
+    std::size_t retired() const {
+      std::lock_guard lock{writer_};
+      return retired_.size();
+    }
+
+  private:
+    void swap_in(T value) {
+      const std::uint64_t number = current_.load(std::memory_order_relaxed)->version + 1;
+      node*               old    = current_.exchange(new node{std::move(value), number});
+      // Readers that pin from now on announce a later epoch and load the new version
+      retired_.emplace_back(versioned_impl::domain().advance(), old);
+      collect();
+    }
+
+    void collect() {
+      const std::uint64_t oldest = versioned_impl::domain().oldest_reader();
+      std::erase_if(retired_, [oldest](const auto& entry) {
+        if (entry.first < oldest) {
+          delete entry.second;
+          return true;
+        }
+        return false;
+      });
+    }
+
+    std::atomic<node*>                           current_;
+    mutable std::mutex                           writer_{};
+    std::vector<std::pair<std::uint64_t, node*>> retired_{};
+  };
+} // namespace refl
@@ -15,14 +15,9 @@ import packtl;
 import :types;
 import :accessors;
 import :type_name;
+import :instrumentation;
 
 export namespace refl {
-  template <typename T>
-  struct is_std_array: std::false_type {};
-
-  template <typename T, std::size_t N>
-  struct is_std_array<std::array<T, N>>: std::true_type {};
-
   template <typename Derived>
   struct visitor {
     visitor() = default;
@@ -101,15 +96,35 @@ export namespace refl {
 
     template <refl::Reflected R>
     void visit_obj(const R& obj) {
-      [&]<std::size_t... I>(std::index_sequence<I...>) {
-        (self().template handle_field<R, refl::field<R, I>>(obj), ...);
-      }(std::make_index_sequence<refl::field_count<R>>());
+      instrumented<R>([&] {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+          (instrumented<R, refl::field<R, I>>([&] {
+             self().template handle_field<R, refl::field<R, I>>(obj);
+           }),
+           ...);
+        }(std::make_index_sequence<refl::field_count<R>>());
+      });
 
       [&]<std::size_t... I>(std::index_sequence<I...>) {
         (visit_obj_method<R, I>(obj), ...);
       }(std::make_index_sequence<refl::method_count<R>>());
     }
 
+    /// Runs `body` under the instrumentation probe of `R`, or of its `Field`. Formats exposing
+    /// `bytes_written()` also get the bytes they emitted counted. A plain call of `body` unless
+    /// instrumentation is enabled.
+    template <refl::Reflected R, typename Field = void, typename F>
+    void instrumented(F&& body) {
+      using instrumentation::operation;
+      if constexpr (requires { self().bytes_written(); }) {
+        instrumentation::probe<operation::visit, R, Field>(body, [this] {
+          return self().bytes_written();
+        });
+      } else {
+        instrumentation::probe<operation::visit, R, Field>(body);
+      }
+    }
+
     template <refl::Reflected R, typename Field>
     void visit_obj_field(const R& obj) {
       if constexpr (std::is_reference_v<typename Field::type>) {
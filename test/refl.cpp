@@ -151,3 +151,837 @@ TEST("Annotations") {
   constexpr std::tuple<const char*> t = {"asdf"};
   return 0;
 }
+
+struct invoke_me {
+  int value = 10;
+
+  int add(int v) {
+    value += v;
+    return value;
+  }
+
+  std::string greet(const std::string& name) const {
+    return "hello, " + name;
+  }
+
+  static int twice(int v) {
+    return 2 * v;
+  }
+
+  std::string refuse(int v) const {
+    throw std::out_of_range(std::to_string(v));
+  }
+};
+
+TEST("Method Invocation") {
+  const auto& ti = refl::type_info::from<invoke_me>();
+  invoke_me   obj{};
+
+  const auto* add = ti.method_by_hash(refl::method<invoke_me, 0>::name_hash).value();
+  if (add->name != "add" or not add->is_invocable() or add->arity() != 1) {
+    return 1;
+  }
+  int  five   = 5;
+  auto result = add->invoke(obj, {five});
+  if (result.as<int>() != 15 or obj.value != 15) {
+    return 1;
+  }
+
+  const auto* greet = ti.method_by_name("greet").value();
+  std::string name  = "world";
+  if (greet->invoke(obj, {name}).as<std::string>() != "hello, world") {
+    return 1;
+  }
+
+  const auto* twice = ti.method_by_index(2).value();
+  if (not twice->is_static or twice->invoke({}, {five}).as<int>() != 10) {
+    return 1;
+  }
+
+  // Argument types are checked against the signature
+  std::string wrong = "5";
+  try {
+    add->invoke(obj, {wrong});
+    return 1;
+  } catch (const std::bad_cast&) {
+  }
+
+  // Exceptions thrown by the method reach the caller, the storage of the result is released
+  const auto* refuse = ti.method_by_name("refuse").value();
+  try {
+    refuse->invoke(obj, {five});
+    return 1;
+  } catch (const std::out_of_range&) {
+  }
+
+  return 0;
+}
+
+struct overload_me {
+  int scale(int v) const {
+    return 2 * v;
+  }
+
+  double scale(double v) const {
+    return 0.5 * v;
+  }
+};
+
+TEST("Method Overload Lookup") {
+  const auto& ti       = refl::type_info::from<overload_me>();
+  const auto* by_name  = ti.method_by_name("scale").value();
+  const auto* by_hash  = ti.method_by_hash(refl::detail::fnv1a("scale")).value();
+  const auto* by_index = ti.method_by_index(0).value();
+  return by_name == by_hash and by_name == by_index and
+             by_name->param_type_ids.front() == refl::type_id<int>
+           ? 0
+           : 1;
+}
+
+struct track_me {
+  int              a = 1;
+  std::string      b = "b";
+  std::vector<int> c = {};
+};
+
+TEST("Tracked Dirty Fields") {
+  refl::tracked<track_me> state{};
+  if (state.dirty_count() != 3) {
+    return 1;
+  }
+  state.clear_dirty();
+
+  // Assigning the current value is not a change
+  state.set<0>(1);
+  if (state.any_dirty()) {
+    return 1;
+  }
+
+  state.at<1>() = std::string{"changed"};
+  state.edit<2>().push_back(4);
+  if (state.is_dirty<0>() or not state.is_dirty<1>() or not state.is_dirty(2)) {
+    return 1;
+  }
+  if (state->b != "changed" or state.get<2>().size() != 1) {
+    return 1;
+  }
+
+  state.clear_dirty();
+  state.modify([](track_me& value) { value.a = 2; });
+  return state.dirty_count() == 3 and state.value().a == 2 ? 0 : 1;
+}
+
+struct soa_row {
+  float       x     = 0.0F;
+  int         id    = 0;
+  bool        alive = true;
+  std::string tag   = {};
+};
+TEST("SoA Vector") {
+  refl::soa_vector<soa_row> rows{};
+  for (int i = 0; i < 100; ++i) {
+    rows.push_back({static_cast<float>(i), i, i % 2 == 0, std::format("row-{}", i)});
+  }
+
+  float sum = 0.0F;
+  for (float x: rows.column<0>()) {
+    sum += x;
+  }
+  if (sum != 4950.0F or std::ranges::count(rows.column<2>(), true) != 50) {
+    return 1;
+  }
+
+  rows[3].get<1>() = 42;
+  rows[4]          = soa_row{1.0F, 7, false, "replaced"};
+  const soa_row row = rows[4];
+  if (rows.get<1>(3) != 42 or row.tag != "replaced" or rows[4].get<3>() != "replaced") {
+    return 1;
+  }
+
+  const auto                      aos = rows.to_vector();
+  const refl::soa_vector<soa_row> copy(aos);
+  if (aos.size() != 100 or not refl::deep_eq(rows, copy)) {
+    return 1;
+  }
+  rows.back().get<3>() = "changed";
+  if (refl::deep_eq(rows, copy)) {
+    return 1;
+  }
+
+  try {
+    (void)rows.at(100);
+    return 1;
+  } catch (const std::out_of_range&) {
+  }
+
+  // Rows move together through the std::ranges algorithms
+  static_assert(std::random_access_iterator<refl::soa_vector<soa_row>::iterator>);
+  refl::soa_vector<soa_row> sorted{};
+  for (int i = 0; i < 100; ++i) {
+    sorted.push_back({static_cast<float>(i), i, true, std::format("row-{}", i)});
+  }
+  std::ranges::sort(sorted, std::greater<>{}, [](const soa_row& value) {
+    return value.x;
+  });
+  for (std::size_t i = 0; i < sorted.size(); ++i) {
+    const soa_row value = sorted[i];
+    if (value.id != static_cast<int>(99 - i) or value.tag != std::format("row-{}", 99 - i)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+struct query_row {
+  int         id    = 0;
+  double      price = 0.0;
+  int         qty   = 0;
+  std::string sym   = {};
+};
+TEST("Query Engine") {
+  std::vector<query_row> rows{};
+  for (int i = 0; i < 1000; ++i) {
+    rows.push_back({i, static_cast<double>(i % 250), i % 7, i % 3 == 0 ? "BBB" : "AAA"});
+  }
+
+  std::vector<std::tuple<int, int>> expected{};
+  for (const auto& row: rows) {
+    if (row.price > 100 and row.qty >= 2 and row.sym == "AAA") {
+      expected.emplace_back(row.id, row.qty);
+    }
+  }
+
+  const auto selected = refl::query<query_row>(rows)
+                          .where<"price">(refl::ops::gt, 100)
+                          .where<"qty">(refl::ops::ge, 2)
+                          .where<"sym">(refl::ops::eq, "AAA")
+                          .select<"id", "qty">();
+  if (selected != expected) {
+    return 1;
+  }
+
+  // Same answer from a soa_vector, a row predicate and several threads
+  const refl::soa_vector<query_row> columns(rows);
+  refl::query<query_row>            soa{columns};
+  soa.parallel(4).where<"price">(refl::ops::gt, 100).where([](const query_row& row) {
+    return row.qty >= 2 and row.sym == "AAA";
+  });
+  if (soa.count() != expected.size() or soa.select<"id", "qty">() != expected) {
+    return 1;
+  }
+
+  std::int64_t qty = 0;
+  for (const auto& [id, q]: expected) {
+    qty += q;
+  }
+  if (soa.sum<"qty">() != qty or refl::field_index<query_row, "sym"> != 3) {
+    return 1;
+  }
+
+  // Enough rows for each of 4 threads to get its minimum of 256 bitmap words
+  std::vector<query_row> many{};
+  for (int i = 0; i < 4 * 256 * 64 + 100; ++i) {
+    many.push_back({i, static_cast<double>(i % 250), i % 7, i % 3 == 0 ? "BBB" : "AAA"});
+  }
+  const auto filter = [](refl::query<query_row>& q) -> refl::query<query_row>& {
+    return q.where<"price">(refl::ops::gt, 100).where([](const query_row& row) {
+      return row.qty >= 2 and row.sym == "AAA";
+    });
+  };
+  refl::query<query_row> sequential{many};
+  refl::query<query_row> threaded{many};
+  filter(sequential);
+  filter(threaded.parallel(4));
+  return threaded.count() == sequential.count() and
+             threaded.select<"id", "qty">() == sequential.select<"id", "qty">() and
+             threaded.sum<"qty">() == sequential.sum<"qty">()
+           ? 0
+           : 1;
+}
+
+struct indexed_row {
+  [[meta(refl::index::hash)]]
+  int id = 0;
+
+  [[meta(refl::index::hash)]]
+  std::string name = {};
+
+  [[meta(refl::index::ordered)]]
+  std::int64_t created = 0;
+
+  double score = 0.0;
+};
+TEST("Indexed Table") {
+  refl::indexed_table<indexed_row> table{};
+  for (int i = 0; i < 1000; ++i) {
+    table.insert({i, std::format("user-{}", i % 10), i % 100, 0.0});
+  }
+
+  const auto row = table.find<"id">(42);
+  if (not row or table[*row].name != "user-2" or table.find_all<"name">("user-3").size() != 100) {
+    return 1;
+  }
+
+  // Updates through the setter move the row between index entries
+  table.set<"name">(*row, std::string{"renamed"});
+  table.set<"created">(*row, 5000);
+  if (table.find_all<"name">("user-2").size() != 99 or table.find<"name">("renamed") != row or
+      table.range<"created">(5000, 6000) != std::vector{*row}) {
+    return 1;
+  }
+
+  table.erase(*row);
+  if (table.find<"id">(42) or table.contains(*row) or table.size() != 999) {
+    return 1;
+  }
+
+  const auto range = table.range<"created">(10, 12);
+  if (range.size() != 20 or table[range.front()].created != 10 or
+      table[range.back()].created != 11) {
+    return 1;
+  }
+
+  // A throwing mutation leaves the row indexed under its partially updated fields
+  const auto victim = *table.find<"id">(7);
+  try {
+    table.modify(victim, [](indexed_row& value) {
+      value.id = 7007;
+      throw std::runtime_error("rejected");
+    });
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+  if (table.find<"id">(7) or table.find<"id">(7007) != victim or
+      std::ranges::count(table.find_all<"name">("user-7"), victim) != 1) {
+    return 1;
+  }
+
+  // Erased ids are reused and re-indexed
+  const auto reused = table.insert({4242, "new", 7, 1.0});
+  try {
+    (void)table.at(5000);
+    return 1;
+  } catch (const std::out_of_range&) {
+  }
+  return reused == *row and table.find<"id">(4242) == reused ? 0 : 1;
+}
+
+enum class sort_tier : signed char {
+  low  = -1,
+  mid  = 0,
+  high = 1,
+};
+struct sort_row {
+  int         a    = 0;
+  double      b    = 0.0;
+  std::string name = {};
+  sort_tier   tier = sort_tier::mid;
+  std::size_t seq  = 0;
+};
+TEST("Radix Sort By Fields") {
+  std::mt19937_64       rng{42};
+  std::vector<sort_row> rows{};
+  // Enough rows for parallel_sort_by to hand each of its 4 workers a share
+  for (std::size_t i = 0; i < 200'000; ++i) {
+    rows.push_back({
+      static_cast<int>(rng() % 200) - 100,
+      static_cast<double>(static_cast<std::int64_t>(rng() % 2001) - 1000) / 8.0,
+      // Long shared prefixes so the string keys tie and need the comparison fallback
+      std::format("customer-{}", rng() % 40),
+      sort_tier{static_cast<signed char>(static_cast<int>(rng() % 3) - 1)},
+      i,
+    });
+  }
+
+  auto same_order = [](const auto& lhs, const auto& rhs) {
+    return std::ranges::equal(lhs, rhs, {}, &sort_row::seq, &sort_row::seq);
+  };
+
+  auto by_ab = rows;
+  auto ref   = rows;
+  refl::sort_by<sort_row, "a", "b">(by_ab);
+  std::ranges::stable_sort(ref, [](const auto& l, const auto& r) {
+    return std::tie(l.a, l.b) < std::tie(r.a, r.b);
+  });
+  if (not same_order(by_ab, ref)) {
+    return 1;
+  }
+
+  auto by_name = rows;
+  ref          = rows;
+  refl::parallel_sort_by<sort_row, "name", "tier", "b">(by_name, 4);
+  std::ranges::stable_sort(ref, [](const auto& l, const auto& r) {
+    return std::tie(l.name, l.tier, l.b) < std::tie(r.name, r.tier, r.b);
+  });
+  return same_order(by_name, ref) ? 0 : 1;
+}
+
+TEST("Radix Sort NaN Keys") {
+  constexpr double nan      = std::numeric_limits<double>::quiet_NaN();
+  constexpr double inf      = std::numeric_limits<double>::infinity();
+  constexpr double values[] = {1.5, nan, -inf, -0.0, -nan, inf, 0.0, -2.0};
+
+  // Both the comparison sort below the radix threshold and the radix sort above it
+  for (const std::size_t size: {64, 4096}) {
+    std::vector<sort_row> rows{};
+    for (std::size_t i = 0; i < size; ++i) {
+      rows.push_back({static_cast<int>((size - i) % 7), values[i % std::size(values)], {}, {}, i});
+    }
+
+    // NaN after every number, NaNs tied with each other and ordered by `a`
+    auto ref = rows;
+    std::ranges::stable_sort(ref, {}, [](const sort_row& row) {
+      return std::tuple{std::isnan(row.b), std::isnan(row.b) ? 0.0 : row.b, row.a};
+    });
+    refl::sort_by<sort_row, "b", "a">(rows);
+    if (not std::ranges::equal(rows, ref, {}, &sort_row::seq, &sort_row::seq)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+struct path_tls {
+  bool enabled = false;
+  int  port    = 443;
+};
+struct path_server {
+  std::string host     = "localhost";
+  path_tls    tls      = {};
+  path_tls*   fallback = nullptr;
+};
+struct path_config {
+  int          version = 1;
+  path_server  server  = {};
+  path_server* mirror  = nullptr;
+};
+TEST("Compiled Field Path") {
+  path_tls    spare{true, 8443};
+  path_server mirror{"mirror", {}, &spare};
+  path_config cfg{};
+  cfg.mirror = &mirror;
+
+  // Plain nested members fold into one offset
+  const auto& port = refl::compile_path<path_config>("server.tls.port");
+  if (not port.is_direct() or &port.get_ref<int>(&cfg) != &cfg.server.tls.port) {
+    return 1;
+  }
+  if (&port != &refl::compile_path<path_config>("server.tls.port")) {
+    return 1;
+  }
+
+  // Only the walked pointers stay as steps
+  const auto& fallback = refl::compile_path<path_config>("mirror.fallback.port");
+  if (fallback.steps().size() != 3 or fallback.get_ref<int>(&cfg) != 8443 or
+      not fallback.type().is_type<int>()) {
+    return 1;
+  }
+
+  // Compile time and runtime parsing agree
+  if (refl::compile_path<path_config, "mirror.fallback.port">() != fallback or
+      refl::compile_path<path_config, "server.tls.port">().hash() != port.hash()) {
+    return 1;
+  }
+
+  mirror.fallback = nullptr;
+  if (fallback.get_ptr(&cfg) != nullptr) {
+    return 1;
+  }
+
+  try {
+    (void)refl::compile_path<path_config>("server.nope");
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  return 0;
+}
+
+struct layout_loose {
+  char   tag;
+  double value;
+  char   flag;
+};
+
+struct layout_tight {
+  double value;
+  int    count;
+  char   tag;
+  char   flag;
+};
+
+static_assert(refl::padding_bytes<layout_tight> == 2);
+
+TEST("Layout Analyzer") {
+  using loose = refl::layout<layout_loose>;
+  if (loose::padding_bytes != 14 or loose::tail_padding != 7 or loose::holes.size() != 2) {
+    return 1;
+  }
+  if (loose::holes[0].offset != 1 or loose::holes[0].size != 7) {
+    return 1;
+  }
+
+  // Largest alignment first: value, tag, flag
+  if (loose::suggested_order != std::array<std::size_t, 3>{1, 0, 2} or
+      loose::suggested_size != 16) {
+    return 1;
+  }
+
+  // Already well ordered, only tail padding left
+  using tight = refl::layout<layout_tight>;
+  if (tight::holes.size() != 1 or tight::suggested_size != sizeof(layout_tight)) {
+    return 1;
+  }
+  if (tight::cache_lines != 1 or tight::straddling_fields != 0) {
+    return 1;
+  }
+
+  return loose::report().find("reordering saves 8 byte(s): value tag flag") == std::string::npos;
+}
+
+inline std::size_t counted_bytes = 0;
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() = default;
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>&) {}
+
+  T* allocate(std::size_t n) {
+    counted_bytes += n * sizeof(T);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* ptr, std::size_t n) {
+    counted_bytes -= n * sizeof(T);
+    std::allocator<T>{}.deallocate(ptr, n);
+  }
+
+  bool operator==(const counting_allocator&) const = default;
+};
+
+template <typename T>
+using counted_vector = std::vector<T, counting_allocator<T>>;
+using counted_string = std::basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+
+struct usage_leaf {
+  counted_string      label;
+  counted_vector<int> values;
+};
+
+struct usage_root {
+  counted_vector<usage_leaf> leaves;
+  std::map<int, int, std::less<>, counting_allocator<std::pair<const int, int>>> index;
+  std::shared_ptr<usage_leaf> first;
+  std::shared_ptr<usage_leaf> again;
+  [[meta(refl::memory_policy::skip)]]
+  counted_vector<int> scratch;
+};
+
+TEST("Memory Usage") {
+  const std::size_t before = counted_bytes;
+  usage_root        root{};
+  root.leaves.reserve(4);
+  root.leaves.push_back({counted_string(100, 'x'), counted_vector<int>(100)});
+  root.leaves.push_back({"short", {}});
+  root.index = {{1, 2}, {3, 4}};
+  root.first = std::make_shared<usage_leaf>();
+  root.again = root.first;
+  root.scratch.resize(1000);
+
+  // Everything allocated, except the skipped field and the shared pointee
+  const std::size_t counted = counted_bytes - before - 1000 * sizeof(int);
+  const auto        usage   = refl::memory_usage(root);
+  if (usage.inline_bytes != sizeof(usage_root) or
+      usage.heap_bytes - usage.shared_bytes != counted) {
+    return 1;
+  }
+
+  // Two leaves of unused capacity, the string's spare room is 0 or more
+  if (usage.slack_bytes < 2 * sizeof(usage_leaf) or usage.shared_bytes < sizeof(usage_leaf)) {
+    return 1;
+  }
+
+  // The second shared pointer reaches an object that was already counted
+  const auto* first = usage.field("usage_root", "first");
+  const auto* again = usage.field("usage_root", "again");
+  if (first == nullptr or again == nullptr or again->bytes != sizeof(root.again)) {
+    return 1;
+  }
+  if (usage.field("usage_root", "scratch") != nullptr) {
+    return 1;
+  }
+
+  const auto* ints = usage.type("int");
+  if (ints == nullptr or ints->bytes != 100 * sizeof(int)) {
+    return 1;
+  }
+
+  // Sampling one leaf out of two counts the heap of the first one for both
+  const auto        sampled = refl::memory_usage(root, {.sample_limit = 1});
+  const std::size_t leaf0   = refl::memory_usage(root.leaves[0]).heap_bytes;
+  const std::size_t leaf1   = refl::memory_usage(root.leaves[1]).heap_bytes;
+  const std::size_t rest    = usage.heap_bytes - leaf0 - leaf1;
+  return leaf0 > leaf1 and sampled.heap_bytes == rest + 2 * leaf0 ? 0 : 1;
+}
+
+enum class gen_color {
+  red,
+  green,
+  blue,
+};
+
+struct gen_leaf {
+  [[meta(refl::gen::length{3, 5})]]
+  std::string name;
+  [[meta(refl::gen::range{-10, 10})]]
+  int score;
+  [[meta(refl::gen::range{0, 2})]]
+  gen_color color;
+};
+
+struct gen_root {
+  std::uint64_t id;
+  [[meta(refl::gen::count{2, 4})]]
+  std::vector<gen_leaf>      leaves;
+  std::optional<double>      ratio;
+  std::map<int, std::string> tags;
+  [[meta(refl::gen::skip)]]
+  int untouched = 7;
+};
+
+TEST("Generate") {
+  refl::gen::splitmix64 rng1{42};
+  refl::gen::splitmix64 rng2{42};
+  if (not refl::deep_eq(refl::generate<gen_root>(rng1), refl::generate<gen_root>(rng2))) {
+    return 1;
+  }
+
+  const auto values = refl::generate_n<gen_root>(1000, 7, {.threads = 1});
+  for (const auto& value: values) {
+    if (value.untouched != 7 or value.leaves.size() < 2 or value.leaves.size() > 4) {
+      return 1;
+    }
+    for (const auto& leaf: value.leaves) {
+      if (leaf.name.size() < 3 or leaf.name.size() > 5 or leaf.score < -10 or leaf.score > 10 or
+          leaf.color > gen_color::blue) {
+        return 1;
+      }
+    }
+  }
+
+  // The same dataset whatever the number of threads
+  const auto parallel = refl::generate_n<gen_root>(1000, 7, {.threads = 4});
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (not refl::deep_eq(values[i], parallel[i])) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+struct snapshot_cell {
+  int    id    = 0;
+  double value = 0.0;
+};
+
+struct snapshot {
+  std::vector<int>                     counters{};
+  std::deque<snapshot_cell>            cells{};
+  std::unordered_map<std::string, int> totals{};
+  [[meta(refl::eq_policy::skip)]]
+  int revision = 0;
+};
+
+TEST("Parallel Deep Eq And Hash") {
+  snapshot lhs{};
+  for (int i = 0; i < 100'000; ++i) {
+    lhs.counters.push_back(i);
+    lhs.cells.push_back({.id = i, .value = i * 0.5});
+  }
+  lhs.totals = {{"reads", 3}, {"writes", 4}};
+
+  snapshot rhs = lhs;
+  rhs.revision = 1;
+  // `deep_eq` to the `0.0` of the first cell, so it has to hash the same
+  rhs.cells.front().value = -0.0;
+  // Small chunks so every container is split across the threads
+  const refl::parallel_policy policy{.threads = 4, .min_chunk = 1000};
+  if (not refl::deep_eq(lhs, rhs, policy) or not refl::deep_eq(lhs, rhs, refl::par)) {
+    return 1;
+  }
+  if (refl::deep_hash(lhs) != refl::deep_hash(rhs) or
+      refl::deep_hash(lhs, policy) != refl::deep_hash(lhs)) {
+    return 1;
+  }
+
+  rhs.cells.back().value = -1.0;
+  if (refl::deep_eq(lhs, rhs, policy) or refl::deep_hash(lhs, policy) == refl::deep_hash(rhs)) {
+    return 1;
+  }
+  rhs = lhs;
+  rhs.counters.front() = -1;
+  if (refl::deep_eq(lhs, rhs, policy)) {
+    return 1;
+  }
+  rhs = lhs;
+  rhs.counters.pop_back();
+  return refl::deep_eq(lhs, rhs, policy) ? 1 : 0;
+}
+
+struct server_config {
+  std::string host    = "localhost";
+  int         port    = 80;
+  long        limit   = 0;
+  long        doubled = 0;
+};
+
+TEST("Versioned Snapshots") {
+  refl::versioned<server_config> config{};
+
+  std::atomic<bool>        done{false};
+  std::atomic<int>         torn{0};
+  std::vector<std::thread> readers{};
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&] {
+      while (not done.load()) {
+        const auto snapshot = config.read();
+        if (snapshot->doubled != snapshot->limit * 2) {
+          ++torn;
+        }
+      }
+    });
+  }
+  for (long i = 1; i <= 1000; ++i) {
+    config.update([i](server_config& draft) {
+      draft.limit   = i;
+      draft.doubled = i * 2;
+    });
+  }
+  done = true;
+  for (auto& reader: readers) {
+    reader.join();
+  }
+  if (torn != 0 or config.version() != 1000 or config.get().limit != 1000) {
+    return 1;
+  }
+
+  const auto&            ti = refl::type_info::from<server_config>();
+  const refl::field_path port{ti.field_by_name("port").value()};
+  {
+    // A pinned snapshot keeps its version alive and unchanged
+    const auto old = config.read();
+    config.patch(port, 8080);
+    if (old->port != 80 or config.get().port != 8080 or config.retired() == 0) {
+      return 1;
+    }
+  }
+  config.reclaim();
+  if (config.retired() != 0) {
+    return 1;
+  }
+
+  try {
+    config.patch(port, std::string{"8080"});
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  return 0;
+}
+
+struct clone_node {
+  std::pmr::string            label{};
+  std::shared_ptr<clone_node> next{};
+};
+
+struct clone_graph {
+  std::pmr::vector<std::pmr::string>                     names{};
+  std::pmr::map<std::pmr::string, std::pmr::vector<int>> index{};
+  std::shared_ptr<clone_node>                            first{};
+  std::shared_ptr<clone_node>                            alias{};
+  std::unique_ptr<clone_node>                            owned{};
+  clone_node*                                            deep = nullptr;
+  [[meta(refl::eq_policy::shallow)]]
+  clone_node* shallow = nullptr;
+};
+
+TEST("Deep Clone Into Arena") {
+  // Long enough to not fit in the small string buffer
+  const std::pmr::string long_label(64, 'x');
+
+  clone_node  target{.label = long_label};
+  clone_graph graph{};
+  graph.names       = {long_label, long_label};
+  graph.index       = {{long_label, {1, 2, 3}}};
+  graph.first       = std::make_shared<clone_node>(long_label);
+  graph.first->next = std::make_shared<clone_node>(long_label);
+  graph.alias       = graph.first;
+  graph.owned       = std::make_unique<clone_node>(long_label);
+  graph.deep        = &target;
+  graph.shallow     = &target;
+
+  std::pmr::monotonic_buffer_resource arena{};
+  const auto in_arena = [&](const auto& container) {
+    return container.get_allocator().resource() == &arena;
+  };
+
+  const clone_graph clone = refl::deep_clone(graph, arena);
+  if (clone.names != graph.names or not in_arena(clone.names) or not in_arena(clone.names[1])) {
+    return 1;
+  }
+  if (not in_arena(clone.index) or not in_arena(clone.index.begin()->second) or
+      clone.index.begin()->second != graph.index.begin()->second) {
+    return 1;
+  }
+  // Sharing is preserved, but nothing is shared with the original
+  if (clone.first != clone.alias or clone.first == graph.first or
+      clone.first->next == graph.first->next or not in_arena(clone.first->next->label)) {
+    return 1;
+  }
+  if (clone.owned == nullptr or clone.owned == graph.owned or clone.owned->label != long_label) {
+    return 1;
+  }
+  if (clone.deep == &target or clone.deep->label != long_label or clone.shallow != &target) {
+    return 1;
+  }
+  return 0;
+}
+
+struct clone_cell {
+  int              id = 0;
+  std::pmr::string label{};
+};
+
+struct clone_aliases {
+  // Cloned before `cell`, which starts at the same address
+  int*                        id   = nullptr;
+  clone_cell*                 cell = nullptr;
+  std::shared_ptr<int>        shared_id{};
+  std::shared_ptr<clone_cell> shared_cell{};
+};
+
+TEST("Deep Clone Member Pointers") {
+  const std::pmr::string long_label(64, 'x');
+
+  clone_cell    cell{.id = 7, .label = long_label};
+  const auto    owner = std::make_shared<clone_cell>(cell);
+  clone_aliases aliases{
+    .id          = &cell.id,
+    .cell        = &cell,
+    .shared_id   = {owner, &owner->id},
+    .shared_cell = owner,
+  };
+
+  std::pmr::monotonic_buffer_resource arena{};
+  const clone_aliases                 clone = refl::deep_clone(aliases, arena);
+  if (clone.id == &cell.id or *clone.id != 7 or clone.cell == &cell or clone.cell->id != 7 or
+      clone.cell->label != long_label) {
+    return 1;
+  }
+  return *clone.shared_id == 7 and clone.shared_cell != owner and clone.shared_cell->id == 7 and
+             clone.shared_cell->label == long_label
+           ? 0
+           : 1;
+}
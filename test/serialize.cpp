@@ -5,6 +5,10 @@
 // #include <cassert>
 #include "common.h"
 
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
 import reflect;
 
 import packtl;
@@ -305,3 +309,693 @@ TEST("JSON Change Name") {
   } ts{};
   return check_serializes_to<formats::json_fmt>(ts, "{\"serialized name\":123}");
 }
+
+TEST("JSON Reused Sink") {
+  struct test_struct {
+    int value = 123;
+  } ts{};
+
+  refl::serialization_context context{};
+  auto                        first = context.serialize<formats::json_fmt>(ts);
+  if (first != "{\"value\":123}") {
+    return 1;
+  }
+
+  const auto capacity = context.sink().capacity();
+  ts.value            = 456;
+  auto second         = context.serialize<formats::json_fmt>(ts);
+  if (second != "{\"value\":456}" or context.sink().capacity() != capacity) {
+    return 1;
+  }
+
+  return refl::serializer<formats::json_fmt>::to_string_view(ts) == second ? 0 : 1;
+}
+
+struct nested_value {
+  int value = 123;
+};
+
+enum class nested_tag { inner };
+
+// Serializes on the same thread while the value holding the tag is still being written
+template <>
+struct std::formatter<nested_tag>: std::formatter<std::string_view> {
+  auto format(nested_tag, auto& ctx) const {
+    const std::string json = refl::to_string<formats::json_fmt>(nested_value{});
+    return std::formatter<std::string_view>::format(json, ctx);
+  }
+};
+
+struct nested_outer {
+  std::string before = "before";
+  nested_tag  tag    = nested_tag::inner;
+  int         after  = 7;
+};
+
+TEST("Nested Serialization") {
+  const nested_outer          outer{};
+  refl::serialization_context context{};
+  const std::string           expected{context.serialize<formats::default_fmt>(outer)};
+  return expected.contains("{\"value\":123}") and
+             refl::to_string<formats::default_fmt>(outer) == expected
+           ? 0
+           : 1;
+}
+
+struct chunk_me {
+  std::vector<std::string>   lines{};
+  std::map<std::string, int> counts{};
+};
+
+chunk_me make_chunk_me(int count) {
+  chunk_me obj{};
+  for (int i = 0; i < count; ++i) {
+    obj.lines.push_back(std::format("line number {}", i));
+    obj.counts[std::format("key {}", i)] = i;
+  }
+  return obj;
+}
+
+TEST("Chunked Serialization Backpressure") {
+  const chunk_me    obj      = make_chunk_me(2000);
+  const std::string expected = refl::to_string<formats::json_fmt>(obj);
+
+  int fds[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    return 1;
+  }
+  int send_buffer = 4096;
+  ::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &send_buffer, sizeof(send_buffer));
+
+  // Slow reader, the writer blocks on a full socket and only asks for chunks as it drains
+  std::string received{};
+  std::thread consumer{[&] {
+    std::array<char, 512> buffer{};
+    ssize_t               count;
+    while ((count = ::read(fds[1], buffer.data(), buffer.size())) > 0) {
+      received.append(buffer.data(), static_cast<std::size_t>(count));
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }};
+
+  constexpr std::size_t chunk_size = 256;
+  bool                  bounded    = true;
+  std::size_t           chunks     = 0;
+  for (std::string_view chunk: refl::serialize_chunks<formats::json_fmt>(obj, chunk_size)) {
+    bounded = bounded and chunk.size() <= chunk_size;
+    ++chunks;
+    while (not chunk.empty()) {
+      const ssize_t written = ::write(fds[0], chunk.data(), chunk.size());
+      if (written < 0) {
+        break;
+      }
+      chunk.remove_prefix(static_cast<std::size_t>(written));
+    }
+  }
+  ::close(fds[0]);
+  consumer.join();
+  ::close(fds[1]);
+
+  return bounded and chunks > 1 and received == expected ? 0 : 1;
+}
+
+TEST("Chunked Serialization Cancel") {
+  const chunk_me    obj      = make_chunk_me(500);
+  const std::string expected = refl::to_string<formats::json_fmt>(obj);
+
+  std::string first{};
+  for (std::string_view chunk: refl::serialize_chunks<formats::json_fmt>(obj, 64)) {
+    first = chunk;
+    break;
+  }
+  if (first != expected.substr(0, 64)) {
+    return 1;
+  }
+
+  std::stop_source stop{};
+  std::size_t      chunks = 0;
+  for ([[maybe_unused]] std::string_view chunk:
+       refl::serialize_chunks<formats::json_fmt>(obj, 64, stop.get_token())) {
+    if (++chunks == 3) {
+      stop.request_stop();
+    }
+  }
+  return chunks == 3 ? 0 : 1;
+}
+
+struct dynamic_me {
+  int                        id    = 7;
+  std::string                name  = "sensor \"7\"";
+  double                     value = 0.5;
+  std::vector<int>           tags  = {1, 2, 3};
+  std::map<std::string, int> limits{{"max", 10}, {"min", -10}};
+  serialize_me               nested{};
+  serialize_me*              link = nullptr;
+  [[meta(serialize::name {"renamed"})]]
+  bool flag = true;
+  [[meta(serialize::policy::skip)]]
+  int hidden = 3;
+};
+
+TEST("JSON Dynamic Any") {
+  dynamic_me obj{};
+  obj.link = &obj.nested;
+
+  const std::string expected = refl::to_string<formats::json_fmt>(obj);
+  const refl::any   value    = refl::any::make(obj);
+  if (refl::to_string<formats::json_fmt>(value) != expected) {
+    return 1;
+  }
+
+  const auto pretty = formats::json_fmt_args{.pretty = true};
+  if (refl::to_string<formats::json_fmt>(value, pretty) !=
+      refl::to_string<formats::json_fmt>(obj, pretty)) {
+    return 1;
+  }
+
+  return refl::to_string<formats::json_fmt>(refl::any_ref{obj}) == expected ? 0 : 1;
+}
+
+struct dynamic_numbers {
+  short              small   = -3;
+  unsigned long      large   = 4'000'000'000;
+  long long          wide    = -9'000'000'000'000;
+  unsigned long long wider   = 18'000'000'000'000'000'000ULL;
+  signed char        tiny    = -7;
+  std::uint8_t       byte    = 200;
+  float              ratio   = 0.25F;
+  long double        precise = 1.5L;
+};
+
+TEST("JSON Dynamic Number Parity") {
+  const dynamic_numbers obj{};
+  const refl::any       value = refl::any::make(obj);
+  return refl::to_string<formats::json_fmt>(value) == refl::to_string<formats::json_fmt>(obj) ? 0
+                                                                                              : 1;
+}
+
+TEST("JSON Dynamic Archive") {
+  refl::archive archive{};
+  archive["b/count"] = 2;
+  archive["a/name"]  = std::string{"config"};
+  archive["c/tags"]  = std::vector<std::string>{"x", "y"};
+  archive["d/empty"];
+
+  const std::string str = refl::to_string<formats::json_fmt>(archive);
+  return str == "{\"a/name\":\"config\",\"b/count\":2,\"c/tags\":[\"x\",\"y\"],\"d/empty\":null}"
+           ? 0
+           : 1;
+}
+
+struct tick_state {
+  int                        frame = 0;
+  std::string                phase = "idle";
+  std::vector<int>           samples{1, 2, 3};
+  std::map<std::string, int> counters{{"hits", 0}};
+};
+
+TEST("JSON Incremental") {
+  refl::tracked<tick_state>                                   state{};
+  refl::incremental_serializer<formats::json_fmt, tick_state> inc{};
+
+  if (inc.serialize(state) != refl::to_string<formats::json_fmt>(state.value())) {
+    return 1;
+  }
+
+  state.at<0>() = 1;
+  state.edit<3>()["hits"] += 1;
+  const std::string patch{inc.serialize_dirty(state)};
+  if (patch != "{\"counters\":{\"hits\":1},\"frame\":1}") {
+    return 1;
+  }
+
+  state.at<1>() = std::string{"running"};
+  if (inc.serialize(state) != refl::to_string<formats::json_fmt>(state.value())) {
+    return 1;
+  }
+
+  // Another instance has none of the cached fields, switching back has to rewrite them again
+  refl::tracked<tick_state> other{};
+  other.at<1>() = std::string{"paused"};
+  if (inc.serialize(other) != refl::to_string<formats::json_fmt>(other.value()) or
+      inc.serialize(state) != refl::to_string<formats::json_fmt>(state.value())) {
+    return 1;
+  }
+
+  // Cached fragments have to follow pretty printing too
+  refl::incremental_serializer<formats::json_fmt, tick_state> pretty{{.pretty = true}};
+  pretty.serialize(state);
+  state.edit<2>().push_back(4);
+  return pretty.serialize(state) ==
+             refl::to_string<formats::json_fmt>(state.value(), {.pretty = true})
+           ? 0
+           : 1;
+}
+
+struct soa_entry {
+  int         id   = 0;
+  std::string name = {};
+};
+struct soa_table {
+  refl::soa_vector<soa_entry> rows{};
+};
+struct aos_table {
+  std::vector<soa_entry> rows{};
+};
+TEST("JSON SoA Vector") {
+  aos_table aos{{{1, "one"}, {2, "two"}, {3, "three"}}};
+  soa_table soa{refl::soa_vector<soa_entry>(aos.rows)};
+  return refl::to_string<formats::json_fmt>(soa) == refl::to_string<formats::json_fmt>(aos) ? 0 : 1;
+}
+
+struct probe_leaf {
+  int         value = 7;
+  std::string label = "leaf";
+};
+struct probe_root {
+  probe_leaf       leaf{};
+  std::vector<int> values{1, 2, 3};
+};
+TEST("Instrumentation Profile") {
+  namespace instrumentation = refl::instrumentation;
+  instrumentation::reset();
+
+  probe_root root{};
+  const auto json    = refl::to_string<formats::json_fmt>(root);
+  const bool equal   = refl::deep_eq(root, root);
+  const auto profile = instrumentation::snapshot();
+
+  if constexpr (not instrumentation::enabled) {
+    // Compiled out, nothing is ever recorded
+    return equal and profile.entries.empty() ? 0 : 1;
+  } else {
+    using instrumentation::operation;
+    const auto* obj   = profile.find(operation::visit, "probe_root");
+    const auto* leaf  = profile.find(operation::visit, "probe_root", "leaf");
+    const auto* label = profile.find(operation::compare, "probe_leaf", "label");
+    if (obj == nullptr or leaf == nullptr or label == nullptr or obj->totals.visits != 1) {
+      return 1;
+    }
+    // The root object spans the whole output, its fields only part of it
+    if (obj->totals.bytes != json.size() or leaf->totals.bytes >= obj->totals.bytes) {
+      return 1;
+    }
+    return profile.to_json().contains(R"("type":"probe_leaf","field":"label")") ? 0 : 1;
+  }
+}
+
+struct projection_inner {
+  int         id = 0;
+  std::string tag{};
+};
+
+struct projection_record {
+  int                        id = 0;
+  [[meta(serialize::name {"label"})]]
+  std::string                name{};
+  std::vector<int>           values{};
+  projection_inner           inner{};
+  std::map<std::string, int> counts{};
+  bool                       flag = false;
+};
+
+TEST("JSON Projection") {
+  const projection_record record{
+    .id     = 7,
+    .name   = "with \"quotes\" and } braces",
+    .values = {1, 2, 3},
+    .inner  = {.id = 42, .tag = "tag"},
+    .counts = {{"a", 1}, {"b", 2}},
+    .flag   = true,
+  };
+  const std::string json = refl::to_string<formats::json_fmt>(record);
+
+  // Selected members only, the rest keeps its previous value
+  projection_record partial{.id = -1};
+  const refl::projection<projection_record> selected{"name", "inner.id"};
+  selected.read_json(json, partial);
+  if (partial.id != -1 or partial.name != record.name or partial.inner.id != 42 or
+      not partial.inner.tag.empty() or not partial.values.empty()) {
+    return 1;
+  }
+
+  const auto [inner_id, flag] = refl::project_json<projection_record, "inner.id", "flag">(json);
+  if (inner_id != 42 or not flag) {
+    return 1;
+  }
+
+  projection_record full{};
+  refl::read_json(json, full);
+  if (not refl::deep_eq(full, record)) {
+    return 1;
+  }
+
+  try {
+    refl::projection<projection_record>{"inner.missing"};
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  try {
+    refl::read_json("{\"id\":}", full);
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  return 0;
+}
+
+TEST("NDJSON Round Trip") {
+  std::vector<projection_record> records(1000);
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    records[i].id       = static_cast<int>(i);
+    records[i].name     = std::format("record\n{}", i);
+    records[i].inner.id = static_cast<int>(2 * i);
+  }
+
+  // Small chunks so every thread gets several of them
+  const refl::ndjson::options options{.threads = 4, .chunk_bytes = 256, .chunk_records = 16};
+  const std::string           text = refl::ndjson::write(records, options);
+  if (std::ranges::count(text, '\n') != static_cast<std::ptrdiff_t>(records.size())) {
+    return 1;
+  }
+
+  const auto decoded = refl::ndjson::read<projection_record>(text, options);
+  if (decoded.size() != records.size()) {
+    return 1;
+  }
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    if (not refl::deep_eq(decoded[i], records[i])) {
+      return 1;
+    }
+  }
+
+  try {
+    refl::ndjson::read<projection_record>("{\"id\":1}\n{\"id\":}\n", options);
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  return 0;
+}
+
+struct interned_event {
+  std::string      host{};
+  std::string_view zone{};
+  projection_inner inner{};
+};
+
+TEST("JSON String Interning") {
+  std::vector<interned_event> events(3);
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    events[i].host  = "host-01.example.net";
+    events[i].zone  = i == 2 ? "^caret-zone" : "eu-west";
+    events[i].inner = {.id = static_cast<int>(i), .tag = std::format("unique-{}", i)};
+  }
+
+  refl::string_dictionary  writer_dictionary{};
+  std::vector<std::string> lines{};
+  for (const auto& event: events) {
+    refl::string_sink                    sink{};
+    formats::json_fmt<refl::string_sink> format{sink, {.dictionary = &writer_dictionary}};
+    format.serialize(event);
+    lines.emplace_back(sink.view());
+  }
+  // Keys and repeated values become back-references after the first record
+  if (lines[1].contains("host-01") or lines[1].contains("inner") or
+      lines[1].size() >= lines[0].size()) {
+    return 1;
+  }
+
+  refl::string_dictionary reader_dictionary{};
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    interned_event decoded{};
+    refl::read_json(lines[i], decoded, reader_dictionary);
+    if (decoded.host != events[i].host or decoded.zone != events[i].zone or
+        decoded.inner.tag != events[i].inner.tag or decoded.inner.id != events[i].inner.id) {
+      return 1;
+    }
+  }
+  if (reader_dictionary.size() != writer_dictionary.size()) {
+    return 1;
+  }
+
+  // Without the earlier records the ids mean nothing
+  try {
+    refl::string_dictionary fresh{};
+    interned_event          decoded{};
+    refl::read_json(lines[1], decoded, fresh);
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  return 0;
+}
+
+struct sized_reading {
+  int                  sensor    = 0;
+  unsigned long        timestamp = 0;
+  double               value     = 0.0;
+  bool                 valid     = false;
+  char                 unit      = 'C';
+  std::array<short, 3> axes{};
+};
+
+struct sized_message {
+  sized_reading reading{};
+  std::string   note{};
+};
+
+TEST("Serialized Size") {
+  constexpr auto bound = refl::serialized_size_bound<formats::json_fmt, sized_reading>;
+  static_assert(bound.has_value());
+  static_assert(not refl::serialized_size_bound<formats::json_fmt, sized_message>.has_value());
+  static_assert(not refl::serialized_size_bound<formats::default_fmt, sized_reading>.has_value());
+
+  // The widest value of every member
+  const sized_reading widest{
+    .sensor    = std::numeric_limits<int>::min(),
+    .timestamp = std::numeric_limits<unsigned long>::max(),
+    .value     = -2.2250738585072014e-308,
+    .valid     = false,
+    .unit      = '\x01',
+    .axes      = {-32768, -32768, -32768},
+  };
+  const std::string json = refl::to_string<formats::json_fmt>(widest);
+  if (json.size() > *bound or refl::serialized_size<formats::json_fmt>(widest) != json.size()) {
+    return 1;
+  }
+  if (refl::to_string_exact<formats::json_fmt>(widest) != json) {
+    return 1;
+  }
+  // Pretty output is not covered by the bound and gets measured instead
+  if (refl::to_string_exact<formats::json_fmt>(widest, {.pretty = true}) !=
+      refl::to_string<formats::json_fmt>(widest, {.pretty = true})) {
+    return 1;
+  }
+
+  const sized_message message{.reading = widest, .note = "not \"fixed\" in size"};
+  if (refl::to_string_exact<formats::json_fmt>(message) !=
+      refl::to_string<formats::json_fmt>(message)) {
+    return 1;
+  }
+  const std::string text = refl::to_string<formats::default_fmt>(message);
+  if (refl::serialized_size<formats::default_fmt>(message) != text.size() or
+      refl::to_string_exact<formats::default_fmt>(message) != text) {
+    return 1;
+  }
+  return 0;
+}
+
+struct memo_product {
+  std::string name{};
+  double      price = 0.0;
+};
+
+struct memo_document {
+  int id = 0;
+  [[meta(serialize::immutable{})]]
+  std::vector<memo_product> catalog{};
+  [[meta(serialize::immutable{})]]
+  std::map<std::string, int> rates{};
+};
+
+struct memo_ledger {
+  [[meta(serialize::immutable{})]]
+  std::multimap<std::string, int> entries{};
+  [[meta(serialize::immutable{})]]
+  double balance = 0.0;
+};
+
+TEST("JSON Memoized Subtrees") {
+  const std::vector<memo_product>  catalog{{"apple", 0.5}, {"pear", 0.75}};
+  const std::map<std::string, int> rates{{"eur", 1}, {"usd", 2}};
+
+  refl::serialization_cache cache{{.max_entries = 2}};
+  for (const bool pretty: {false, true}) {
+    cache.clear();
+    cache.reset_counters();
+    const formats::json_fmt_args plain{.pretty = pretty};
+    const formats::json_fmt_args cached{.pretty = pretty, .cache = &cache};
+    for (int id = 0; id < 3; ++id) {
+      const memo_document document{.id = id, .catalog = catalog, .rates = rates};
+      if (refl::to_string<formats::json_fmt>(document, cached) !=
+          refl::to_string<formats::json_fmt>(document, plain)) {
+        return 1;
+      }
+    }
+    if (cache.misses() != 2 or cache.hits() != 4) {
+      return 1;
+    }
+  }
+
+  // Different content is a different entry, the least recently used one is evicted
+  memo_document changed{.catalog = catalog, .rates = rates};
+  changed.catalog.back().price = 1.0;
+  const formats::json_fmt_args cached{.cache = &cache};
+  if (refl::to_string<formats::json_fmt>(changed, cached) !=
+      refl::to_string<formats::json_fmt>(changed)) {
+    return 1;
+  }
+  if (cache.evictions() == 0 or cache.size() != 2) {
+    return 1;
+  }
+
+  // Values that only differ inside a multimap, or by the sign of a zero, are different entries
+  const std::vector<memo_ledger> ledgers{
+    {.entries = {{"fee", 1}, {"fee", 2}}, .balance = 0.0},
+    {.entries = {{"fee", 1}, {"fee", 3}}, .balance = -0.0},
+  };
+  for (const memo_ledger& ledger: ledgers) {
+    if (refl::to_string<formats::json_fmt>(ledger, cached) !=
+        refl::to_string<formats::json_fmt>(ledger)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+struct static_endpoint {
+  char           host[16] = "localhost";
+  unsigned short port     = 8080;
+  bool           tls      = false;
+};
+
+struct static_service {
+  const char*                    name     = "catalog";
+  int                            replicas = 3;
+  long long                      quota    = 1LL << 40;
+  char                           tier     = 'B';
+  std::array<static_endpoint, 2> endpoints{};
+  std::array<int, 3>             weights{5, 3, 1};
+  [[meta(serialize::name {"display_name"})]]
+  std::string_view label = "Catalog \"v2\"\n";
+  [[meta(serialize::policy::deep)]]
+  const static_endpoint* primary = nullptr;
+  const static_service*  fallback = nullptr;
+  [[meta(serialize::policy::skip)]]
+  int secret = 42;
+};
+
+static constexpr static_endpoint static_primary{.host = "db.internal", .port = 5432, .tls = true};
+
+static constexpr static_service static_catalog{
+  .endpoints = {{{}, {.host = "cache", .port = 6379}}},
+  .primary   = &static_primary,
+  .fallback  = &static_catalog,
+};
+
+TEST("JSON Static Serialization") {
+  constexpr std::string_view compact = refl::static_json<static_catalog>;
+  static_assert(compact.starts_with("{\"display_name\":"));
+  if (compact != refl::to_string<formats::json_fmt>(static_catalog)) {
+    return 1;
+  }
+
+  static constexpr formats::json_fmt_args pretty{.pretty = true, .indent = 3};
+  return refl::static_json<static_catalog, pretty> !=
+             refl::to_string<formats::json_fmt>(static_catalog, pretty)
+           ? 1
+           : 0;
+}
+
+struct binary_point {
+  int  x     = 0;
+  bool valid = false;
+};
+
+struct binary_record {
+  int                         id = 0;
+  std::string                 name{};
+  std::vector<double>         samples{};
+  std::map<std::string, int>  counts{};
+  std::optional<binary_point> origin{};
+  [[meta(serialize::name {"label"})]]
+  std::string_view tag{};
+};
+
+struct binary_record_subset {
+  std::string_view label{};
+  int              id = 0;
+};
+
+TEST("MessagePack and CBOR Round Trip") {
+  const binary_point point{.x = 1, .valid = true};
+  if (refl::to_string<formats::msgpack_fmt>(point) != "\x82\xA1x\x01\xA5valid\xC3" or
+      refl::to_string<formats::cbor_fmt>(point) != "\xA2\x61x\x01\x65valid\xF5") {
+    return 1;
+  }
+
+  const binary_record record{
+    .id      = -70000,
+    .name    = "sensor",
+    .samples = {0.5, -2.0, 1e300},
+    .counts  = {{"low", 3}, {"high", 300}},
+    .origin  = point,
+    .tag     = "north",
+  };
+  const auto matches = [&](const binary_record& read, const std::string& bytes) {
+    return read.id == record.id and read.name == record.name and
+           read.samples == record.samples and read.counts == record.counts and
+           read.origin.has_value() and read.origin->x == 1 and read.origin->valid and
+           read.tag == record.tag and read.tag.data() >= bytes.data() and
+           read.tag.data() < bytes.data() + bytes.size();
+  };
+
+  const std::string msgpack = refl::to_string<formats::msgpack_fmt>(record);
+  const std::string cbor    = refl::to_string<formats::cbor_fmt>(record);
+  binary_record     from_msgpack{};
+  binary_record     from_cbor{};
+  refl::read_msgpack(msgpack, from_msgpack);
+  refl::read_cbor(cbor, from_cbor);
+  if (not matches(from_msgpack, msgpack) or not matches(from_cbor, cbor)) {
+    return 1;
+  }
+
+  // Keys the target doesn't have are skipped, in any order
+  binary_record_subset subset{};
+  refl::read_msgpack(msgpack, subset);
+  if (subset.id != record.id or subset.label != "north") {
+    return 1;
+  }
+
+  // Indefinite lengths and tags from other CBOR writers
+  binary_record from_indefinite{};
+  refl::read_cbor("\xBF\x62id\xC1\x18\x2A\x64name\x7F\x62no\x61x\xFF\xFF", from_indefinite);
+  if (from_indefinite.id != 42 or from_indefinite.name != "nox") {
+    return 1;
+  }
+
+  try {
+    refl::read_msgpack(std::string_view{msgpack}.substr(0, msgpack.size() - 1), from_msgpack);
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+
+  // An unknown key nesting arrays far deeper than any reader would follow
+  std::string nested{"\x81\xA7unknown"};
+  nested.append(100'000, '\x91');
+  nested.push_back('\x01');
+  try {
+    refl::read_msgpack(nested, from_msgpack);
+    return 1;
+  } catch (const std::invalid_argument&) {
+  }
+  return 0;
+}